@@ -73,6 +73,25 @@ func (e *G1) ScalarMult(a *G1, k *big.Int) *G1 {
 	return e
 }
 
+// MultiScalarMult sets e to the sum of points[i]*scalars[i] and then returns
+// e. It is much faster than the equivalent ScalarMult and Add calls when there
+// are more than a few points. It panics if points and scalars differ in
+// length.
+func (e *G1) MultiScalarMult(points []*G1, scalars []*big.Int) *G1 {
+	if len(points) != len(scalars) {
+		panic("bn256: mismatched number of points and scalars")
+	}
+	ps := make([]*curvePoint, len(points))
+	for i, a := range points {
+		ps[i] = a.p
+	}
+	if e.p == nil {
+		e.p = &curvePoint{}
+	}
+	e.p.MultiMul(ps, scalars)
+	return e
+}
+
 // Add sets e to a+b and then returns e.
 func (e *G1) Add(a, b *G1) *G1 {
 	if e.p == nil {
@@ -205,6 +224,25 @@ func (e *G2) ScalarMult(a *G2, k *big.Int) *G2 {
 	return e
 }
 
+// MultiScalarMult sets e to the sum of points[i]*scalars[i] and then returns
+// e. It is much faster than the equivalent ScalarMult and Add calls when there
+// are more than a few points. It panics if points and scalars differ in
+// length.
+func (e *G2) MultiScalarMult(points []*G2, scalars []*big.Int) *G2 {
+	if len(points) != len(scalars) {
+		panic("bn256: mismatched number of points and scalars")
+	}
+	ps := make([]*twistPoint, len(points))
+	for i, a := range points {
+		ps[i] = a.p
+	}
+	if e.p == nil {
+		e.p = &twistPoint{}
+	}
+	e.p.MultiMul(ps, scalars)
+	return e
+}
+
 // Add sets e to a+b and then returns e.
 func (e *G2) Add(a, b *G2) *G2 {
 	if e.p == nil {
@@ -320,16 +358,17 @@ func Pair(g1 *G1, g2 *G2) *GT {
 
 // PairingCheck calculates the Optimal Ate pairing for a set of points.
 func PairingCheck(a []*G1, b []*G2) bool {
-	acc := new(gfP12)
-	acc.SetOne()
+	lines := make([][]lineCoeffs, 0, len(a))
+	ps := make([]*curvePoint, 0, len(a))
 
 	for i := 0; i < len(a); i++ {
 		if a[i].p.IsInfinity() || b[i].p.IsInfinity() {
 			continue
 		}
-		acc.Mul(acc, miller(b[i].p, a[i].p))
+		lines = append(lines, g2LineCache.lines(b[i].p))
+		ps = append(ps, a[i].p)
 	}
-	return finalExponentiation(acc).IsOne()
+	return finalExponentiation(multiMiller(lines, ps)).IsOne()
 }
 
 // Miller applies Miller's algorithm, which is a bilinear function from the
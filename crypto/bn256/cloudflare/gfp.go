@@ -30,24 +30,11 @@ func (e *gfP) Set(f *gfP) {
 	e[3] = f[3]
 }
 
+// Invert sets e to f^-1. f is in Montgomery form, f = aR, so the plain inverse
+// a^-1 R^-1 is multiplied by R^3 in Montgomery form to give a^-1 R.
 func (e *gfP) Invert(f *gfP) {
-	bits := [4]uint64{0x3c208c16d87cfd45, 0x97816a916871ca8d, 0xb85045b68181585d, 0x30644e72e131a029}
-
-	sum, power := &gfP{}, &gfP{}
-	sum.Set(rN1)
-	power.Set(f)
-
-	for word := 0; word < 4; word++ {
-		for bit := uint(0); bit < 64; bit++ {
-			if (bits[word]>>bit)&1 == 1 {
-				gfpMul(sum, sum, power)
-			}
-			gfpMul(power, power, power)
-		}
-	}
-
-	gfpMul(sum, sum, r3)
-	e.Set(sum)
+	gfpInvert(e, f)
+	gfpMul(e, e, r3)
 }
 
 func (e *gfP) Marshal(out []byte) {
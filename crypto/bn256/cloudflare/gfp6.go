@@ -121,6 +121,29 @@ func (e *gfP6) Mul(a, b *gfP6) *gfP6 {
 	return e
 }
 
+// MulSparse computes a·(yτ+z). It is Mul with the products of the zero τ²
+// coefficient left out, which saves one of the six gfP2 multiplications.
+func (e *gfP6) MulSparse(a *gfP6, y, z *gfP2) *gfP6 {
+	v0 := (&gfP2{}).Mul(&a.z, z)
+	v1 := (&gfP2{}).Mul(&a.y, y)
+
+	tz := (&gfP2{}).Mul(&a.x, y)
+	tz.MulXi(tz).Add(tz, v0)
+
+	t0 := (&gfP2{}).Add(&a.y, &a.z)
+	t1 := (&gfP2{}).Add(y, z)
+	ty := (&gfP2{}).Mul(t0, t1)
+	ty.Sub(ty, v0).Sub(ty, v1)
+
+	tx := (&gfP2{}).Mul(&a.x, z)
+	tx.Add(tx, v1)
+
+	e.x.Set(tx)
+	e.y.Set(ty)
+	e.z.Set(tz)
+	return e
+}
+
 func (e *gfP6) MulScalar(a *gfP6, b *gfP2) *gfP6 {
 	e.x.Mul(&a.x, b)
 	e.y.Mul(&a.y, b)
@@ -35,6 +35,7 @@
 
 #include "mul_amd64.h"
 #include "mul_bmi2_amd64.h"
+#include "mul_adx_amd64.h"
 
 TEXT ·gfpNeg(SB),0,$0-16
 	MOVQ ·p2+0(SB), R8
@@ -109,6 +110,16 @@ TEXT ·gfpMul(SB),0,$160-24
 	MOVQ a+8(FP), DI
 	MOVQ b+16(FP), SI
 
+	// With ADX, reduce while multiplying and stay in registers.
+	CMPB ·hasADX(SB), $0
+	JE   noadxMul
+
+	mulADX(0(DI),8(DI),16(DI),24(DI), 0(SI))
+	MOVQ c+0(FP), DI
+	storeBlock(R12,R13,R8,R9, 0(DI))
+	RET
+
+noadxMul:
 	// Jump to a slightly different implementation if MULX isn't supported.
 	CMPB ·hasBMI2(SB), $0
 	JE   nobmi2Mul
@@ -0,0 +1,51 @@
+//go:build amd64 && !generic
+// +build amd64,!generic
+
+package bn256
+
+import (
+	"math/big"
+	"testing"
+)
+
+// Tests that the ADX, BMI2 and plain multiplication paths of gfpMul agree with
+// each other and with a*b/2^256 mod p.
+func TestGFpMulPaths(t *testing.T) {
+	defer func(adx, bmi2 bool) { hasADX, hasBMI2 = adx, bmi2 }(hasADX, hasBMI2)
+
+	type path struct {
+		name      string
+		adx, bmi2 bool
+	}
+	var paths []path
+	if hasADX {
+		paths = append(paths, path{"adx", true, true})
+	}
+	if hasBMI2 {
+		paths = append(paths, path{"bmi2", false, true})
+	}
+	paths = append(paths, path{"plain", false, false})
+
+	rInv := new(big.Int).ModInverse(new(big.Int).Lsh(big.NewInt(1), 256), P)
+	for i := 0; i < 1000; i++ {
+		a, b := randomGFp(t), randomGFp(t)
+		want := gfpToBig(a)
+		want.Mul(want, gfpToBig(b)).Mul(want, rInv).Mod(want, P)
+
+		var first gfP
+		for j, p := range paths {
+			hasADX, hasBMI2 = p.adx, p.bmi2
+
+			c := &gfP{}
+			gfpMul(c, a, b)
+			if j == 0 {
+				first = *c
+			} else if *c != first {
+				t.Fatalf("%s: mismatch for %#x * %#x: have %#x, want %#x", p.name, *a, *b, *c, first)
+			}
+			if have := gfpToBig(c); have.Mod(have, P).Cmp(want) != 0 {
+				t.Fatalf("%s: %#x * %#x is not a*b/2^256 mod p: have %#x", p.name, *a, *b, *c)
+			}
+		}
+	}
+}
@@ -12,6 +12,9 @@ import (
 //nolint:varcheck,unused,deadcode
 var hasBMI2 = cpu.X86.HasBMI2
 
+//nolint:varcheck,unused,deadcode
+var hasADX = cpu.X86.HasADX && cpu.X86.HasBMI2
+
 // go:noescape
 func gfpNeg(c, a *gfP)
 
@@ -0,0 +1,191 @@
+package bn256
+
+import "math/bits"
+
+// This file implements constant-time inversion modulo p with the safegcd
+// algorithm of Bernstein and Yang, "Fast constant-time gcd computation and
+// modular inversion" (https://gcd.cr.yp.to/safegcd-20190413.pdf). It follows
+// the 64-bit variant in libsecp256k1's modinv64_impl.h: numbers are kept in
+// five signed 62-bit limbs, and ten batches of 59 divsteps are applied, which
+// suffices for all 256-bit inputs.
+
+const m62 = 1<<62 - 1
+
+// signed62 is a signed integer in base 2^62, sum(v[i] * 2^(62*i)). Limbs 0-3
+// are normally in [0,2^62), and limb 4 carries the sign.
+type signed62 [5]int64
+
+// pSigned62 is p in signed62 form.
+var pSigned62 = signed62{0x3c208c16d87cfd47, 0x1e05aa45a1c72a34, 0x05045b68181585d9, 0x19139cb84c680a6e, 0x30}
+
+// pInv62 is p^-1 mod 2^62.
+const pInv62 = 0x382df87d1b799c77
+
+// divstepMatrix is the 2x2 transition matrix of a batch of divsteps,
+// scaled by 2^62.
+type divstepMatrix struct{ u, v, q, r int64 }
+
+// int128 is a signed 128-bit accumulator in two's complement.
+type int128 struct{ hi, lo uint64 }
+
+func mul128(a, b int64) int128 {
+	hi, lo := bits.Mul64(uint64(a), uint64(b))
+	hi -= uint64(a>>63) & uint64(b)
+	hi -= uint64(b>>63) & uint64(a)
+	return int128{hi, lo}
+}
+
+func (x int128) add(y int128) int128 {
+	lo, carry := bits.Add64(x.lo, y.lo, 0)
+	return int128{x.hi + y.hi + carry, lo}
+}
+
+// shr62 is an arithmetic right shift by 62.
+func (x int128) shr62() int128 {
+	return int128{uint64(int64(x.hi) >> 62), x.lo>>62 | x.hi<<2}
+}
+
+// divsteps59 applies 59 divsteps to the low 64 bits of f and g, starting from
+// zeta = -(delta+1/2), and returns the new zeta along with the transition
+// matrix. It uses masks instead of branches so that it runs in constant time.
+func divsteps59(zeta int64, f0, g0 uint64) (int64, divstepMatrix) {
+	u, v, q, r := uint64(8), uint64(0), uint64(0), uint64(8)
+	f, g := f0, g0
+
+	for i := 3; i < 62; i++ {
+		// mask1 is set if zeta < 0, mask2 if g is odd.
+		mask1 := uint64(zeta >> 63)
+		mask2 := -(g & 1)
+
+		// Conditionally add -f,-u,-v (zeta < 0) or f,u,v to g,q,r.
+		x := (f ^ mask1) - mask1
+		y := (u ^ mask1) - mask1
+		z := (v ^ mask1) - mask1
+		g += x & mask2
+		q += y & mask2
+		r += z & mask2
+
+		// If both hold, swap: zeta becomes -zeta-2 and g,q,r are added
+		// to f,u,v. Otherwise zeta becomes zeta-1.
+		mask1 &= mask2
+		zeta = (zeta ^ int64(mask1)) - 1
+		f += g & mask1
+		u += q & mask1
+		v += r & mask1
+
+		g >>= 1
+		u <<= 1
+		v <<= 1
+	}
+	return zeta, divstepMatrix{int64(u), int64(v), int64(q), int64(r)}
+}
+
+// updateDE computes (t*[d,e] + p*[md,me]) / 2^62, where md and me are chosen
+// so that the division is exact and d and e stay in (-2p,p).
+func updateDE(d, e *signed62, t divstepMatrix) {
+	u, v, q, r := t.u, t.v, t.q, t.r
+
+	// md and me start as u,q if d is negative plus v,r if e is negative.
+	sd, se := d[4]>>63, e[4]>>63
+	md := (u & sd) + (v & se)
+	me := (q & sd) + (r & se)
+
+	cd := mul128(u, d[0]).add(mul128(v, e[0]))
+	ce := mul128(q, d[0]).add(mul128(r, e[0]))
+
+	// Correct md and me so that the low 62 bits of the sums become zero.
+	md -= int64((pInv62*cd.lo + uint64(md)) & m62)
+	me -= int64((pInv62*ce.lo + uint64(me)) & m62)
+
+	cd = cd.add(mul128(pSigned62[0], md)).shr62()
+	ce = ce.add(mul128(pSigned62[0], me)).shr62()
+
+	for i := 1; i < 5; i++ {
+		cd = cd.add(mul128(u, d[i])).add(mul128(v, e[i])).add(mul128(pSigned62[i], md))
+		ce = ce.add(mul128(q, d[i])).add(mul128(r, e[i])).add(mul128(pSigned62[i], me))
+		d[i-1] = int64(cd.lo & m62)
+		e[i-1] = int64(ce.lo & m62)
+		cd, ce = cd.shr62(), ce.shr62()
+	}
+	d[4], e[4] = int64(cd.lo), int64(ce.lo)
+}
+
+// updateFG computes t*[f,g] / 2^62, which divsteps59 guarantees is exact.
+func updateFG(f, g *signed62, t divstepMatrix) {
+	u, v, q, r := t.u, t.v, t.q, t.r
+
+	cf := mul128(u, f[0]).add(mul128(v, g[0])).shr62()
+	cg := mul128(q, f[0]).add(mul128(r, g[0])).shr62()
+
+	for i := 1; i < 5; i++ {
+		cf = cf.add(mul128(u, f[i])).add(mul128(v, g[i]))
+		cg = cg.add(mul128(q, f[i])).add(mul128(r, g[i]))
+		f[i-1] = int64(cf.lo & m62)
+		g[i-1] = int64(cg.lo & m62)
+		cf, cg = cf.shr62(), cg.shr62()
+	}
+	f[4], g[4] = int64(cf.lo), int64(cg.lo)
+}
+
+// normalize brings d from (-2p,p) to [0,p), negating it first if sign is
+// negative.
+func (d *signed62) normalize(sign int64) {
+	add := d[4] >> 63
+	for i := range d {
+		d[i] += pSigned62[i] & add
+	}
+	neg := sign >> 63
+	for i := range d {
+		d[i] = (d[i] ^ neg) - neg
+	}
+	d.propagate()
+
+	add = d[4] >> 63
+	for i := range d {
+		d[i] += pSigned62[i] & add
+	}
+	d.propagate()
+}
+
+// propagate carries the top bits of limbs 0-3 into the next limb.
+func (d *signed62) propagate() {
+	for i := 0; i < 4; i++ {
+		d[i+1] += d[i] >> 62
+		d[i] &= m62
+	}
+}
+
+func (d *signed62) fromGFp(a *gfP) {
+	d[0] = int64(a[0] & m62)
+	d[1] = int64((a[0]>>62 | a[1]<<2) & m62)
+	d[2] = int64((a[1]>>60 | a[2]<<4) & m62)
+	d[3] = int64((a[2]>>58 | a[3]<<6) & m62)
+	d[4] = int64(a[3] >> 56)
+}
+
+// toGFp expects d to be normalized.
+func (d *signed62) toGFp(a *gfP) {
+	a[0] = uint64(d[0]) | uint64(d[1])<<62
+	a[1] = uint64(d[1])>>2 | uint64(d[2])<<60
+	a[2] = uint64(d[2])>>4 | uint64(d[3])<<58
+	a[3] = uint64(d[3])>>6 | uint64(d[4])<<56
+}
+
+// gfpInvert sets c to a^-1 mod p, or to zero if a is zero. Unlike
+// gfP.Invert it works on plain integers, not on Montgomery form.
+func gfpInvert(c, a *gfP) {
+	d, e, f, g := signed62{}, signed62{1}, pSigned62, signed62{}
+	g.fromGFp(a)
+
+	zeta := int64(-1)
+	for i := 0; i < 10; i++ {
+		var t divstepMatrix
+		zeta, t = divsteps59(zeta, uint64(f[0]), uint64(g[0]))
+		updateDE(&d, &e, t)
+		updateFG(&f, &g, t)
+	}
+
+	// Now g is zero and f is ±gcd(p, a) = ±1, so d is ±a^-1.
+	d.normalize(f[4])
+	d.toGFp(c)
+}
@@ -1,6 +1,8 @@
 package bn256
 
 import (
+	"crypto/rand"
+	"math/big"
 	"testing"
 )
 
@@ -58,3 +60,79 @@ func TestGFpMul(t *testing.T) {
 		t.Errorf("multiplication mismatch: have %#x, want %#x", *h, *w)
 	}
 }
+
+// Tests that inversion agrees with math/big, including at the edges of the
+// field.
+func TestGFpInvert(t *testing.T) {
+	pMinus1 := new(big.Int).Sub(P, big.NewInt(1))
+	for i := 0; i < 1000; i++ {
+		n, _ := rand.Int(rand.Reader, P)
+		switch i {
+		case 0:
+			n.SetInt64(0)
+		case 1:
+			n.SetInt64(1)
+		case 2:
+			n.Set(pMinus1)
+		}
+		a := bigToGFp(n)
+
+		h := &gfP{}
+		gfpInvert(h, a)
+		want := new(big.Int).ModInverse(n, P)
+		if want == nil {
+			want = new(big.Int)
+		}
+		if have := gfpToBig(h); have.Cmp(want) != 0 {
+			t.Fatalf("inversion mismatch for %#x: have %#x, want %#x", n, have, want)
+		}
+
+		// The same through Montgomery form.
+		montEncode(a, a)
+		h.Invert(a)
+		montDecode(h, h)
+		if have := gfpToBig(h); have.Cmp(want) != 0 {
+			t.Fatalf("montgomery inversion mismatch for %#x: have %#x, want %#x", n, have, want)
+		}
+	}
+}
+
+func BenchmarkGFpMul(b *testing.B) {
+	x := &gfP{0x0123456789abcdef, 0xfedcba9876543210, 0xdeadbeefdeadbeef, 0x0eebdaedfeebdaed}
+	y := &gfP{0xfedcba9876543210, 0x0123456789abcdef, 0xfeebdaedfeebdaed, 0x0eadbeefdeadbeef}
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		gfpMul(x, x, y)
+	}
+}
+
+func BenchmarkGFpInvert(b *testing.B) {
+	x := &gfP{0x0123456789abcdef, 0xfedcba9876543210, 0xdeadbeefdeadbeef, 0x0eebdaedfeebdaed}
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		x.Invert(x)
+	}
+}
+
+func randomGFp(t *testing.T) *gfP {
+	n, err := rand.Int(rand.Reader, P)
+	if err != nil {
+		t.Fatal(err)
+	}
+	return bigToGFp(n)
+}
+
+func bigToGFp(n *big.Int) *gfP {
+	var buf [32]byte
+	e := &gfP{}
+	e.Unmarshal(n.FillBytes(buf[:]))
+	return e
+}
+
+func gfpToBig(e *gfP) *big.Int {
+	var buf [32]byte
+	e.Marshal(buf[:])
+	return new(big.Int).SetBytes(buf[:])
+}
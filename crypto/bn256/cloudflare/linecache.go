@@ -0,0 +1,67 @@
+package bn256
+
+import (
+	"container/list"
+	"sync"
+)
+
+// lineCacheSize bounds the number of twist points whose Miller loop lines
+// PairingCheck keeps. Each entry holds millerLineCount lines, about 34KB.
+const lineCacheSize = 32
+
+// lineCache is a least-recently-used cache of the lines returned by
+// precomputeLines, keyed by the marshalled G2 point. Pairing checks that reuse
+// the same G2 points, like the verifying key of a Groth16 verifier, then skip
+// all G2 arithmetic and only evaluate the lines at their G1 points.
+type lineCache struct {
+	mu    sync.Mutex
+	size  int
+	order *list.List // of *lineCacheEntry, most recently used first
+	items map[string]*list.Element
+}
+
+type lineCacheEntry struct {
+	key   string
+	lines []lineCoeffs
+}
+
+var g2LineCache = newLineCache(lineCacheSize)
+
+func newLineCache(size int) *lineCache {
+	return &lineCache{
+		size:  size,
+		order: list.New(),
+		items: make(map[string]*list.Element),
+	}
+}
+
+// lines returns the Miller loop lines of q, computing and caching them if q
+// has not been seen recently. The returned slice must not be modified.
+func (c *lineCache) lines(q *twistPoint) []lineCoeffs {
+	// Marshal normalizes its receiver, so work on a copy of q.
+	p := &twistPoint{}
+	p.Set(q)
+	key := string((&G2{p}).Marshal())
+
+	c.mu.Lock()
+	if elem, ok := c.items[key]; ok {
+		c.order.MoveToFront(elem)
+		c.mu.Unlock()
+		return elem.Value.(*lineCacheEntry).lines
+	}
+	c.mu.Unlock()
+
+	lines := precomputeLines(p)
+
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if _, ok := c.items[key]; !ok {
+		c.items[key] = c.order.PushFront(&lineCacheEntry{key, lines})
+		if c.order.Len() > c.size {
+			oldest := c.order.Back()
+			c.order.Remove(oldest)
+			delete(c.items, oldest.Value.(*lineCacheEntry).key)
+		}
+	}
+	return lines
+}
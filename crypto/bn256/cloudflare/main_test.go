@@ -1,6 +1,8 @@
 package bn256
 
 import (
+	"bytes"
+	"math/big"
 	"testing"
 
 	"crypto/rand"
@@ -69,3 +71,173 @@ func TestPairings(t *testing.T) {
 		t.Error("Pairing mismatch: e(a * 37, b * 27) != e(a, b * 999)")
 	}
 }
+
+func TestPairingCheckMulti(t *testing.T) {
+	for n := 2; n <= 5; n++ {
+		g1s := make([]*G1, n)
+		g2s := make([]*G2, n)
+		sum := new(big.Int)
+		for i := 0; i < n-1; i++ {
+			a, _ := rand.Int(rand.Reader, Order)
+			b, _ := rand.Int(rand.Reader, Order)
+			g1s[i] = new(G1).ScalarBaseMult(a)
+			g2s[i] = new(G2).ScalarBaseMult(b)
+			sum.Add(sum, a.Mul(a, b))
+		}
+		sum.Neg(sum).Mod(sum, Order)
+		g1s[n-1] = new(G1).ScalarBaseMult(sum)
+		g2s[n-1] = new(G2).ScalarBaseMult(big.NewInt(1))
+		if !PairingCheck(g1s, g2s) {
+			t.Errorf("%d pairs: check gave false negative", n)
+		}
+		// Pairs with a point at infinity contribute nothing.
+		withInf1 := append([]*G1{new(G1).ScalarBaseMult(new(big.Int))}, g1s...)
+		withInf2 := append([]*G2{g2s[0]}, g2s...)
+		if !PairingCheck(withInf1, withInf2) {
+			t.Errorf("%d pairs: check with infinity gave false negative", n)
+		}
+		g2s[n-1] = new(G2).ScalarBaseMult(big.NewInt(2))
+		if PairingCheck(g1s, g2s) {
+			t.Errorf("%d pairs: check gave false positive", n)
+		}
+		// The shared Miller loop must agree with the product of single ones.
+		acc := new(gfP12).SetOne()
+		for i := range g1s {
+			acc.Mul(acc, miller(g2s[i].p, g1s[i].p))
+		}
+		lines := make([][]lineCoeffs, n)
+		ps := make([]*curvePoint, n)
+		for i := range g1s {
+			lines[i], ps[i] = precomputeLines(g2s[i].p), g1s[i].p
+		}
+		if *finalExponentiation(acc) != *finalExponentiation(multiMiller(lines, ps)) {
+			t.Errorf("%d pairs: multiMiller disagrees with miller", n)
+		}
+	}
+}
+
+func TestLineCache(t *testing.T) {
+	cache := newLineCache(2)
+	qs := make([]*G2, 3)
+	for i := range qs {
+		_, qs[i], _ = RandomG2(rand.Reader)
+	}
+	l0 := cache.lines(qs[0].p)
+	if len(l0) != millerLineCount {
+		t.Fatalf("got %d lines, want %d", len(l0), millerLineCount)
+	}
+	// An equal point in projective form must hit the same entry.
+	q0 := new(G2).Add(qs[0], qs[0])
+	q0.Add(q0, new(G2).Neg(qs[0]))
+	if q0.p.z.IsOne() {
+		t.Fatal("expected a projective point")
+	}
+	if &cache.lines(q0.p)[0] != &l0[0] {
+		t.Error("equal point missed the cache")
+	}
+	cache.lines(qs[1].p)
+	cache.lines(qs[0].p)
+	cache.lines(qs[2].p)
+	if cache.order.Len() != 2 {
+		t.Fatalf("cache holds %d entries, want 2", cache.order.Len())
+	}
+	// qs[1] was least recently used and must have been evicted.
+	if &cache.lines(qs[0].p)[0] != &l0[0] {
+		t.Error("recently used entry was evicted")
+	}
+	for i, q := range qs {
+		lines := precomputeLines(q.p)
+		cached := cache.lines(q.p)
+		for k := range lines {
+			if lines[k] != cached[k] {
+				t.Fatalf("point %d: line %d differs from precomputeLines", i, k)
+			}
+		}
+	}
+}
+
+func BenchmarkPairingCheck4(b *testing.B) {
+	g1s := make([]*G1, 4)
+	g2s := make([]*G2, 4)
+	for i := range g1s {
+		_, g1s[i], _ = RandomG1(rand.Reader)
+		_, g2s[i], _ = RandomG2(rand.Reader)
+	}
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		PairingCheck(g1s, g2s)
+	}
+}
+
+// multiScalarInputs returns n random points of G1 and G2 and n scalars, with
+// some repeated points, zero, negative and oversized scalars mixed in.
+func multiScalarInputs(t testing.TB, n int) ([]*G1, []*G2, []*big.Int) {
+	g1s, g2s, ks := make([]*G1, n), make([]*G2, n), make([]*big.Int, n)
+	for i := 0; i < n; i++ {
+		var err error
+		if _, g1s[i], err = RandomG1(rand.Reader); err != nil {
+			t.Fatal(err)
+		}
+		if _, g2s[i], err = RandomG2(rand.Reader); err != nil {
+			t.Fatal(err)
+		}
+		if ks[i], err = rand.Int(rand.Reader, Order); err != nil {
+			t.Fatal(err)
+		}
+		switch i % 7 {
+		case 3:
+			g1s[i], g2s[i] = g1s[i-1], g2s[i-1]
+		case 4:
+			ks[i].SetInt64(0)
+		case 5:
+			ks[i].Neg(ks[i])
+		case 6:
+			ks[i].Add(ks[i], Order)
+		}
+	}
+	return g1s, g2s, ks
+}
+
+func TestMultiScalarMult(t *testing.T) {
+	for _, n := range []int{0, 1, 2, 7, 40, 150} {
+		g1s, g2s, ks := multiScalarInputs(t, n)
+
+		want1, want2 := new(G1).ScalarBaseMult(new(big.Int)), new(G2).ScalarBaseMult(new(big.Int))
+		for i := range ks {
+			k := new(big.Int).Mod(ks[i], Order)
+			want1.Add(want1, new(G1).ScalarMult(g1s[i], k))
+			want2.Add(want2, new(G2).ScalarMult(g2s[i], k))
+		}
+		have1 := new(G1).MultiScalarMult(g1s, ks)
+		have2 := new(G2).MultiScalarMult(g2s, ks)
+
+		if !bytes.Equal(have1.Marshal(), want1.Marshal()) {
+			t.Errorf("n=%d: G1 sum mismatch", n)
+		}
+		if !bytes.Equal(have2.Marshal(), want2.Marshal()) {
+			t.Errorf("n=%d: G2 sum mismatch", n)
+		}
+	}
+}
+
+func benchmarkMultiScalarMultG1(b *testing.B, n int) {
+	g1s, _, ks := multiScalarInputs(b, n)
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		new(G1).MultiScalarMult(g1s, ks)
+	}
+}
+
+func benchmarkMultiScalarMultG2(b *testing.B, n int) {
+	_, g2s, ks := multiScalarInputs(b, n)
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		new(G2).MultiScalarMult(g2s, ks)
+	}
+}
+
+func BenchmarkMultiScalarMultG1_8(b *testing.B)   { benchmarkMultiScalarMultG1(b, 8) }
+func BenchmarkMultiScalarMultG1_64(b *testing.B)  { benchmarkMultiScalarMultG1(b, 64) }
+func BenchmarkMultiScalarMultG1_512(b *testing.B) { benchmarkMultiScalarMultG1(b, 512) }
+func BenchmarkMultiScalarMultG2_8(b *testing.B)   { benchmarkMultiScalarMultG2(b, 8) }
+func BenchmarkMultiScalarMultG2_64(b *testing.B)  { benchmarkMultiScalarMultG2(b, 64) }
@@ -0,0 +1,206 @@
+package bn256
+
+import (
+	"math/big"
+	"math/bits"
+)
+
+// This file implements multi-scalar multiplication, sum(scalars[i]*points[i]),
+// with Pippenger's bucket method. Each scalar is split into signed c-bit
+// digits. Window by window, from the top, every point is added to the bucket
+// of its digit and the buckets are summed with a running sum, so that a window
+// costs about n+2^c additions instead of n scalar multiplications. None of it
+// is constant time, just like curvePoint.Mul and twistPoint.Mul.
+
+// msmWindow returns the digit size in bits for n points. It is about ln(n)+1,
+// which balances the n bucket additions of a window against the 2^c
+// additions that sum the buckets.
+func msmWindow(n int) uint {
+	if n < 8 {
+		return 2
+	}
+	c := uint(bits.Len(uint(n)))*2/3 + 1
+	if c > 16 {
+		c = 16
+	}
+	return c
+}
+
+// msmDigits splits the non-negative k into windows signed c-bit digits d, with
+// k = sum(d[j] * 2^(c*j)) and -2^(c-1) < d[j] <= 2^(c-1).
+func msmDigits(k *big.Int, c uint, windows int) []int32 {
+	digits := make([]int32, windows)
+
+	carry := uint(0)
+	for j := range digits {
+		w := carry
+		for b := uint(0); b < c; b++ {
+			w += k.Bit(j*int(c)+int(b)) << b
+		}
+		if w > 1<<(c-1) {
+			digits[j], carry = int32(w)-1<<c, 1
+		} else {
+			digits[j], carry = int32(w), 0
+		}
+	}
+	return digits
+}
+
+// msmWindows returns the number of c-bit digits msmDigits needs for scalars of
+// at most maxBits bits, leaving room for the final carry.
+func msmWindows(maxBits int, c uint) int {
+	return maxBits/int(c) + 1
+}
+
+// MultiMul sets c to sum(scalars[i]*points[i]). The scalars are reduced mod
+// Order and split with curveLattice, so every point is used twice, once with
+// the endomorphism applied, with scalars of about 128 bits.
+func (c *curvePoint) MultiMul(points []*curvePoint, scalars []*big.Int) {
+	if len(points) == 1 {
+		// Mul's joint 2-bit windows beat two buckets.
+		c.Mul(points[0], new(big.Int).Mod(scalars[0], Order))
+		return
+	}
+	ps := make([]*curvePoint, 0, 2*len(points))
+	ks := make([]*big.Int, 0, 2*len(points))
+	maxBits := 0
+	for i, a := range points {
+		k := new(big.Int).Mod(scalars[i], Order)
+		decomp := curveLattice.decompose(k)
+
+		phi := &curvePoint{}
+		phi.Set(a)
+		gfpMul(&phi.x, &phi.x, xiTo2PSquaredMinus2Over3)
+
+		ps = append(ps, a, phi)
+		ks = append(ks, decomp[0], decomp[1])
+		for _, x := range decomp {
+			if x.BitLen() > maxBits {
+				maxBits = x.BitLen()
+			}
+		}
+	}
+
+	w := msmWindow(len(ps))
+	windows := msmWindows(maxBits, w)
+	digits := make([][]int32, len(ps))
+	for i, k := range ks {
+		digits[i] = msmDigits(k, w, windows)
+	}
+
+	negs := make([]*curvePoint, len(ps))
+	for i, a := range ps {
+		negs[i] = &curvePoint{}
+		negs[i].Neg(a)
+	}
+
+	buckets := make([]curvePoint, 1<<(w-1))
+	sum, running, acc, t := &curvePoint{}, &curvePoint{}, &curvePoint{}, &curvePoint{}
+	sum.SetInfinity()
+
+	for j := windows - 1; j >= 0; j-- {
+		for i := uint(0); i < w; i++ {
+			t.Double(sum)
+			sum.Set(t)
+		}
+
+		for b := range buckets {
+			buckets[b].SetInfinity()
+		}
+		for i, d := range digits {
+			switch {
+			case d[j] > 0:
+				t.Add(&buckets[d[j]-1], ps[i])
+				buckets[d[j]-1].Set(t)
+			case d[j] < 0:
+				t.Add(&buckets[-d[j]-1], negs[i])
+				buckets[-d[j]-1].Set(t)
+			}
+		}
+
+		// acc = sum((b+1) * buckets[b])
+		running.SetInfinity()
+		acc.SetInfinity()
+		for b := len(buckets) - 1; b >= 0; b-- {
+			t.Add(running, &buckets[b])
+			running.Set(t)
+			t.Add(acc, running)
+			acc.Set(t)
+		}
+
+		t.Add(sum, acc)
+		sum.Set(t)
+	}
+	c.Set(sum)
+}
+
+// MultiMul sets c to sum(scalars[i]*points[i]). Negative scalars negate their
+// point.
+func (c *twistPoint) MultiMul(points []*twistPoint, scalars []*big.Int) {
+	ps := make([]*twistPoint, len(points))
+	ks := make([]*big.Int, len(points))
+	maxBits := 0
+	for i, a := range points {
+		ps[i], ks[i] = a, scalars[i]
+		if ks[i].Sign() < 0 {
+			ps[i] = &twistPoint{}
+			ps[i].Neg(a)
+			ks[i] = new(big.Int).Neg(scalars[i])
+		}
+		if ks[i].BitLen() > maxBits {
+			maxBits = ks[i].BitLen()
+		}
+	}
+
+	w := msmWindow(len(ps))
+	windows := msmWindows(maxBits, w)
+	digits := make([][]int32, len(ps))
+	for i, k := range ks {
+		digits[i] = msmDigits(k, w, windows)
+	}
+
+	negs := make([]*twistPoint, len(ps))
+	for i, a := range ps {
+		negs[i] = &twistPoint{}
+		negs[i].Neg(a)
+	}
+
+	buckets := make([]twistPoint, 1<<(w-1))
+	sum, running, acc, t := &twistPoint{}, &twistPoint{}, &twistPoint{}, &twistPoint{}
+	sum.SetInfinity()
+
+	for j := windows - 1; j >= 0; j-- {
+		for i := uint(0); i < w; i++ {
+			t.Double(sum)
+			sum.Set(t)
+		}
+
+		for b := range buckets {
+			buckets[b].SetInfinity()
+		}
+		for i, d := range digits {
+			switch {
+			case d[j] > 0:
+				t.Add(&buckets[d[j]-1], ps[i])
+				buckets[d[j]-1].Set(t)
+			case d[j] < 0:
+				t.Add(&buckets[-d[j]-1], negs[i])
+				buckets[-d[j]-1].Set(t)
+			}
+		}
+
+		// acc = sum((b+1) * buckets[b])
+		running.SetInfinity()
+		acc.SetInfinity()
+		for b := len(buckets) - 1; b >= 0; b-- {
+			t.Add(running, &buckets[b])
+			running.Set(t)
+			t.Add(acc, running)
+			acc.Set(t)
+		}
+
+		t.Add(sum, acc)
+		sum.Set(t)
+	}
+	c.Set(sum)
+}
@@ -0,0 +1,74 @@
+// Montgomery multiplication with ADCX/ADOX, interleaving the reduction with
+// the multiplication (CIOS). The accumulator t0..t4, plus t5 for the carries
+// of the current row, stays in registers; after each row t0 is zero and is
+// reused as the next row's t5. The result is the same (a*b + m*p)/2^256 as
+// mul followed by gfpReduce, before the final gfpCarry.
+
+// t = a0*b, with t5 cleared for mulADXReduce
+#define mulADXFirst(a0, rb, t0,t1,t2,t3,t4,t5) \
+	MOVQ a0, DX \
+	XORQ t5, t5 \
+	MULXQ 0+rb, t0, t1 \
+	MULXQ 8+rb, AX, t2 \
+	ADCXQ AX, t1 \
+	MULXQ 16+rb, AX, t3 \
+	ADCXQ AX, t2 \
+	MULXQ 24+rb, AX, t4 \
+	ADCXQ AX, t3 \
+	ADCXQ t5, t4
+
+// t += ai*b, with the low halves on the OF chain and the high halves on the
+// CF chain
+#define mulADXRow(ai, rb, t0,t1,t2,t3,t4,t5) \
+	MOVQ ai, DX \
+	XORQ t5, t5 \
+	MULXQ 0+rb, AX, BX \
+	ADOXQ AX, t0 \
+	ADCXQ BX, t1 \
+	MULXQ 8+rb, AX, BX \
+	ADOXQ AX, t1 \
+	ADCXQ BX, t2 \
+	MULXQ 16+rb, AX, BX \
+	ADOXQ AX, t2 \
+	ADCXQ BX, t3 \
+	MULXQ 24+rb, AX, BX \
+	ADOXQ AX, t3 \
+	ADCXQ BX, t4 \
+	MOVQ $0, AX \
+	ADOXQ AX, t4 \
+	ADCXQ AX, t5 \
+	ADOXQ AX, t5
+
+// t += m*p for m = -t0/p mod 2^64, which clears t0
+#define mulADXReduce(t0,t1,t2,t3,t4,t5) \
+	MOVQ t0, DX \
+	MULXQ ·np+0(SB), DX, AX \
+	XORQ AX, AX \
+	MULXQ ·p2+0(SB), AX, BX \
+	ADCXQ AX, t0 \
+	ADOXQ BX, t1 \
+	MULXQ ·p2+8(SB), AX, BX \
+	ADCXQ AX, t1 \
+	ADOXQ BX, t2 \
+	MULXQ ·p2+16(SB), AX, BX \
+	ADCXQ AX, t2 \
+	ADOXQ BX, t3 \
+	MULXQ ·p2+24(SB), AX, BX \
+	ADCXQ AX, t3 \
+	ADOXQ BX, t4 \
+	MOVQ $0, AX \
+	ADCXQ AX, t4 \
+	ADOXQ AX, t5 \
+	ADCXQ AX, t5
+
+// (R12,R13,R8,R9) = a*b/2^256 mod p
+#define mulADX(a0,a1,a2,a3, rb) \
+	mulADXFirst(a0, rb, R8,R9,R10,R11,R12,R13) \
+	mulADXReduce(R8,R9,R10,R11,R12,R13) \
+	mulADXRow(a1, rb, R9,R10,R11,R12,R13,R8) \
+	mulADXReduce(R9,R10,R11,R12,R13,R8) \
+	mulADXRow(a2, rb, R10,R11,R12,R13,R8,R9) \
+	mulADXReduce(R10,R11,R12,R13,R8,R9) \
+	mulADXRow(a3, rb, R11,R12,R13,R8,R9,R10) \
+	mulADXReduce(R11,R12,R13,R8,R9,R10) \
+	gfpCarry(R12,R13,R8,R9,R10, R11,R14,R15,AX,BX)
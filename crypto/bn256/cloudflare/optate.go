@@ -1,6 +1,9 @@
 package bn256
 
-func lineFunctionAdd(r, p *twistPoint, q *curvePoint, r2 *gfP2) (a, b, c *gfP2, rOut *twistPoint) {
+// The line functions below only depend on the twist points. The line through
+// them, evaluated at a curve point q, is (aτ + b·q.x)ω + c·q.y; see mulLineAt.
+
+func lineFunctionAdd(r, p *twistPoint, r2 *gfP2) (a, b, c *gfP2, rOut *twistPoint) {
 	// See the mixed addition algorithm from "Faster Computation of the
 	// Tate Pairing", http://arxiv.org/pdf/0904.0854v3.pdf
 	B := (&gfP2{}).Mul(&p.x, &r.t)
@@ -40,16 +43,15 @@ func lineFunctionAdd(r, p *twistPoint, q *curvePoint, r2 *gfP2) (a, b, c *gfP2,
 	t2.Add(t2, t2)
 	a = (&gfP2{}).Sub(t2, t)
 
-	c = (&gfP2{}).MulScalar(&rOut.z, &q.y)
-	c.Add(c, c)
+	c = (&gfP2{}).Add(&rOut.z, &rOut.z)
 
 	b = (&gfP2{}).Neg(L1)
-	b.MulScalar(b, &q.x).Add(b, b)
+	b.Add(b, b)
 
 	return
 }
 
-func lineFunctionDouble(r *twistPoint, q *curvePoint) (a, b, c *gfP2, rOut *twistPoint) {
+func lineFunctionDouble(r *twistPoint) (a, b, c *gfP2, rOut *twistPoint) {
 	// See the doubling algorithm for a=0 from "Faster Computation of the
 	// Tate Pairing", http://arxiv.org/pdf/0904.0854v3.pdf
 	A := (&gfP2{}).Square(&r.x)
@@ -78,7 +80,6 @@ func lineFunctionDouble(r *twistPoint, q *curvePoint) (a, b, c *gfP2, rOut *twis
 
 	t.Mul(E, &r.t).Add(t, t)
 	b = (&gfP2{}).Neg(t)
-	b.MulScalar(b, &q.x)
 
 	a = (&gfP2{}).Add(&r.x, E)
 	a.Square(a).Sub(a, A).Sub(a, G)
@@ -86,27 +87,23 @@ func lineFunctionDouble(r *twistPoint, q *curvePoint) (a, b, c *gfP2, rOut *twis
 	a.Sub(a, t)
 
 	c = (&gfP2{}).Mul(&rOut.z, &r.t)
-	c.Add(c, c).MulScalar(c, &q.y)
+	c.Add(c, c)
 
 	return
 }
 
+// mulLine multiplies ret by the line (aτ+b)ω + c. Both gfP6 factors of the
+// line lack a τ² term, so they are multiplied with MulSparse.
 func mulLine(ret *gfP12, a, b, c *gfP2) {
-	a2 := &gfP6{}
-	a2.y.Set(a)
-	a2.z.Set(b)
-	a2.Mul(a2, &ret.x)
+	a2 := (&gfP6{}).MulSparse(&ret.x, a, b)
 	t3 := (&gfP6{}).MulScalar(&ret.y, c)
 
 	t := (&gfP2{}).Add(b, c)
-	t2 := &gfP6{}
-	t2.y.Set(a)
-	t2.z.Set(t)
 	ret.x.Add(&ret.x, &ret.y)
 
 	ret.y.Set(t3)
 
-	ret.x.Mul(&ret.x, t2).Sub(&ret.x, a2).Sub(&ret.x, &ret.y)
+	ret.x.MulSparse(&ret.x, a, t).Sub(&ret.x, a2).Sub(&ret.x, &ret.y)
 	a2.MulTau(a2)
 	ret.y.Add(&ret.y, a2)
 }
@@ -117,19 +114,46 @@ var sixuPlus2NAF = []int8{0, 0, 0, 1, 0, 1, 0, -1, 0, 0, 1, -1, 0, 0, 1, 0,
 	1, 0, 0, -1, 0, 0, 1, 0, 0, 0, 0, 0, -1, 0, 0, 1,
 	1, 0, 0, -1, 0, 0, 0, 1, 1, 0, -1, 0, 0, 1, 0, 1, 1}
 
-// miller implements the Miller loop for calculating the Optimal Ate pairing.
-// See algorithm 1 from http://cryptojedi.org/papers/dclxvi-20100714.pdf
-func miller(q *twistPoint, p *curvePoint) *gfP12 {
-	ret := (&gfP12{}).SetOne()
+// millerLineCount is the number of lines in a Miller loop: one doubling per
+// digit of sixuPlus2NAF after the first, one addition per non-zero digit
+// after the first, and the additions of Q1 and -Q2.
+var millerLineCount = func() int {
+	n := len(sixuPlus2NAF) + 1
+	for _, d := range sixuPlus2NAF[:len(sixuPlus2NAF)-1] {
+		if d != 0 {
+			n++
+		}
+	}
+	return n
+}()
+
+// lineCoeffs is a line of the Miller loop with the curve point factored out,
+// as returned by lineFunctionAdd and lineFunctionDouble.
+type lineCoeffs struct {
+	a, b, c gfP2
+}
+
+// mulLineAt multiplies ret by the line l evaluated at the affine point q.
+func mulLineAt(ret *gfP12, l *lineCoeffs, q *curvePoint) {
+	b := (&gfP2{}).MulScalar(&l.b, &q.x)
+	c := (&gfP2{}).MulScalar(&l.c, &q.y)
+	mulLine(ret, &l.a, b, c)
+}
+
+// precomputeLines walks the twist point q through the Miller loop for
+// calculating the Optimal Ate pairing and returns the millerLineCount lines it
+// passes through. See algorithm 1 from
+// http://cryptojedi.org/papers/dclxvi-20100714.pdf
+func precomputeLines(q *twistPoint) []lineCoeffs {
+	lines := make([]lineCoeffs, 0, millerLineCount)
+	add := func(a, b, c *gfP2) {
+		lines = append(lines, lineCoeffs{*a, *b, *c})
+	}
 
 	aAffine := &twistPoint{}
 	aAffine.Set(q)
 	aAffine.MakeAffine()
 
-	bAffine := &curvePoint{}
-	bAffine.Set(p)
-	bAffine.MakeAffine()
-
 	minusA := &twistPoint{}
 	minusA.Neg(aAffine)
 
@@ -139,24 +163,20 @@ func miller(q *twistPoint, p *curvePoint) *gfP12 {
 	r2 := (&gfP2{}).Square(&aAffine.y)
 
 	for i := len(sixuPlus2NAF) - 1; i > 0; i-- {
-		a, b, c, newR := lineFunctionDouble(r, bAffine)
-		if i != len(sixuPlus2NAF)-1 {
-			ret.Square(ret)
-		}
-
-		mulLine(ret, a, b, c)
+		a, b, c, newR := lineFunctionDouble(r)
+		add(a, b, c)
 		r = newR
 
 		switch sixuPlus2NAF[i-1] {
 		case 1:
-			a, b, c, newR = lineFunctionAdd(r, aAffine, bAffine, r2)
+			a, b, c, newR = lineFunctionAdd(r, aAffine, r2)
 		case -1:
-			a, b, c, newR = lineFunctionAdd(r, minusA, bAffine, r2)
+			a, b, c, newR = lineFunctionAdd(r, minusA, r2)
 		default:
 			continue
 		}
 
-		mulLine(ret, a, b, c)
+		add(a, b, c)
 		r = newR
 	}
 
@@ -194,14 +214,55 @@ func miller(q *twistPoint, p *curvePoint) *gfP12 {
 	minusQ2.t.SetOne()
 
 	r2.Square(&q1.y)
-	a, b, c, newR := lineFunctionAdd(r, q1, bAffine, r2)
-	mulLine(ret, a, b, c)
+	a, b, c, newR := lineFunctionAdd(r, q1, r2)
+	add(a, b, c)
 	r = newR
 
 	r2.Square(&minusQ2.y)
-	a, b, c, newR = lineFunctionAdd(r, minusQ2, bAffine, r2)
-	mulLine(ret, a, b, c)
-	r = newR
+	a, b, c, _ = lineFunctionAdd(r, minusQ2, r2)
+	add(a, b, c)
+
+	return lines
+}
+
+// miller implements the Miller loop for calculating the Optimal Ate pairing.
+func miller(q *twistPoint, p *curvePoint) *gfP12 {
+	return multiMiller([][]lineCoeffs{precomputeLines(q)}, []*curvePoint{p})
+}
+
+// multiMiller computes the product of the Miller loops of the pairs whose
+// twist points passed through lines[i] and whose curve points are ps[i]. The
+// loops run in lockstep so that every iteration squares the shared
+// accumulator once, rather than once per pair.
+func multiMiller(lines [][]lineCoeffs, ps []*curvePoint) *gfP12 {
+	ret := (&gfP12{}).SetOne()
+
+	bAffine := make([]curvePoint, len(ps))
+	for j := range ps {
+		bAffine[j].Set(ps[j])
+		bAffine[j].MakeAffine()
+	}
+	mulLines := func(k int) {
+		for j := range bAffine {
+			mulLineAt(ret, &lines[j][k], &bAffine[j])
+		}
+	}
+
+	k := 0
+	for i := len(sixuPlus2NAF) - 1; i > 0; i-- {
+		if i != len(sixuPlus2NAF)-1 {
+			ret.Square(ret)
+		}
+		mulLines(k)
+		k++
+
+		if sixuPlus2NAF[i-1] != 0 {
+			mulLines(k)
+			k++
+		}
+	}
+	mulLines(k)
+	mulLines(k + 1)
 
 	return ret
 }
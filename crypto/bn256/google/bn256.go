@@ -83,6 +83,31 @@ func (e *G1) ScalarMult(a *G1, k *big.Int) *G1 {
 	return e
 }
 
+// MultiScalarMult sets e to the sum of points[i]*scalars[i] and then returns
+// e. It panics if points and scalars differ in length. This implementation
+// just adds up the individual products, with the scalars reduced mod Order.
+func (e *G1) MultiScalarMult(points []*G1, scalars []*big.Int) *G1 {
+	if len(points) != len(scalars) {
+		panic("bn256: mismatched number of points and scalars")
+	}
+	pool := new(bnPool)
+	sum, term, t := newCurvePoint(pool), newCurvePoint(pool), newCurvePoint(pool)
+	sum.SetInfinity()
+	for i, a := range points {
+		term.Mul(a.p, new(big.Int).Mod(scalars[i], Order), pool)
+		t.Add(sum, term, pool)
+		sum.Set(t)
+	}
+	if e.p == nil {
+		e.p = newCurvePoint(nil)
+	}
+	e.p.Set(sum)
+	sum.Put(pool)
+	term.Put(pool)
+	t.Put(pool)
+	return e
+}
+
 // Add sets e to a+b and then returns e.
 // BUG(agl): this function is not complete: a==b fails.
 func (e *G1) Add(a, b *G1) *G1 {
@@ -213,6 +238,31 @@ func (e *G2) ScalarMult(a *G2, k *big.Int) *G2 {
 	return e
 }
 
+// MultiScalarMult sets e to the sum of points[i]*scalars[i] and then returns
+// e. It panics if points and scalars differ in length. This implementation
+// just adds up the individual products, with the scalars reduced mod Order.
+func (e *G2) MultiScalarMult(points []*G2, scalars []*big.Int) *G2 {
+	if len(points) != len(scalars) {
+		panic("bn256: mismatched number of points and scalars")
+	}
+	pool := new(bnPool)
+	sum, term, t := newTwistPoint(pool), newTwistPoint(pool), newTwistPoint(pool)
+	sum.SetInfinity()
+	for i, a := range points {
+		term.Mul(a.p, new(big.Int).Mod(scalars[i], Order), pool)
+		t.Add(sum, term, pool)
+		sum.Set(t)
+	}
+	if e.p == nil {
+		e.p = newTwistPoint(nil)
+	}
+	e.p.Set(sum)
+	sum.Put(pool)
+	term.Put(pool)
+	t.Put(pool)
+	return e
+}
+
 // Add sets e to a+b and then returns e.
 // BUG(agl): this function is not complete: a==b fails.
 func (e *G2) Add(a, b *G2) *G2 {
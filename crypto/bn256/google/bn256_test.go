@@ -309,3 +309,26 @@ func BenchmarkPairing(b *testing.B) {
 		Pair(&G1{curveGen}, &G2{twistGen})
 	}
 }
+
+func TestMultiScalarMult(t *testing.T) {
+	for _, n := range []int{0, 1, 3} {
+		g1s, g2s, ks := make([]*G1, n), make([]*G2, n), make([]*big.Int, n)
+		want1, want2 := new(G1).ScalarBaseMult(new(big.Int)), new(G2).ScalarBaseMult(new(big.Int))
+		for i := range ks {
+			ks[i], _ = rand.Int(rand.Reader, Order)
+			_, g1s[i], _ = RandomG1(rand.Reader)
+			_, g2s[i], _ = RandomG2(rand.Reader)
+			want1.Add(want1, new(G1).ScalarMult(g1s[i], ks[i]))
+			want2.Add(want2, new(G2).ScalarMult(g2s[i], ks[i]))
+		}
+		have1 := new(G1).MultiScalarMult(g1s, ks)
+		have2 := new(G2).MultiScalarMult(g2s, ks)
+
+		if !bytes.Equal(have1.Marshal(), want1.Marshal()) {
+			t.Errorf("n=%d: G1 sum mismatch", n)
+		}
+		if !bytes.Equal(have2.Marshal(), want2.Marshal()) {
+			t.Errorf("n=%d: G2 sum mismatch", n)
+		}
+	}
+}
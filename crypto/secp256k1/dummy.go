@@ -17,5 +17,6 @@ package secp256k1
 import (
 	_ "github.com/ethereum/go-ethereum/crypto/secp256k1/libsecp256k1/include"
 	_ "github.com/ethereum/go-ethereum/crypto/secp256k1/libsecp256k1/src"
+	_ "github.com/ethereum/go-ethereum/crypto/secp256k1/libsecp256k1/src/asm"
 	_ "github.com/ethereum/go-ethereum/crypto/secp256k1/libsecp256k1/src/modules/recovery"
 )
@@ -7,6 +7,129 @@ static secp256k1_context* secp256k1_context_create_sign_verify() {
 	return secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
 }
 
+// Latency histograms for the secp256k1_ext entry points.
+//
+// Every operation has a log-linear histogram of wall-clock latencies in nanoseconds:
+// values below 4 get a bucket each, and every power of two above that is split into
+// 4 equally wide buckets, so a bucket is never wider than a quarter of its lower
+// bound. The histograms are sharded: each thread records into one of
+// SECP256K1_EXT_LATENCY_SHARDS copies, picked round-robin on its first sample, and
+// readers add the copies up. Recording is two relaxed atomic additions to lines the
+// other shards do not touch and never blocks. While recording is disabled, the only
+// cost is a single relaxed load per call.
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#define SECP256K1_EXT_LATENCY_BUCKETS 256
+#define SECP256K1_EXT_LATENCY_SHARDS  16
+
+enum {
+	SECP256K1_EXT_OP_RECOVER,
+	SECP256K1_EXT_OP_RECOVER_CHECK,
+	SECP256K1_EXT_OP_VERIFY,
+	SECP256K1_EXT_OP_SIGN,
+	SECP256K1_EXT_OP_REENCODE,
+	SECP256K1_EXT_OP_SCALAR_MUL,
+	SECP256K1_EXT_OP_COUNT
+};
+
+// The number of samples is not stored, it is the total of the buckets.
+typedef struct {
+	uint64_t sum;
+	uint64_t buckets[SECP256K1_EXT_LATENCY_BUCKETS];
+} secp256k1_ext_latency;
+
+typedef struct {
+	secp256k1_ext_latency ops[SECP256K1_EXT_OP_COUNT];
+} __attribute__((aligned(64))) secp256k1_ext_latency_shard;
+
+static int secp256k1_ext_latency_enabled;
+static unsigned int secp256k1_ext_latency_threads;
+static __thread unsigned int secp256k1_ext_latency_slot; // shard index + 1, 0: unassigned
+static secp256k1_ext_latency_shard secp256k1_ext_latencies[SECP256K1_EXT_LATENCY_SHARDS];
+
+// secp256k1_ext_latency_enable switches recording on (enabled != 0) or off.
+static void secp256k1_ext_latency_enable(int enabled) {
+	__atomic_store_n(&secp256k1_ext_latency_enabled, enabled != 0, __ATOMIC_RELAXED);
+}
+
+// secp256k1_ext_latency_bucket returns the histogram bucket of a latency.
+static int secp256k1_ext_latency_bucket(uint64_t ns) {
+	int log2;
+
+	if (ns < 4) {
+		return (int)ns;
+	}
+	log2 = 63 - __builtin_clzll(ns);
+	return 4 * (log2 - 1) + (int)((ns >> (log2 - 2)) & 3);
+}
+
+// secp256k1_ext_latency_now returns a monotonic timestamp in nanoseconds.
+static uint64_t secp256k1_ext_latency_now(void) {
+#ifdef _WIN32
+	static LARGE_INTEGER freq;
+	LARGE_INTEGER now;
+
+	if (freq.QuadPart == 0) {
+		QueryPerformanceFrequency(&freq);
+	}
+	QueryPerformanceCounter(&now);
+	return (uint64_t)(now.QuadPart / freq.QuadPart) * 1000000000 +
+		(uint64_t)(now.QuadPart % freq.QuadPart) * 1000000000 / (uint64_t)freq.QuadPart;
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// secp256k1_ext_latency_begin returns the start time of an operation, or 0 if
+// recording is disabled.
+static uint64_t secp256k1_ext_latency_begin(void) {
+	if (!__atomic_load_n(&secp256k1_ext_latency_enabled, __ATOMIC_RELAXED)) {
+		return 0;
+	}
+	return secp256k1_ext_latency_now() + 1;
+}
+
+// secp256k1_ext_latency_end records the latency of an operation that started at begin.
+static void secp256k1_ext_latency_end(int op, uint64_t begin) {
+	secp256k1_ext_latency *h;
+	uint64_t ns;
+
+	if (begin == 0) {
+		return;
+	}
+	ns = secp256k1_ext_latency_now() + 1 - begin;
+	if (secp256k1_ext_latency_slot == 0) {
+		secp256k1_ext_latency_slot = __atomic_fetch_add(&secp256k1_ext_latency_threads, 1, __ATOMIC_RELAXED) % SECP256K1_EXT_LATENCY_SHARDS + 1;
+	}
+	h = &secp256k1_ext_latencies[secp256k1_ext_latency_slot - 1].ops[op];
+	__atomic_fetch_add(&h->buckets[secp256k1_ext_latency_bucket(ns)], 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&h->sum, ns, __ATOMIC_RELAXED);
+}
+
+// secp256k1_ext_latency_snapshot adds up the shards of an operation's histogram. The
+// copy is not atomic as a whole, so under concurrent recording the sum may be a few
+// samples ahead of the buckets.
+static void secp256k1_ext_latency_snapshot(int op, uint64_t *buckets, uint64_t *sum) {
+	int i, j;
+
+	memset(buckets, 0, SECP256K1_EXT_LATENCY_BUCKETS * sizeof(uint64_t));
+	*sum = 0;
+	for (i = 0; i < SECP256K1_EXT_LATENCY_SHARDS; i++) {
+		const secp256k1_ext_latency *h = &secp256k1_ext_latencies[i].ops[op];
+		for (j = 0; j < SECP256K1_EXT_LATENCY_BUCKETS; j++) {
+			buckets[j] += __atomic_load_n(&h->buckets[j], __ATOMIC_RELAXED);
+		}
+		*sum += __atomic_load_n(&h->sum, __ATOMIC_RELAXED);
+	}
+}
+
 // secp256k1_ext_ecdsa_recover recovers the public key of an encoded compact signature.
 //
 // Returns: 1: recovery was successful
@@ -34,6 +157,274 @@ static int secp256k1_ext_ecdsa_recover(
 	return secp256k1_ec_pubkey_serialize(ctx, pubkey_out, &outputlen, &pubkey, SECP256K1_EC_UNCOMPRESSED);
 }
 
+// secp256k1_ext_sigcache is a bounded cache of recovered public keys, keyed by a
+// salted SHA256 of the 32-byte message and the 65-byte signature.
+//
+// The cache is split into shards, each holding 4-way associative buckets and its
+// own counters so that concurrent callers do not contend on a single cache line.
+// Lookups never block: every slot carries a sequence number which writers make odd
+// while they update the slot, and a reader that observes a concurrent write treats
+// the lookup as a miss. A writer that loses the race for a slot drops its insertion.
+#define SECP256K1_EXT_SIGCACHE_SHARDS 16
+#define SECP256K1_EXT_SIGCACHE_WAYS   4
+
+typedef struct {
+	uint64_t seq;       // 0: empty, odd: being written, even: valid
+	uint64_t tag[4];    // salted hash of msgdata || sigdata
+	uint64_t pubkey[8]; // X || Y of the recovered key
+} secp256k1_ext_sigcache_slot;
+
+// The counters are written on every lookup and share the first cache line of a
+// shard, the slot table pointer and size are only read and get a line of their own.
+typedef struct {
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t evictions;
+	uint64_t clock;
+	unsigned char pad0[64 - 4 * sizeof(uint64_t)];
+	secp256k1_ext_sigcache_slot *slots;
+	size_t buckets;
+	unsigned char pad1[64 - sizeof(void*) - sizeof(size_t)];
+} secp256k1_ext_sigcache_shard;
+
+// The cache is placed on a 64-byte boundary inside a larger malloc'd block, whose
+// start is kept in mem for freeing, and the shards come first, so that every shard
+// covers exactly two cache lines.
+typedef struct {
+	secp256k1_ext_sigcache_shard shards[SECP256K1_EXT_SIGCACHE_SHARDS];
+	unsigned char salt[32];
+	void *mem;
+} secp256k1_ext_sigcache;
+
+// secp256k1_ext_sigcache_create allocates a cache with room for at least entries
+// public keys. The salt must be 32 random bytes.
+//
+// Returns: the cache, or NULL if allocation failed.
+static secp256k1_ext_sigcache* secp256k1_ext_sigcache_create(size_t entries, const unsigned char *salt) {
+	secp256k1_ext_sigcache *cache;
+	size_t perbucket = SECP256K1_EXT_SIGCACHE_SHARDS * SECP256K1_EXT_SIGCACHE_WAYS;
+	size_t buckets = (entries + perbucket - 1) / perbucket;
+	void *mem;
+	int i;
+
+	if (buckets == 0) {
+		buckets = 1;
+	}
+	if ((mem = malloc(sizeof(*cache) + 63)) == NULL) {
+		return NULL;
+	}
+	cache = (secp256k1_ext_sigcache*)(((uintptr_t)mem + 63) & ~(uintptr_t)63);
+	memset(cache, 0, sizeof(*cache));
+	memcpy(cache->salt, salt, 32);
+	cache->mem = mem;
+	for (i = 0; i < SECP256K1_EXT_SIGCACHE_SHARDS; i++) {
+		secp256k1_ext_sigcache_shard *shard = &cache->shards[i];
+		shard->buckets = buckets;
+		shard->slots = (secp256k1_ext_sigcache_slot*)calloc(buckets * SECP256K1_EXT_SIGCACHE_WAYS, sizeof(secp256k1_ext_sigcache_slot));
+		if (shard->slots == NULL) {
+			while (i-- > 0) {
+				free(cache->shards[i].slots);
+			}
+			free(mem);
+			return NULL;
+		}
+	}
+	return cache;
+}
+
+// secp256k1_ext_sigcache_destroy releases a cache. It must not be in use.
+static void secp256k1_ext_sigcache_destroy(secp256k1_ext_sigcache *cache) {
+	int i;
+
+	if (cache == NULL) {
+		return;
+	}
+	for (i = 0; i < SECP256K1_EXT_SIGCACHE_SHARDS; i++) {
+		free(cache->shards[i].slots);
+	}
+	free(cache->mem);
+}
+
+// secp256k1_ext_sigcache_stats sums the counters of all shards.
+static void secp256k1_ext_sigcache_stats(
+	const secp256k1_ext_sigcache *cache,
+	uint64_t *hits,
+	uint64_t *misses,
+	uint64_t *evictions
+) {
+	int i;
+
+	*hits = *misses = *evictions = 0;
+	for (i = 0; i < SECP256K1_EXT_SIGCACHE_SHARDS; i++) {
+		*hits += __atomic_load_n(&cache->shards[i].hits, __ATOMIC_RELAXED);
+		*misses += __atomic_load_n(&cache->shards[i].misses, __ATOMIC_RELAXED);
+		*evictions += __atomic_load_n(&cache->shards[i].evictions, __ATOMIC_RELAXED);
+	}
+}
+
+static secp256k1_ext_sigcache_slot* secp256k1_ext_sigcache_bucket(const secp256k1_ext_sigcache_shard *shard, const uint64_t *tag) {
+	return shard->slots + ((tag[1] % shard->buckets) * SECP256K1_EXT_SIGCACHE_WAYS);
+}
+
+static int secp256k1_ext_sigcache_get(secp256k1_ext_sigcache_shard *shard, const uint64_t *tag, unsigned char *pubkey64) {
+	secp256k1_ext_sigcache_slot *bucket = secp256k1_ext_sigcache_bucket(shard, tag);
+	uint64_t pubkey[8];
+	int i, j;
+
+	for (i = 0; i < SECP256K1_EXT_SIGCACHE_WAYS; i++) {
+		secp256k1_ext_sigcache_slot *slot = &bucket[i];
+		uint64_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+		if (seq == 0 || (seq & 1)) {
+			continue;
+		}
+		for (j = 0; j < 4; j++) {
+			if (__atomic_load_n(&slot->tag[j], __ATOMIC_RELAXED) != tag[j]) {
+				break;
+			}
+		}
+		if (j != 4) {
+			continue;
+		}
+		for (j = 0; j < 8; j++) {
+			pubkey[j] = __atomic_load_n(&slot->pubkey[j], __ATOMIC_RELAXED);
+		}
+		// The copy is only valid if no writer touched the slot meanwhile.
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != seq) {
+			continue;
+		}
+		memcpy(pubkey64, pubkey, 64);
+		return 1;
+	}
+	return 0;
+}
+
+static void secp256k1_ext_sigcache_put(secp256k1_ext_sigcache_shard *shard, const uint64_t *tag, const unsigned char *pubkey64) {
+	secp256k1_ext_sigcache_slot *bucket = secp256k1_ext_sigcache_bucket(shard, tag);
+	secp256k1_ext_sigcache_slot *slot = NULL;
+	uint64_t pubkey[8];
+	uint64_t seq;
+	int i;
+
+	for (i = 0; i < SECP256K1_EXT_SIGCACHE_WAYS; i++) {
+		if (__atomic_load_n(&bucket[i].seq, __ATOMIC_RELAXED) == 0) {
+			slot = &bucket[i];
+			break;
+		}
+	}
+	if (slot == NULL) {
+		slot = &bucket[__atomic_fetch_add(&shard->clock, 1, __ATOMIC_RELAXED) % SECP256K1_EXT_SIGCACHE_WAYS];
+	}
+	seq = __atomic_load_n(&slot->seq, __ATOMIC_RELAXED);
+	if ((seq & 1) || !__atomic_compare_exchange_n(&slot->seq, &seq, seq + 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+		return;
+	}
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	memcpy(pubkey, pubkey64, 64);
+	for (i = 0; i < 4; i++) {
+		__atomic_store_n(&slot->tag[i], tag[i], __ATOMIC_RELAXED);
+	}
+	for (i = 0; i < 8; i++) {
+		__atomic_store_n(&slot->pubkey[i], pubkey[i], __ATOMIC_RELAXED);
+	}
+	__atomic_store_n(&slot->seq, seq + 2, __ATOMIC_RELEASE);
+	if (seq != 0) {
+		__atomic_fetch_add(&shard->evictions, 1, __ATOMIC_RELAXED);
+	}
+}
+
+// secp256k1_ext_ecdsa_recover_cached is secp256k1_ext_ecdsa_recover with a lookup in
+// the given cache first. Successful recoveries are added to the cache. It is safe to
+// call concurrently with the same cache.
+//
+// Returns: 1: recovery was successful
+//          0: recovery was not successful
+// Args:    ctx:        pointer to a context object (cannot be NULL)
+//          cache:      the cache to use, or NULL to always recover
+//  Out:    pubkey_out: the serialized 65-byte public key of the signer (cannot be NULL)
+//  In:     sigdata:    pointer to a 65-byte signature with the recovery id at the end (cannot be NULL)
+//          msgdata:    pointer to a 32-byte message (cannot be NULL)
+static int secp256k1_ext_ecdsa_recover_cached(
+	const secp256k1_context* ctx,
+	secp256k1_ext_sigcache *cache,
+	unsigned char *pubkey_out,
+	const unsigned char *sigdata,
+	const unsigned char *msgdata
+) {
+	uint64_t begin = secp256k1_ext_latency_begin();
+	secp256k1_sha256_t hasher;
+	secp256k1_ext_sigcache_shard *shard;
+	unsigned char hash[32];
+	uint64_t tag[4];
+	int ret;
+
+	if (cache == NULL) {
+		ret = secp256k1_ext_ecdsa_recover(ctx, pubkey_out, sigdata, msgdata);
+		secp256k1_ext_latency_end(SECP256K1_EXT_OP_RECOVER, begin);
+		return ret;
+	}
+	secp256k1_sha256_initialize(&hasher);
+	secp256k1_sha256_write(&hasher, cache->salt, 32);
+	secp256k1_sha256_write(&hasher, msgdata, 32);
+	secp256k1_sha256_write(&hasher, sigdata, 65);
+	secp256k1_sha256_finalize(&hasher, hash);
+	memcpy(tag, hash, 32);
+
+	shard = &cache->shards[tag[0] % SECP256K1_EXT_SIGCACHE_SHARDS];
+	if (secp256k1_ext_sigcache_get(shard, tag, pubkey_out + 1)) {
+		__atomic_fetch_add(&shard->hits, 1, __ATOMIC_RELAXED);
+		pubkey_out[0] = 0x04;
+		ret = 1;
+	} else {
+		__atomic_fetch_add(&shard->misses, 1, __ATOMIC_RELAXED);
+		ret = secp256k1_ext_ecdsa_recover(ctx, pubkey_out, sigdata, msgdata);
+		if (ret) {
+			secp256k1_ext_sigcache_put(shard, tag, pubkey_out + 1);
+		}
+	}
+	secp256k1_ext_latency_end(SECP256K1_EXT_OP_RECOVER, begin);
+	return ret;
+}
+
+// secp256k1_ext_ecdsa_recover_check checks that recovering an encoded compact
+// signature yields the expected public key. It is cheaper than recovering and
+// comparing, as it needs neither a square root nor, unless the signature matches,
+// a field inversion.
+//
+// Returns: 1: the signature recovers to the expected public key
+//          0: it does not, or the input is invalid
+// Args:    ctx:          pointer to a context object (cannot be NULL)
+//  In:     sigdata:      pointer to a 65-byte signature with the recovery id at the end (cannot be NULL)
+//          msgdata:      pointer to a 32-byte message (cannot be NULL)
+//          pubkeydata:   pointer to the expected public key,
+//                        encoded as two 256bit big-endian numbers (cannot be NULL)
+static int secp256k1_ext_ecdsa_recover_check(
+	const secp256k1_context* ctx,
+	const unsigned char *sigdata,
+	const unsigned char *msgdata,
+	const unsigned char *pubkeydata
+) {
+	uint64_t begin = secp256k1_ext_latency_begin();
+	secp256k1_ecdsa_recoverable_signature sig;
+	secp256k1_scalar r, s, m;
+	secp256k1_fe x, y;
+	secp256k1_ge q;
+	int recid, ret;
+
+	ARG_CHECK(secp256k1_ecmult_context_is_built(&ctx->ecmult_ctx));
+	ret = secp256k1_ecdsa_recoverable_signature_parse_compact(ctx, &sig, sigdata, (int)sigdata[64]) &&
+		secp256k1_fe_set_b32(&x, pubkeydata) && secp256k1_fe_set_b32(&y, pubkeydata+32);
+	if (ret) {
+		secp256k1_ecdsa_recoverable_signature_load(ctx, &r, &s, &recid, &sig);
+		secp256k1_ge_set_xy(&q, &x, &y);
+		secp256k1_scalar_set_b32(&m, msgdata, NULL);
+		ret = secp256k1_ge_is_valid_var(&q) &&
+			secp256k1_ecdsa_sig_recover_check(&ctx->ecmult_ctx, &r, &s, &q, &m, recid);
+	}
+	secp256k1_ext_latency_end(SECP256K1_EXT_OP_RECOVER_CHECK, begin);
+	return ret;
+}
+
 // secp256k1_ext_ecdsa_verify verifies an encoded compact signature.
 //
 // Returns: 1: signature is valid
@@ -50,16 +441,236 @@ static int secp256k1_ext_ecdsa_verify(
 	const unsigned char *pubkeydata,
 	size_t pubkeylen
 ) {
+	uint64_t begin = secp256k1_ext_latency_begin();
 	secp256k1_ecdsa_signature sig;
 	secp256k1_pubkey pubkey;
+	int ret;
 
-	if (!secp256k1_ecdsa_signature_parse_compact(ctx, &sig, sigdata)) {
-		return 0;
+	ret = secp256k1_ecdsa_signature_parse_compact(ctx, &sig, sigdata) &&
+		secp256k1_ec_pubkey_parse(ctx, &pubkey, pubkeydata, pubkeylen) &&
+		secp256k1_ecdsa_verify(ctx, &sig, msgdata, &pubkey);
+	secp256k1_ext_latency_end(SECP256K1_EXT_OP_VERIFY, begin);
+	return ret;
+}
+
+// secp256k1_ext_blinding holds the blinding values of secp256k1_ecmult_gen for
+// signing with a shared context, so that they can be renewed while other threads
+// keep signing.
+//
+// There are two slots of blinding values. Signers copy the active one under its
+// sequence number, like the sigcache does, and never block. A refresh derives new
+// values from the active slot on a private copy, writes them into the other slot
+// and then flips the active index. Only one refresh runs at a time; a concurrent
+// one is skipped.
+#define SECP256K1_EXT_BLINDING_WORDS ((sizeof(secp256k1_gej) + sizeof(secp256k1_scalar) + 7) / 8)
+
+typedef struct {
+	uint64_t seq; // odd: being written
+	uint64_t words[SECP256K1_EXT_BLINDING_WORDS]; // initial || blind
+} secp256k1_ext_blinding_slot;
+
+// Every signature increments signs, so it gets a cache line of its own instead of
+// invalidating the slots and the active index that signers read. The state is placed
+// on a 64-byte boundary inside a larger malloc'd block, whose start is kept in mem.
+typedef struct {
+	secp256k1_ext_blinding_slot slots[2];
+	uint64_t active;   // index of the slot signers use
+	uint64_t interval; // refresh after this many signatures, 0: never
+	uint64_t signs __attribute__((aligned(64))); // signatures made with this state
+	unsigned char pad[64 - sizeof(uint64_t)];
+	uint64_t refreshes;
+	int busy;          // set while a refresh runs, guards rng
+	secp256k1_rfc6979_hmac_sha256_t rng;
+	void *mem;
+} secp256k1_ext_blinding;
+
+static void secp256k1_ext_blinding_load(secp256k1_ext_blinding *b, secp256k1_ecmult_gen_context *gen) {
+	uint64_t words[SECP256K1_EXT_BLINDING_WORDS];
+	unsigned char *bytes = (unsigned char*)words;
+	int i;
+
+	for (;;) {
+		secp256k1_ext_blinding_slot *slot = &b->slots[__atomic_load_n(&b->active, __ATOMIC_ACQUIRE)];
+		uint64_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+		if (seq & 1) {
+			continue;
+		}
+		for (i = 0; i < (int)SECP256K1_EXT_BLINDING_WORDS; i++) {
+			words[i] = __atomic_load_n(&slot->words[i], __ATOMIC_RELAXED);
+		}
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) == seq) {
+			break;
+		}
 	}
-	if (!secp256k1_ec_pubkey_parse(ctx, &pubkey, pubkeydata, pubkeylen)) {
+	memcpy(&gen->initial, bytes, sizeof(secp256k1_gej));
+	memcpy(&gen->blind, bytes + sizeof(secp256k1_gej), sizeof(secp256k1_scalar));
+	memset(words, 0, sizeof(words));
+}
+
+static void secp256k1_ext_blinding_store(secp256k1_ext_blinding_slot *slot, const secp256k1_ecmult_gen_context *gen) {
+	uint64_t words[SECP256K1_EXT_BLINDING_WORDS];
+	unsigned char *bytes = (unsigned char*)words;
+	uint64_t seq = __atomic_load_n(&slot->seq, __ATOMIC_RELAXED);
+	int i;
+
+	memset(words, 0, sizeof(words));
+	memcpy(bytes, &gen->initial, sizeof(secp256k1_gej));
+	memcpy(bytes + sizeof(secp256k1_gej), &gen->blind, sizeof(secp256k1_scalar));
+	__atomic_store_n(&slot->seq, seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	for (i = 0; i < (int)SECP256K1_EXT_BLINDING_WORDS; i++) {
+		__atomic_store_n(&slot->words[i], words[i], __ATOMIC_RELAXED);
+	}
+	__atomic_store_n(&slot->seq, seq + 2, __ATOMIC_RELEASE);
+	memset(words, 0, sizeof(words));
+}
+
+// secp256k1_ext_blinding_refresh renews the blinding values. Instead of blinding from
+// scratch, it moves the current ones by a random t, using initial + t*G = -(blind - t)*G,
+// and randomizes the projection of the new initial point. That is one secp256k1_ecmult_gen
+// and two outputs of an RNG kept across refreshes. The RNG is reseeded with seed32
+// if it is not NULL.
+//
+// Returns: 1: the values were renewed
+//          0: another refresh was running
+static int secp256k1_ext_blinding_refresh(const secp256k1_context* ctx, secp256k1_ext_blinding *b, const unsigned char *seed32) {
+	secp256k1_ecmult_gen_context gen = ctx->ecmult_gen_ctx;
+	unsigned char nonce32[32];
+	secp256k1_scalar t;
+	secp256k1_gej tg;
+	secp256k1_ge tga;
+	secp256k1_gep initial;
+	secp256k1_fe s;
+	uint64_t active;
+	int overflow;
+
+	if (__atomic_exchange_n(&b->busy, 1, __ATOMIC_ACQUIRE)) {
 		return 0;
 	}
-	return secp256k1_ecdsa_verify(ctx, &sig, msgdata, &pubkey);
+	if (seed32 != NULL) {
+		unsigned char keydata[64];
+		secp256k1_rfc6979_hmac_sha256_generate(&b->rng, keydata, 32);
+		memcpy(keydata + 32, seed32, 32);
+		secp256k1_rfc6979_hmac_sha256_initialize(&b->rng, keydata, 64);
+		memset(keydata, 0, sizeof(keydata));
+	}
+	active = __atomic_load_n(&b->active, __ATOMIC_RELAXED);
+	secp256k1_ext_blinding_load(b, &gen);
+	do {
+		secp256k1_rfc6979_hmac_sha256_generate(&b->rng, nonce32, 32);
+		secp256k1_scalar_set_b32(&t, nonce32, &overflow);
+	} while (overflow || secp256k1_scalar_is_zero(&t));
+	do {
+		secp256k1_rfc6979_hmac_sha256_generate(&b->rng, nonce32, 32);
+	} while (!secp256k1_fe_set_b32(&s, nonce32) || secp256k1_fe_is_zero(&s));
+
+	// Both points are secret, so add them with the complete constant time formula.
+	secp256k1_ecmult_gen(&gen, &tg, &t);
+	secp256k1_ge_set_gej(&tga, &tg);
+	secp256k1_gep_set_gej(&initial, &gen.initial);
+	secp256k1_gep_add_ge(&initial, &initial, &tga);
+	secp256k1_gej_set_gep(&gen.initial, &initial);
+	secp256k1_gej_rescale(&gen.initial, &s);
+	secp256k1_scalar_negate(&t, &t);
+	secp256k1_scalar_add(&gen.blind, &gen.blind, &t);
+	secp256k1_ext_blinding_store(&b->slots[active ^ 1], &gen);
+	__atomic_store_n(&b->active, active ^ 1, __ATOMIC_RELEASE);
+	__atomic_fetch_add(&b->refreshes, 1, __ATOMIC_RELAXED);
+	__atomic_store_n(&b->busy, 0, __ATOMIC_RELEASE);
+
+	memset(nonce32, 0, sizeof(nonce32));
+	secp256k1_scalar_clear(&t);
+	secp256k1_gej_clear(&tg);
+	secp256k1_ge_clear(&tga);
+	secp256k1_gep_clear(&initial);
+	secp256k1_fe_clear(&s);
+	secp256k1_scalar_clear(&gen.blind);
+	secp256k1_gej_clear(&gen.initial);
+	return 1;
+}
+
+// secp256k1_ext_blinding_create allocates a blinding state for ctx, which must be a
+// signing context, and draws its first values from seed32.
+//
+// Returns: the state, or NULL if allocation failed.
+static secp256k1_ext_blinding* secp256k1_ext_blinding_create(const secp256k1_context* ctx, const unsigned char *seed32) {
+	secp256k1_ext_blinding *b;
+	void *mem;
+
+	if ((mem = malloc(sizeof(*b) + 63)) == NULL) {
+		return NULL;
+	}
+	b = (secp256k1_ext_blinding*)(((uintptr_t)mem + 63) & ~(uintptr_t)63);
+	memset(b, 0, sizeof(*b));
+	b->mem = mem;
+	secp256k1_rfc6979_hmac_sha256_initialize(&b->rng, seed32, 32);
+	secp256k1_ext_blinding_store(&b->slots[0], &ctx->ecmult_gen_ctx);
+	secp256k1_ext_blinding_refresh(ctx, b, NULL);
+	return b;
+}
+
+// secp256k1_ext_blinding_set_interval makes secp256k1_ext_ecdsa_sign refresh the
+// blinding values after every n signatures. Zero disables refreshing.
+static void secp256k1_ext_blinding_set_interval(secp256k1_ext_blinding *b, uint64_t n) {
+	__atomic_store_n(&b->interval, n, __ATOMIC_RELAXED);
+}
+
+// secp256k1_ext_blinding_stats returns the number of signatures made and refreshes done.
+static void secp256k1_ext_blinding_stats(secp256k1_ext_blinding *b, uint64_t *signs, uint64_t *refreshes) {
+	*signs = __atomic_load_n(&b->signs, __ATOMIC_RELAXED);
+	*refreshes = __atomic_load_n(&b->refreshes, __ATOMIC_RELAXED);
+}
+
+// secp256k1_ext_ecdsa_sign creates a recoverable signature with the RFC6979 nonce
+// function and encodes it in compact form. It is safe to call concurrently, and with
+// refreshes of the blinding state.
+//
+// Returns: 1: signing was successful
+//          0: the secret key was invalid
+// Args:    ctx:        pointer to a context object (cannot be NULL)
+//          blinding:   blinding values to sign with, or NULL to use those of ctx
+//  Out:    sigdata:    pointer to a 65-byte buffer receiving the signature with the
+//                      recovery id at the end (cannot be NULL)
+//  In:     msgdata:    pointer to a 32-byte message (cannot be NULL)
+//          seckey:     pointer to a 32-byte secret key (cannot be NULL)
+static int secp256k1_ext_ecdsa_sign(
+	const secp256k1_context* ctx,
+	secp256k1_ext_blinding *blinding,
+	unsigned char *sigdata,
+	const unsigned char *msgdata,
+	const unsigned char *seckey
+) {
+	uint64_t begin = secp256k1_ext_latency_begin();
+	secp256k1_ecdsa_recoverable_signature sig;
+	secp256k1_context blinded;
+	int recid = 0;
+	int ret;
+
+	if (blinding == NULL) {
+		ret = secp256k1_ecdsa_sign_recoverable(ctx, &sig, msgdata, seckey, secp256k1_nonce_function_rfc6979, NULL);
+	} else {
+		// A shallow copy shares the tables of ctx and only replaces the blinding values.
+		blinded = *ctx;
+		secp256k1_ext_blinding_load(blinding, &blinded.ecmult_gen_ctx);
+		ret = secp256k1_ecdsa_sign_recoverable(&blinded, &sig, msgdata, seckey, secp256k1_nonce_function_rfc6979, NULL);
+		secp256k1_scalar_clear(&blinded.ecmult_gen_ctx.blind);
+		secp256k1_gej_clear(&blinded.ecmult_gen_ctx.initial);
+	}
+	if (ret) {
+		secp256k1_ecdsa_recoverable_signature_serialize_compact(ctx, sigdata, &recid, &sig);
+		sigdata[64] = (unsigned char)recid;
+	}
+	secp256k1_ext_latency_end(SECP256K1_EXT_OP_SIGN, begin);
+
+	if (blinding != NULL) {
+		uint64_t interval = __atomic_load_n(&blinding->interval, __ATOMIC_RELAXED);
+		uint64_t signs = __atomic_add_fetch(&blinding->signs, 1, __ATOMIC_RELAXED);
+		if (interval != 0 && signs % interval == 0) {
+			secp256k1_ext_blinding_refresh(ctx, blinding, NULL);
+		}
+	}
+	return ret;
 }
 
 // secp256k1_ext_reencode_pubkey decodes then encodes a public key. It can be used to
@@ -80,13 +691,17 @@ static int secp256k1_ext_reencode_pubkey(
 	const unsigned char *pubkeydata,
 	size_t pubkeylen
 ) {
+	uint64_t begin = secp256k1_ext_latency_begin();
 	secp256k1_pubkey pubkey;
+	int ret;
 
-	if (!secp256k1_ec_pubkey_parse(ctx, &pubkey, pubkeydata, pubkeylen)) {
-		return 0;
+	ret = secp256k1_ec_pubkey_parse(ctx, &pubkey, pubkeydata, pubkeylen);
+	if (ret) {
+		unsigned int flag = (outlen == 33) ? SECP256K1_EC_COMPRESSED : SECP256K1_EC_UNCOMPRESSED;
+		ret = secp256k1_ec_pubkey_serialize(ctx, out, &outlen, &pubkey, flag);
 	}
-	unsigned int flag = (outlen == 33) ? SECP256K1_EC_COMPRESSED : SECP256K1_EC_UNCOMPRESSED;
-	return secp256k1_ec_pubkey_serialize(ctx, out, &outlen, &pubkey, flag);
+	secp256k1_ext_latency_end(SECP256K1_EXT_OP_REENCODE, begin);
+	return ret;
 }
 
 // secp256k1_ext_scalar_mul multiplies a point by a scalar in constant time.
@@ -99,6 +714,7 @@ static int secp256k1_ext_reencode_pubkey(
 //                    encoded as two 256bit big-endian numbers.
 //          scalar:   a 32-byte scalar with which to multiply the point
 int secp256k1_ext_scalar_mul(const secp256k1_context* ctx, unsigned char *point, const unsigned char *scalar) {
+	uint64_t begin = secp256k1_ext_latency_begin();
 	int ret = 0;
 	int overflow = 0;
 	secp256k1_fe feX, feY;
@@ -126,5 +742,378 @@ int secp256k1_ext_scalar_mul(const secp256k1_context* ctx, unsigned char *point,
 		ret = 1;
 	}
 	secp256k1_scalar_clear(&s);
+	secp256k1_ext_latency_end(SECP256K1_EXT_OP_SCALAR_MUL, begin);
+	return ret;
+}
+
+// secp256k1_ext_scalar_mul_batch multiplies n points by n scalars in constant time,
+// like n calls of secp256k1_ext_scalar_mul. The products share their conversion to
+// affine coordinates in blocks of SECP256K1_ECDH_BATCH_SIZE, with the inverted value
+// blinded as in secp256k1_ecdh_batch. Unlike secp256k1_ext_scalar_mul, the points are
+// checked to be on the curve.
+//
+// Returns: 1: all multiplications were successful
+//          0: at least one point or scalar was invalid; the products for those are
+//             set to all zeros, all others are still computed
+// Args:    ctx:      pointer to a context object (cannot be NULL)
+//  Out:    points:   the n multiplied points (usually secret)
+//  In:     points:   pointer to n 64-byte public points, each encoded as two 256bit
+//                    big-endian numbers
+//          scalars:  pointer to n 32-byte scalars with which to multiply the points
+//          n:        the number of points
+static int secp256k1_ext_scalar_mul_batch(const secp256k1_context* ctx, unsigned char *points, const unsigned char *scalars, size_t n) {
+	secp256k1_rfc6979_hmac_sha256_t rng;
+	size_t i, j, len;
+	int ret = 1;
+	ARG_CHECK(points != NULL || n == 0);
+	ARG_CHECK(scalars != NULL || n == 0);
+
+	secp256k1_ecdh_batch_rng_init(&rng, scalars, n);
+	for (i = 0; i < n; i += len) {
+		secp256k1_ge pt[SECP256K1_ECDH_BATCH_SIZE];
+		int valid[SECP256K1_ECDH_BATCH_SIZE];
+
+		len = n - i < SECP256K1_ECDH_BATCH_SIZE ? n - i : SECP256K1_ECDH_BATCH_SIZE;
+		for (j = 0; j < len; j++) {
+			unsigned char *point = points + (i + j) * 64;
+			secp256k1_fe x, y;
+
+			valid[j] = secp256k1_fe_set_b32(&x, point) & secp256k1_fe_set_b32(&y, point + 32);
+			secp256k1_ge_set_xy(&pt[j], &x, &y);
+			valid[j] = valid[j] && secp256k1_ge_is_valid_var(&pt[j]);
+		}
+		secp256k1_ecdh_batch_ge(pt, valid, scalars + i * 32, len, &rng);
+		for (j = 0; j < len; j++) {
+			unsigned char *point = points + (i + j) * 64;
+			if (valid[j]) {
+				secp256k1_fe_normalize(&pt[j].x);
+				secp256k1_fe_normalize(&pt[j].y);
+				secp256k1_fe_get_b32(point, &pt[j].x);
+				secp256k1_fe_get_b32(point + 32, &pt[j].y);
+			} else {
+				memset(point, 0, 64);
+				ret = 0;
+			}
+		}
+		memset(pt, 0, sizeof(pt));
+	}
+	secp256k1_rfc6979_hmac_sha256_finalize(&rng);
+	(void)ctx;
 	return ret;
 }
+
+// secp256k1_ext_table_create builds a precomputed multiplication table for a public
+// key, blinded with seed32. See secp256k1_ecdh_table_create.
+//
+// Returns: the table, or NULL if the public key is invalid
+// Args:    ctx:        pointer to a context object (cannot be NULL)
+//  In:     pubkeydata: the public key, 33 or 65 bytes (cannot be NULL)
+//          pubkeylen:  length of pubkeydata
+//          seed32:     32 bytes of secret randomness (cannot be NULL)
+static secp256k1_ecdh_table* secp256k1_ext_table_create(const secp256k1_context* ctx, const unsigned char *pubkeydata, size_t pubkeylen, const unsigned char *seed32) {
+	secp256k1_pubkey pubkey;
+
+	if (!secp256k1_ec_pubkey_parse(ctx, &pubkey, pubkeydata, pubkeylen)) {
+		return NULL;
+	}
+	return secp256k1_ecdh_table_create(ctx, &pubkey, seed32);
+}
+
+// secp256k1_ext_table_scalar_mul multiplies the point of a table by a scalar in
+// constant time. The output is the same as secp256k1_ext_scalar_mul gives for that
+// point.
+//
+// Returns: 1: multiplication was successful
+//          0: scalar was invalid (zero or overflow)
+// Args:    ctx:      pointer to a context object (cannot be NULL)
+//  Out:    point:    pointer to 64 bytes receiving the product (usually secret),
+//                    encoded as two 256bit big-endian numbers
+//  In:     table:    a table created by secp256k1_ext_table_create (cannot be NULL)
+//          scalar:   a 32-byte scalar with which to multiply the point
+static int secp256k1_ext_table_scalar_mul(const secp256k1_context* ctx, unsigned char *point, const secp256k1_ecdh_table *table, const unsigned char *scalar) {
+	uint64_t begin = secp256k1_ext_latency_begin();
+	secp256k1_scalar s;
+	secp256k1_ge ge;
+	int overflow = 0;
+	int ret = 0;
+	ARG_CHECK(point != NULL);
+	ARG_CHECK(table != NULL);
+	ARG_CHECK(scalar != NULL);
+
+	secp256k1_scalar_set_b32(&s, scalar, &overflow);
+	if (!overflow && !secp256k1_scalar_is_zero(&s)) {
+		secp256k1_ecdh_table_mul(table, &ge, &s);
+		secp256k1_fe_normalize(&ge.x);
+		secp256k1_fe_normalize(&ge.y);
+		secp256k1_fe_get_b32(point, &ge.x);
+		secp256k1_fe_get_b32(point+32, &ge.y);
+		secp256k1_ge_clear(&ge);
+		ret = 1;
+	}
+	secp256k1_scalar_clear(&s);
+	secp256k1_ext_latency_end(SECP256K1_EXT_OP_SCALAR_MUL, begin);
+	return ret;
+}
+
+// SECP256K1_EXT_BULK_BLOCK is the number of public keys that secp256k1_ext_bulk_keygen
+// converts to affine coordinates with a single field inversion.
+#define SECP256K1_EXT_BULK_BLOCK 256
+
+// secp256k1_ext_bulk_keygen derives the n private keys start, start+step, start+2*step, ...
+// and their public keys.
+//
+// THIS IS NOT FOR PRODUCTION KEYS. All keys are trivially related to each other, and
+// the public keys are computed in variable time from the previous one. It exists to
+// create large numbers of throwaway accounts, e.g. for load tests.
+//
+// Only the first key is multiplied out; every further public key is the previous one
+// plus step*G, and blocks of keys share one inversion to become affine.
+//
+// Returns: 1: all keys were derived
+//          0: start or step is invalid (zero or overflow), or a key in the range is zero
+// Args:    ctx:      pointer to a context object with signing support (cannot be NULL)
+//  Out:    seckeys:  pointer to n*32 bytes receiving the private keys (cannot be NULL)
+//          pubkeys:  pointer to n*64 bytes receiving the public keys,
+//                    encoded as two 256bit big-endian numbers (cannot be NULL)
+//  In:     start:    pointer to the 32-byte first private key (cannot be NULL)
+//          step:     pointer to the 32-byte difference between keys (cannot be NULL)
+//          n:        the number of keys to derive
+static int secp256k1_ext_bulk_keygen(
+	const secp256k1_context* ctx,
+	unsigned char *seckeys,
+	unsigned char *pubkeys,
+	const unsigned char *start,
+	const unsigned char *step,
+	size_t n
+) {
+	secp256k1_gej block[SECP256K1_EXT_BULK_BLOCK];
+	secp256k1_fe zs[SECP256K1_EXT_BULK_BLOCK], zinvs[SECP256K1_EXT_BULK_BLOCK];
+	secp256k1_scalar k, d;
+	secp256k1_gej pj;
+	secp256k1_ge s, p;
+	size_t i, j, len;
+	int overflow;
+
+	ARG_CHECK(secp256k1_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx));
+	secp256k1_scalar_set_b32(&k, start, &overflow);
+	if (overflow || secp256k1_scalar_is_zero(&k)) {
+		return 0;
+	}
+	secp256k1_scalar_set_b32(&d, step, &overflow);
+	if (overflow || secp256k1_scalar_is_zero(&d)) {
+		return 0;
+	}
+	secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &pj, &k);
+	secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &block[0], &d);
+	secp256k1_ge_set_gej_var(&s, &block[0]);
+
+	for (i = 0; i < n; i += len) {
+		len = n - i < SECP256K1_EXT_BULK_BLOCK ? n - i : SECP256K1_EXT_BULK_BLOCK;
+		for (j = 0; j < len; j++) {
+			if (secp256k1_scalar_is_zero(&k)) {
+				return 0;
+			}
+			secp256k1_scalar_get_b32(seckeys + (i + j) * 32, &k);
+			block[j] = pj;
+			zs[j] = pj.z;
+			secp256k1_gej_add_ge_var(&pj, &pj, &s, NULL);
+			secp256k1_scalar_add(&k, &k, &d);
+		}
+		secp256k1_fe_inv_all_var(zinvs, zs, len);
+		for (j = 0; j < len; j++) {
+			unsigned char *out = pubkeys + (i + j) * 64;
+			secp256k1_ge_set_gej_zinv(&p, &block[j], &zinvs[j]);
+			secp256k1_fe_normalize_var(&p.x);
+			secp256k1_fe_normalize_var(&p.y);
+			secp256k1_fe_get_b32(out, &p.x);
+			secp256k1_fe_get_b32(out + 32, &p.y);
+		}
+	}
+	return 1;
+}
+
+// SECP256K1_EXT_BIP32_BLOCK is the number of child public keys that
+// secp256k1_ext_bip32_derive converts to affine coordinates with one field inversion.
+#define SECP256K1_EXT_BIP32_BLOCK 64
+
+// secp256k1_ext_bip32_derive derives the BIP32 children first, first+1, ...,
+// first+count-1 of an extended key. Indices of 2^31 and above are hardened.
+//
+// The HMAC-SHA512 state keyed with the chain code is set up once, and each child costs
+// one HMAC, one multiplication with the generator and, for a public parent, one point
+// addition. The child public keys share their conversion to affine coordinates. For a
+// private parent the shared product is multiplied by a secret blinding factor before
+// the variable time inversion, so the conversion does not leak the child keys.
+//
+// A child is invalid with probability below 2^-127. BIP32 says to skip such an index:
+// valid[i] is then set to 0 and the outputs of child first+i are zeroed, while the
+// other children are still derived.
+//
+// Returns: 1: the children were derived; check valid for the ones to skip
+//          0: the parent key is invalid, a hardened child of a public parent was
+//             requested, or the index range overflows
+// Args:    ctx:           pointer to a context object with signing support (cannot be NULL)
+//  Out:    seckeys:       pointer to count*32 bytes receiving the child private keys;
+//                         only used (and then cannot be NULL) for a private parent
+//          pubkeys:       pointer to count*65 bytes receiving the uncompressed child
+//                         public keys (cannot be NULL)
+//          chaincodes:    pointer to count*32 bytes receiving the child chain codes (cannot be NULL)
+//          valid:         pointer to count bytes, set to 1 for each valid child and 0 for
+//                         each invalid one (cannot be NULL)
+//  In:     parent:        the parent key: a 32-byte private key, or a 33- or 65-byte public key
+//          parentlen:     length of parent
+//          chaincode:     pointer to the 32-byte parent chain code (cannot be NULL)
+//          first:         index of the first child
+//          count:         number of children
+static int secp256k1_ext_bip32_derive(
+	const secp256k1_context* ctx,
+	unsigned char *seckeys,
+	unsigned char *pubkeys,
+	unsigned char *chaincodes,
+	unsigned char *valid,
+	const unsigned char *parent,
+	size_t parentlen,
+	const unsigned char *chaincode,
+	uint32_t first,
+	size_t count
+) {
+	secp256k1_gej block[SECP256K1_EXT_BIP32_BLOCK];
+	secp256k1_fe zs[SECP256K1_EXT_BIP32_BLOCK], zinvs[SECP256K1_EXT_BIP32_BLOCK];
+	secp256k1_hmac_sha512_t keyed;
+	secp256k1_rfc6979_hmac_sha256_t rng;
+	secp256k1_scalar k, tweak;
+	secp256k1_ge pk, p;
+	secp256k1_fe blind;
+	unsigned char parentser[33];
+	unsigned char data[37];
+	unsigned char out[64];
+	size_t i, j, len, serlen = 33;
+	int is_private = parentlen == 32;
+	int overflow;
+
+	ARG_CHECK(secp256k1_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx));
+	if (count == 0) {
+		return 1;
+	}
+	if ((uint64_t)first + count - 1 > 0xFFFFFFFFull) {
+		return 0;
+	}
+	if (is_private) {
+		secp256k1_gej pkj;
+		secp256k1_scalar_set_b32(&k, parent, &overflow);
+		if (overflow || secp256k1_scalar_is_zero(&k)) {
+			return 0;
+		}
+		secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &pkj, &k);
+		secp256k1_ge_set_gej(&pk, &pkj);
+
+		// The blinding factors are derived from the parent private key, so they are
+		// unpredictable to anyone who cannot already derive the children.
+		memcpy(data, parent, 32);
+		data[32] = first >> 24;
+		data[33] = first >> 16;
+		data[34] = first >> 8;
+		data[35] = first;
+		secp256k1_rfc6979_hmac_sha256_initialize(&rng, data, 36);
+	} else {
+		if (!secp256k1_eckey_pubkey_parse(&pk, parent, parentlen)) {
+			return 0;
+		}
+		if (first + count - 1 >= 0x80000000u) {
+			return 0;
+		}
+		secp256k1_scalar_set_int(&k, 0);
+	}
+	// The data hashed for a normal child starts with the compressed parent public key.
+	secp256k1_eckey_pubkey_serialize(&pk, parentser, &serlen, 1);
+	secp256k1_hmac_sha512_initialize(&keyed, chaincode, 32);
+
+	for (i = 0; i < count; i += len) {
+		len = count - i < SECP256K1_EXT_BIP32_BLOCK ? count - i : SECP256K1_EXT_BIP32_BLOCK;
+		for (j = 0; j < len; j++) {
+			uint32_t index = first + (uint32_t)(i + j);
+			secp256k1_hmac_sha512_t hmac = keyed;
+
+			if (index >= 0x80000000u) {
+				data[0] = 0;
+				secp256k1_scalar_get_b32(data + 1, &k);
+			} else {
+				memcpy(data, parentser, 33);
+			}
+			data[33] = index >> 24;
+			data[34] = index >> 16;
+			data[35] = index >> 8;
+			data[36] = index;
+			secp256k1_hmac_sha512_write(&hmac, data, sizeof(data));
+			secp256k1_hmac_sha512_finalize(&hmac, out);
+			memcpy(chaincodes + (i + j) * 32, out + 32, 32);
+
+			secp256k1_scalar_set_b32(&tweak, out, &overflow);
+			valid[i + j] = !overflow;
+			if (is_private) {
+				secp256k1_scalar_add(&tweak, &tweak, &k);
+				valid[i + j] &= !secp256k1_scalar_is_zero(&tweak);
+				if (!valid[i + j]) {
+					// Keep the block free of infinity; the result is discarded.
+					secp256k1_scalar_set_int(&tweak, 1);
+				}
+				secp256k1_scalar_get_b32(seckeys + (i + j) * 32, &tweak);
+				secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &block[j], &tweak);
+			} else {
+				secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &block[j], &tweak);
+				secp256k1_gej_add_ge_var(&block[j], &block[j], &pk, NULL);
+				if (secp256k1_gej_is_infinity(&block[j])) {
+					valid[i + j] = 0;
+				}
+				if (!valid[i + j]) {
+					secp256k1_gej_set_ge(&block[j], &secp256k1_ge_const_g);
+				}
+			}
+			zs[j] = block[j].z;
+		}
+		if (is_private) {
+			// Only the product of all z coordinates reaches the inversion, so blinding
+			// the first one blinds the inverted value.
+			int retry;
+			do {
+				secp256k1_rfc6979_hmac_sha256_generate(&rng, out, 32);
+				retry = !secp256k1_fe_set_b32(&blind, out);
+				retry |= secp256k1_fe_is_zero(&blind);
+			} while (retry); // Cryptographically unreachable.
+			secp256k1_fe_mul(&zs[0], &zs[0], &blind);
+			secp256k1_fe_inv_all_var(zinvs, zs, len);
+			secp256k1_fe_mul(&zinvs[0], &zinvs[0], &blind);
+		} else {
+			secp256k1_fe_inv_all_var(zinvs, zs, len);
+		}
+		for (j = 0; j < len; j++) {
+			unsigned char *pub = pubkeys + (i + j) * 65;
+			secp256k1_ge_set_gej_zinv(&p, &block[j], &zinvs[j]);
+			secp256k1_fe_normalize(&p.x);
+			secp256k1_fe_normalize(&p.y);
+			pub[0] = 0x04;
+			secp256k1_fe_get_b32(pub + 1, &p.x);
+			secp256k1_fe_get_b32(pub + 33, &p.y);
+			if (!valid[i + j]) {
+				memset(pub, 0, 65);
+				memset(chaincodes + (i + j) * 32, 0, 32);
+				if (is_private) {
+					memset(seckeys + (i + j) * 32, 0, 32);
+				}
+			}
+		}
+	}
+
+	if (is_private) {
+		secp256k1_rfc6979_hmac_sha256_finalize(&rng);
+		memset(&rng, 0, sizeof(rng));
+		secp256k1_fe_clear(&blind);
+		memset(zinvs, 0, sizeof(zinvs));
+	}
+	secp256k1_scalar_clear(&k);
+	secp256k1_scalar_clear(&tweak);
+	memset(data, 0, sizeof(data));
+	memset(out, 0, sizeof(out));
+	memset(&keyed, 0, sizeof(keyed));
+	return 1;
+}
@@ -0,0 +1,162 @@
+// Copyright 2020 The go-ethereum Authors
+// This file is part of the go-ethereum library.
+//
+// The go-ethereum library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// The go-ethereum library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with the go-ethereum library. If not, see <http://www.gnu.org/licenses/>.
+
+package secp256k1
+
+import (
+	"math"
+
+	"github.com/ethereum/go-ethereum/metrics"
+)
+
+// latencyBuckets is the number of buckets of the native latency histograms, see
+// SECP256K1_EXT_LATENCY_BUCKETS in ext.h.
+const latencyBuckets = 256
+
+// latencyBucketMin returns the smallest latency in nanoseconds that falls into
+// bucket b. Below 4 every value has its own bucket, above that each power of two
+// is split into 4 buckets of equal width.
+func latencyBucketMin(b int) float64 {
+	if b < 4 {
+		return float64(b)
+	}
+	return math.Ldexp(float64(4+b%4), b/4-1)
+}
+
+// latencyHistogram is a metrics.Histogram that reads the latencies of one native
+// operation. Updates happen in C, so Update and Clear are not supported.
+type latencyHistogram struct {
+	op int
+}
+
+func (h latencyHistogram) Clear()                             { panic("Clear called on a latencyHistogram") }
+func (h latencyHistogram) Update(int64)                       { panic("Update called on a latencyHistogram") }
+func (h latencyHistogram) Count() int64                       { return h.snapshot().Count() }
+func (h latencyHistogram) Max() int64                         { return h.snapshot().Max() }
+func (h latencyHistogram) Mean() float64                      { return h.snapshot().Mean() }
+func (h latencyHistogram) Min() int64                         { return h.snapshot().Min() }
+func (h latencyHistogram) Percentile(p float64) float64       { return h.snapshot().Percentile(p) }
+func (h latencyHistogram) Percentiles(ps []float64) []float64 { return h.snapshot().Percentiles(ps) }
+func (h latencyHistogram) Sample() metrics.Sample             { return metrics.NilSample{} }
+func (h latencyHistogram) Snapshot() metrics.Histogram        { return h.snapshot() }
+func (h latencyHistogram) StdDev() float64                    { return h.snapshot().StdDev() }
+func (h latencyHistogram) Sum() int64                         { return h.snapshot().Sum() }
+func (h latencyHistogram) Variance() float64                  { return h.snapshot().Variance() }
+
+func (h latencyHistogram) snapshot() *latencySnapshot { return readLatency(h.op) }
+
+// latencySnapshot is a read-only copy of a native latency histogram. Statistics
+// other than Count and Sum are estimated from the bucket bounds, taking the
+// middle of a bucket as the value of all its samples.
+type latencySnapshot struct {
+	buckets [latencyBuckets]uint64
+	sum     uint64
+}
+
+func (s *latencySnapshot) Clear()                      { panic("Clear called on a latencySnapshot") }
+func (s *latencySnapshot) Update(int64)                { panic("Update called on a latencySnapshot") }
+func (s *latencySnapshot) Sample() metrics.Sample      { return metrics.NilSample{} }
+func (s *latencySnapshot) Snapshot() metrics.Histogram { return s }
+func (s *latencySnapshot) Sum() int64                  { return int64(s.sum) }
+
+func (s *latencySnapshot) Count() int64 {
+	var n uint64
+	for _, c := range s.buckets {
+		n += c
+	}
+	return int64(n)
+}
+
+func (s *latencySnapshot) mid(b int) float64 {
+	return (latencyBucketMin(b) + latencyBucketMin(b+1) - 1) / 2
+}
+
+func (s *latencySnapshot) Min() int64 {
+	for b, c := range s.buckets {
+		if c != 0 {
+			return int64(latencyBucketMin(b))
+		}
+	}
+	return 0
+}
+
+func (s *latencySnapshot) Max() int64 {
+	for b := latencyBuckets - 1; b >= 0; b-- {
+		if s.buckets[b] != 0 {
+			return int64(latencyBucketMin(b+1) - 1)
+		}
+	}
+	return 0
+}
+
+func (s *latencySnapshot) Mean() float64 {
+	n := s.Count()
+	if n == 0 {
+		return 0
+	}
+	return float64(s.sum) / float64(n)
+}
+
+func (s *latencySnapshot) Variance() float64 {
+	n := s.Count()
+	if n == 0 {
+		return 0
+	}
+	var (
+		mean = s.Mean()
+		sum  float64
+	)
+	for b, c := range s.buckets {
+		if c != 0 {
+			d := s.mid(b) - mean
+			sum += float64(c) * d * d
+		}
+	}
+	return sum / float64(n)
+}
+
+func (s *latencySnapshot) StdDev() float64 { return math.Sqrt(s.Variance()) }
+
+func (s *latencySnapshot) Percentile(p float64) float64 {
+	return s.Percentiles([]float64{p})[0]
+}
+
+// Percentiles returns the middle of the bucket holding each requested percentile.
+func (s *latencySnapshot) Percentiles(ps []float64) []float64 {
+	var (
+		n      = s.Count()
+		scores = make([]float64, len(ps))
+	)
+	if n == 0 {
+		return scores
+	}
+	for i, p := range ps {
+		var (
+			rank = uint64(math.Ceil(p * float64(n)))
+			seen uint64
+		)
+		if rank == 0 {
+			rank = 1
+		}
+		for b, c := range s.buckets {
+			if seen += c; seen >= rank {
+				scores[i] = s.mid(b)
+				break
+			}
+		}
+	}
+	return scores
+}
@@ -555,6 +555,10 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_context_randomize(
 ) SECP256K1_ARG_NONNULL(1);
 
 /** Add a number of public keys together.
+ *
+ *  Large numbers of keys are summed as a tree of affine additions that share one
+ *  inversion per level, which is several times faster than adding them one by one.
+ *
  *  Returns: 1: the sum of the public keys is valid.
  *           0: the sum of the public keys is not valid.
  *  Args:   ctx:        pointer to a context object
@@ -570,6 +574,78 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ec_pubkey_combine(
     size_t n
 ) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
 
+/** Opaque data structure that holds the running sum of a set of public keys.
+ *
+ *  An aggregate is created from an initial set of keys, after which single keys can be
+ *  added or removed for the cost of one point addition each, instead of combining the
+ *  whole set again. It is not safe to update an aggregate from several threads at once.
+ */
+typedef struct secp256k1_ec_pubkey_aggregate_struct secp256k1_ec_pubkey_aggregate;
+
+/** Create an aggregate of a number of public keys.
+ *  Returns: a newly created aggregate, or NULL if one of the public keys is invalid
+ *  Args:   ctx:        pointer to a context object (cannot be NULL)
+ *  In:     ins:        pointer to array of pointers to public keys (can be NULL if n is 0)
+ *          n:          the number of public keys in the initial set (can be 0)
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT secp256k1_ec_pubkey_aggregate* secp256k1_ec_pubkey_aggregate_create(
+    const secp256k1_context* ctx,
+    const secp256k1_pubkey * const * ins,
+    size_t n
+) SECP256K1_ARG_NONNULL(1);
+
+/** Destroy an aggregate created by secp256k1_ec_pubkey_aggregate_create.
+ *  Args:   agg:        the aggregate to destroy (can be NULL)
+ */
+SECP256K1_API void secp256k1_ec_pubkey_aggregate_destroy(
+    secp256k1_ec_pubkey_aggregate* agg
+);
+
+/** Add a public key to an aggregate.
+ *  Returns: 1: the public key was added
+ *           0: the public key was invalid
+ *  Args:   ctx:        pointer to a context object (cannot be NULL)
+ *  In/Out: agg:        the aggregate to update (cannot be NULL)
+ *  In:     pubkey:     pointer to the public key to add (cannot be NULL)
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ec_pubkey_aggregate_add(
+    const secp256k1_context* ctx,
+    secp256k1_ec_pubkey_aggregate *agg,
+    const secp256k1_pubkey *pubkey
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
+
+/** Remove a public key from an aggregate.
+ *
+ *  The key is subtracted from the sum without checking that it was added before; removing
+ *  a key that is not in the set gives an aggregate of a different set.
+ *
+ *  Returns: 1: the public key was removed
+ *           0: the public key was invalid, or the aggregate is empty
+ *  Args:   ctx:        pointer to a context object (cannot be NULL)
+ *  In/Out: agg:        the aggregate to update (cannot be NULL)
+ *  In:     pubkey:     pointer to the public key to remove (cannot be NULL)
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ec_pubkey_aggregate_remove(
+    const secp256k1_context* ctx,
+    secp256k1_ec_pubkey_aggregate *agg,
+    const secp256k1_pubkey *pubkey
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
+
+/** Get the sum of the public keys in an aggregate.
+ *  Returns: 1: the sum of the public keys is valid.
+ *           0: the sum of the public keys is not valid (the set is empty, or the
+ *              keys add up to infinity).
+ *  Args:   ctx:        pointer to a context object (cannot be NULL)
+ *  Out:    out:        pointer to a public key object for placing the resulting public key
+ *                      (cannot be NULL)
+ *  In:     agg:        the aggregate (cannot be NULL)
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ec_pubkey_aggregate_get(
+    const secp256k1_context* ctx,
+    secp256k1_pubkey *out,
+    const secp256k1_ec_pubkey_aggregate *agg
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
+
 # ifdef __cplusplus
 }
 # endif
@@ -24,6 +24,83 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ecdh(
   const unsigned char *privkey
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
 
+/** Compute n EC Diffie-Hellman secrets in constant time.
+ *
+ *  The result for each (pubkey, privkey) pair is the same as secp256k1_ecdh would give,
+ *  but the conversion of the results to affine coordinates is shared between up to 32
+ *  pairs, which makes this faster than n separate calls.
+ *
+ *  Returns: 1: all scalars were valid
+ *           0: at least one scalar was invalid (zero or overflow) or public key was
+ *              uninitialized; the results for those are set to all zeros, all others
+ *              are still computed
+ *  Args:    ctx:        pointer to a context object (cannot be NULL)
+ *  Out:     results:    an array of n*32 bytes; the i'th 32 bytes receive the secret
+ *                       computed from the i'th public key and scalar
+ *  In:      pubkeys:    an array of n initialized public keys; an uninitialized one is
+ *                       an API misuse and calls the illegal callback, as in secp256k1_ecdh
+ *           privkeys:   an array of n*32 bytes holding n 32-byte scalars
+ *           n:          the number of secrets to compute
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ecdh_batch(
+  const secp256k1_context* ctx,
+  unsigned char *results,
+  const secp256k1_pubkey *pubkeys,
+  const unsigned char *privkeys,
+  size_t n
+) SECP256K1_ARG_NONNULL(1);
+
+/** Opaque data structure that holds a precomputed multiplication table for one public key.
+ *
+ *  A table takes 64 KiB and about as long to build as a few dozen ECDH computations. Once
+ *  built, computing ECDH secrets with that public key is several times faster and still
+ *  constant time. A table is read-only after creation and can be used from several threads.
+ */
+typedef struct secp256k1_ecdh_table_struct secp256k1_ecdh_table;
+
+/** Build a precomputed table for a public key.
+ *
+ *  The table is blinded against sidechannels like the generator table of a context
+ *  (see secp256k1_context_randomize). The seed is required: a blinding derived from the
+ *  public key alone would be known to an attacker and protect nothing.
+ *
+ *  Returns: a newly created table, or NULL if the public key is invalid
+ *  Args:    ctx:        pointer to a context object (cannot be NULL)
+ *  In:      pubkey:     a pointer to a secp256k1_pubkey containing an
+ *                       initialized public key
+ *           seed32:     32 bytes of secret randomness used to blind the table
+ *                       (cannot be NULL)
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT secp256k1_ecdh_table* secp256k1_ecdh_table_create(
+  const secp256k1_context* ctx,
+  const secp256k1_pubkey *pubkey,
+  const unsigned char *seed32
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
+
+/** Destroy a table created by secp256k1_ecdh_table_create.
+ *  Args:   table:  the table to destroy (can be NULL)
+ */
+SECP256K1_API void secp256k1_ecdh_table_destroy(
+  secp256k1_ecdh_table* table
+);
+
+/** Compute an EC Diffie-Hellman secret in constant time using a precomputed table.
+ *  The result is the same as secp256k1_ecdh gives for the table's public key.
+ *  Returns: 1: exponentiation was successful
+ *           0: scalar was invalid (zero or overflow)
+ *  Args:    ctx:        pointer to a context object (cannot be NULL)
+ *  Out:     result:     a 32-byte array which will be populated by an ECDH
+ *                       secret computed from the table's point and scalar
+ *  In:      table:      a table created by secp256k1_ecdh_table_create
+ *           privkey:    a 32-byte scalar with which to multiply the point
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ecdh_table_ecdh(
+  const secp256k1_context* ctx,
+  unsigned char *result,
+  const secp256k1_ecdh_table *table,
+  const unsigned char *privkey
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
+
 # ifdef __cplusplus
 }
 # endif
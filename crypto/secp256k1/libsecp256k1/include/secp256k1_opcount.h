@@ -0,0 +1,53 @@
+#ifndef _SECP256K1_OPCOUNT_
+# define _SECP256K1_OPCOUNT_
+
+# include <stdint.h>
+# include "secp256k1.h"
+
+# ifdef __cplusplus
+extern "C" {
+# endif
+
+/** Number of internal operations performed by the calling thread.
+ *
+ *  Only available when the library is built with SECP256K1_OPCOUNT defined
+ *  (configure --enable-opcount). Counts are inclusive: an inversion by
+ *  exponentiation, for example, also adds to fe_mul and fe_sqr. This is an
+ *  analysis aid; the counting makes the library slower and it should not be
+ *  used in production.
+ */
+typedef struct {
+    uint64_t fe_mul;
+    uint64_t fe_sqr;
+    uint64_t fe_inv;
+    uint64_t fe_inv_var;
+    uint64_t fe_sqrt;
+    uint64_t fe_is_quad_var;
+    uint64_t gej_double_var;
+    uint64_t gej_add_var;
+    uint64_t gej_add_ge;
+    uint64_t gej_add_ge_var;
+    uint64_t gej_add_zinv_var;
+    uint64_t gep_add_ge;
+    uint64_t scalar_inverse;
+    uint64_t scalar_inverse_var;
+    uint64_t ecmult;
+    uint64_t ecmult_gen;
+    uint64_t ecmult_const;
+} secp256k1_opcount;
+
+/** Copy the operation counts of the calling thread.
+ *  Out:     counts:     receives the counts accumulated since the last reset
+ */
+SECP256K1_API void secp256k1_opcount_snapshot(
+  secp256k1_opcount *counts
+) SECP256K1_ARG_NONNULL(1);
+
+/** Reset the operation counts of the calling thread to zero. */
+SECP256K1_API void secp256k1_opcount_reset(void);
+
+# ifdef __cplusplus
+}
+# endif
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef _SECP256K1_SCHNORR_
+# define _SECP256K1_SCHNORR_
+
+# include "secp256k1.h"
+
+# ifdef __cplusplus
+extern "C" {
+# endif
+
+/** This module implements BIP340 Schnorr signatures. A signature is 64 bytes: the x
+ *  coordinate of the nonce point R followed by the scalar s. Public keys are identified by
+ *  their x coordinate only; a secp256k1_pubkey with an odd y coordinate verifies the same
+ *  signatures as its negation.
+ */
+
+/** Create a BIP340 Schnorr signature.
+ *
+ *  Returns: 1: signature created
+ *           0: the secret key was invalid (zero or overflow), or the nonce generation
+ *              failed (cryptographically unreachable)
+ *  Args:    ctx:        pointer to a context object, initialized for signing (cannot be NULL)
+ *  Out:     sig64:      pointer to a 64-byte array where the signature will be placed (cannot be NULL)
+ *  In:      msg32:      the 32-byte message being signed (cannot be NULL)
+ *           seckey:     pointer to a 32-byte secret key (cannot be NULL)
+ *           aux_rand32: 32 bytes of fresh randomness, mixed into the nonce as a defense
+ *                       against sidechannels (can be NULL, which is treated as 32 zero bytes)
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_schnorr_sign(
+  const secp256k1_context* ctx,
+  unsigned char *sig64,
+  const unsigned char *msg32,
+  const unsigned char *seckey,
+  const unsigned char *aux_rand32
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
+
+/** Verify a BIP340 Schnorr signature.
+ *
+ *  Returns: 1: correct signature
+ *           0: incorrect signature
+ *  Args:    ctx:       a secp256k1 context object, initialized for verification.
+ *  In:      sig64:     the 64-byte signature being verified (cannot be NULL)
+ *           msg32:     the 32-byte message being verified (cannot be NULL)
+ *           pubkey:    pointer to the public key to verify with (cannot be NULL)
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_schnorr_verify(
+  const secp256k1_context* ctx,
+  const unsigned char *sig64,
+  const unsigned char *msg32,
+  const secp256k1_pubkey *pubkey
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
+
+/** Verify n BIP340 Schnorr signatures at once.
+ *
+ *  The signatures are checked together with random weights derived from all inputs, in
+ *  groups of 64 that each take one multi-scalar multiplication. This is faster than n calls
+ *  to secp256k1_schnorr_verify, but does not tell which signature is incorrect.
+ *
+ *  Returns: 1: all signatures are correct (or n is 0)
+ *           0: at least one signature is incorrect
+ *  Args:    ctx:       a secp256k1 context object, initialized for verification.
+ *  In:      sigs64:    an array of n pointers to 64-byte signatures
+ *           msgs32:    an array of n pointers to the 32-byte messages
+ *           pubkeys:   an array of n pointers to the public keys
+ *           n:         the number of signatures to verify
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_schnorr_verify_batch(
+  const secp256k1_context* ctx,
+  const unsigned char * const *sigs64,
+  const unsigned char * const *msgs32,
+  const secp256k1_pubkey * const *pubkeys,
+  size_t n
+) SECP256K1_ARG_NONNULL(1);
+
+# ifdef __cplusplus
+}
+# endif
+
+#endif
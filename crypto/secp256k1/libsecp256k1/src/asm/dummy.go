@@ -0,0 +1,7 @@
+// +build dummy
+
+// Package asm contains only assembly files.
+//
+// This Go file is part of a workaround for `go mod vendor`.
+// Please see the file crypto/secp256k1/dummy.go for more information.
+package asm
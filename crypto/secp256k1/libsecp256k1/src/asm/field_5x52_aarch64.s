@@ -0,0 +1,289 @@
+// vim: set tabstop=8 softtabstop=8 shiftwidth=8 noexpandtab syntax=armasm:
+/**********************************************************************
+ * Copyright (c) 2020 The libsecp256k1 developers                     *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+/*
+AArch64 implementation of field_5x52 inner loops.
+
+Note:
+
+- This follows field_5x52_int128_impl.h step by step, with every 128-bit
+  accumulator held in a lo:hi register pair and every 64x64->128 product
+  formed by a MUL/UMULH pair. The outputs are bit-identical to the C code.
+
+- The limb masks M = 2^52-1 and M >> 4 are encodable as logical immediates,
+  so only R = 0x1000003D10 lives in a register.
+
+*/
+
+	.arch	armv8-a
+	.text
+
+	// (hi:lo) += x * y, using x16 and x17 as scratch
+	.macro	mulacc	lo, hi, x, y
+	mul	x16, \x, \y
+	umulh	x17, \x, \y
+	adds	\lo, \lo, x16
+	adc	\hi, \hi, x17
+	.endm
+
+	// (hi:lo) = x * y
+	.macro	mulset	lo, hi, x, y
+	mul	\lo, \x, \y
+	umulh	\hi, \x, \y
+	.endm
+
+	// (hi:lo) >>= 52
+	.macro	shr52	lo, hi
+	extr	\lo, \hi, \lo, #52
+	lsr	\hi, \hi, #52
+	.endm
+
+	.align	2
+	.global	secp256k1_fe_mul_inner
+	.type	secp256k1_fe_mul_inner, %function
+	// Arguments:
+	//  x0  r      Restrict: can overlap with a, not with b
+	//  x1  a
+	//  x2  b
+	// Allocation:
+	//  x1:x2    d (after a and b are loaded)
+	//  x3-x7    a0-a4
+	//  x8-x12   b0-b4
+	//  x13:x14  c
+	//  x15      t3
+	//  x16,x17  scratch
+	//  x19      R
+	//  x20      t4
+	//  x21,x22  tx / u0 / scratch
+secp256k1_fe_mul_inner:
+	stp	x19, x20, [sp, #-32]!
+	stp	x21, x22, [sp, #16]
+
+	ldp	x3, x4, [x1]
+	ldp	x5, x6, [x1, #16]
+	ldr	x7, [x1, #32]
+	ldp	x8, x9, [x2]
+	ldp	x10, x11, [x2, #16]
+	ldr	x12, [x2, #32]
+	mov	x19, #0x3d10
+	movk	x19, #0x10, lsl #32		// R = 0x1000003D10
+
+	// d = a0*b3 + a1*b2 + a2*b1 + a3*b0
+	mulset	x1, x2, x3, x11
+	mulacc	x1, x2, x4, x10
+	mulacc	x1, x2, x5, x9
+	mulacc	x1, x2, x6, x8
+	// c = a4*b4
+	mulset	x13, x14, x7, x12
+	// d += (c & M) * R; c >>= 52
+	and	x21, x13, #0xfffffffffffff
+	mulacc	x1, x2, x21, x19
+	shr52	x13, x14
+	// t3 = d & M; d >>= 52
+	and	x15, x1, #0xfffffffffffff
+	shr52	x1, x2
+
+	// d += a0*b4 + a1*b3 + a2*b2 + a3*b1 + a4*b0
+	mulacc	x1, x2, x3, x12
+	mulacc	x1, x2, x4, x11
+	mulacc	x1, x2, x5, x10
+	mulacc	x1, x2, x6, x9
+	mulacc	x1, x2, x7, x8
+	// d += c * R
+	mulacc	x1, x2, x13, x19
+	// t4 = d & M; d >>= 52
+	and	x20, x1, #0xfffffffffffff
+	shr52	x1, x2
+	// tx = t4 >> 48; t4 &= (M >> 4)
+	lsr	x21, x20, #48
+	and	x20, x20, #0xffffffffffff
+
+	// c = a0*b0
+	mulset	x13, x14, x3, x8
+	// d += a1*b4 + a2*b3 + a3*b2 + a4*b1
+	mulacc	x1, x2, x4, x12
+	mulacc	x1, x2, x5, x11
+	mulacc	x1, x2, x6, x10
+	mulacc	x1, x2, x7, x9
+	// u0 = d & M; d >>= 52; u0 = (u0 << 4) | tx
+	and	x22, x1, #0xfffffffffffff
+	shr52	x1, x2
+	orr	x21, x21, x22, lsl #4
+	// c += u0 * (R >> 4)
+	lsr	x22, x19, #4
+	mulacc	x13, x14, x21, x22
+	// r[0] = c & M; c >>= 52
+	and	x22, x13, #0xfffffffffffff
+	str	x22, [x0]
+	shr52	x13, x14
+
+	// c += a0*b1 + a1*b0
+	mulacc	x13, x14, x3, x9
+	mulacc	x13, x14, x4, x8
+	// d += a2*b4 + a3*b3 + a4*b2
+	mulacc	x1, x2, x5, x12
+	mulacc	x1, x2, x6, x11
+	mulacc	x1, x2, x7, x10
+	// c += (d & M) * R; d >>= 52
+	and	x21, x1, #0xfffffffffffff
+	mulacc	x13, x14, x21, x19
+	shr52	x1, x2
+	// r[1] = c & M; c >>= 52
+	and	x22, x13, #0xfffffffffffff
+	str	x22, [x0, #8]
+	shr52	x13, x14
+
+	// c += a0*b2 + a1*b1 + a2*b0
+	mulacc	x13, x14, x3, x10
+	mulacc	x13, x14, x4, x9
+	mulacc	x13, x14, x5, x8
+	// d += a3*b4 + a4*b3
+	mulacc	x1, x2, x6, x12
+	mulacc	x1, x2, x7, x11
+	// c += (d & M) * R; d >>= 52
+	and	x21, x1, #0xfffffffffffff
+	mulacc	x13, x14, x21, x19
+	shr52	x1, x2
+	// r[2] = c & M; c >>= 52
+	and	x22, x13, #0xfffffffffffff
+	str	x22, [x0, #16]
+	shr52	x13, x14
+
+	// c += d * R + t3
+	mulacc	x13, x14, x1, x19
+	adds	x13, x13, x15
+	adc	x14, x14, xzr
+	// r[3] = c & M; c >>= 52
+	and	x22, x13, #0xfffffffffffff
+	str	x22, [x0, #24]
+	extr	x13, x14, x13, #52
+	// r[4] = c + t4
+	add	x13, x13, x20
+	str	x13, [x0, #32]
+
+	ldp	x21, x22, [sp, #16]
+	ldp	x19, x20, [sp], #32
+	ret
+	.size	secp256k1_fe_mul_inner, .-secp256k1_fe_mul_inner
+
+	.align	2
+	.global	secp256k1_fe_sqr_inner
+	.type	secp256k1_fe_sqr_inner, %function
+	// Arguments:
+	//  x0  r      Can overlap with a
+	//  x1  a
+	// Allocation:
+	//  x1:x2    d (after a is loaded)
+	//  x3-x7    a0-a4
+	//  x8-x11   a0*2, a1*2, a2*2, a4*2
+	//  x13:x14  c
+	//  x15      t3
+	//  x16,x17  scratch
+	//  x19      R
+	//  x20      t4
+	//  x21,x22  tx / u0 / scratch
+secp256k1_fe_sqr_inner:
+	stp	x19, x20, [sp, #-32]!
+	stp	x21, x22, [sp, #16]
+
+	ldp	x3, x4, [x1]
+	ldp	x5, x6, [x1, #16]
+	ldr	x7, [x1, #32]
+	mov	x19, #0x3d10
+	movk	x19, #0x10, lsl #32		// R = 0x1000003D10
+	lsl	x8, x3, #1			// a0*2
+	lsl	x9, x4, #1			// a1*2
+	lsl	x10, x5, #1			// a2*2
+
+	// d = (a0*2)*a3 + (a1*2)*a2
+	mulset	x1, x2, x8, x6
+	mulacc	x1, x2, x9, x5
+	// c = a4*a4
+	mulset	x13, x14, x7, x7
+	// d += (c & M) * R; c >>= 52
+	and	x21, x13, #0xfffffffffffff
+	mulacc	x1, x2, x21, x19
+	shr52	x13, x14
+	// t3 = d & M; d >>= 52
+	and	x15, x1, #0xfffffffffffff
+	shr52	x1, x2
+
+	// a4 *= 2
+	lsl	x11, x7, #1
+	// d += a0*a4 + (a1*2)*a3 + a2*a2
+	mulacc	x1, x2, x3, x11
+	mulacc	x1, x2, x9, x6
+	mulacc	x1, x2, x5, x5
+	// d += c * R
+	mulacc	x1, x2, x13, x19
+	// t4 = d & M; d >>= 52
+	and	x20, x1, #0xfffffffffffff
+	shr52	x1, x2
+	// tx = t4 >> 48; t4 &= (M >> 4)
+	lsr	x21, x20, #48
+	and	x20, x20, #0xffffffffffff
+
+	// c = a0*a0
+	mulset	x13, x14, x3, x3
+	// d += a1*a4 + (a2*2)*a3
+	mulacc	x1, x2, x4, x11
+	mulacc	x1, x2, x10, x6
+	// u0 = d & M; d >>= 52; u0 = (u0 << 4) | tx
+	and	x22, x1, #0xfffffffffffff
+	shr52	x1, x2
+	orr	x21, x21, x22, lsl #4
+	// c += u0 * (R >> 4)
+	lsr	x22, x19, #4
+	mulacc	x13, x14, x21, x22
+	// r[0] = c & M; c >>= 52
+	and	x22, x13, #0xfffffffffffff
+	str	x22, [x0]
+	shr52	x13, x14
+
+	// c += (a0*2)*a1
+	mulacc	x13, x14, x8, x4
+	// d += a2*a4 + a3*a3
+	mulacc	x1, x2, x5, x11
+	mulacc	x1, x2, x6, x6
+	// c += (d & M) * R; d >>= 52
+	and	x21, x1, #0xfffffffffffff
+	mulacc	x13, x14, x21, x19
+	shr52	x1, x2
+	// r[1] = c & M; c >>= 52
+	and	x22, x13, #0xfffffffffffff
+	str	x22, [x0, #8]
+	shr52	x13, x14
+
+	// c += (a0*2)*a2 + a1*a1
+	mulacc	x13, x14, x8, x5
+	mulacc	x13, x14, x4, x4
+	// d += a3*a4
+	mulacc	x1, x2, x6, x11
+	// c += (d & M) * R; d >>= 52
+	and	x21, x1, #0xfffffffffffff
+	mulacc	x13, x14, x21, x19
+	shr52	x1, x2
+	// r[2] = c & M; c >>= 52
+	and	x22, x13, #0xfffffffffffff
+	str	x22, [x0, #16]
+	shr52	x13, x14
+
+	// c += d * R + t3
+	mulacc	x13, x14, x1, x19
+	adds	x13, x13, x15
+	adc	x14, x14, xzr
+	// r[3] = c & M; c >>= 52
+	and	x22, x13, #0xfffffffffffff
+	str	x22, [x0, #24]
+	extr	x13, x14, x13, #52
+	// r[4] = c + t4
+	add	x13, x13, x20
+	str	x13, [x0, #32]
+
+	ldp	x21, x22, [sp, #16]
+	ldp	x19, x20, [sp], #32
+	ret
+	.size	secp256k1_fe_sqr_inner, .-secp256k1_fe_sqr_inner
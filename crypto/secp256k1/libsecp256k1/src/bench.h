@@ -8,13 +8,80 @@
 #define _SECP256K1_BENCH_H_
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
 #include "sys/time.h"
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+/* Every run of a benchmark is split into at most this many timed samples. */
+#define BENCH_MAX_BATCHES 100
+
+/* Environment variables:
+ *  SECP256K1_BENCH_JSON=<file>: append one JSON object per benchmark to <file>,
+ *                               including every sample (for bench_compare).
+ *  SECP256K1_BENCH_CPU=<n>:     pin to CPU n instead of the CPU the benchmark
+ *                               started on; -1 disables pinning.
+ */
 
 static double gettimedouble(void) {
+#if defined(CLOCK_MONOTONIC_RAW) || defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+#if defined(CLOCK_MONOTONIC_RAW)
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return ts.tv_nsec * 0.000000001 + ts.tv_sec;
+#else
     struct timeval tv;
     gettimeofday(&tv, NULL);
     return tv.tv_usec * 0.000001 + tv.tv_sec;
+#endif
+}
+
+/* Reads the time stamp counter, or returns 0 where there is none. */
+static uint64_t gettsc(void) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    uint32_t lo, hi;
+    __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+#else
+    return 0;
+#endif
+}
+
+static void bench_pin_cpu(void) {
+#if defined(__linux__) && defined(CPU_SET)
+    static int pinned = 0;
+    const char *env = getenv("SECP256K1_BENCH_CPU");
+    int cpu = env != NULL ? atoi(env) : sched_getcpu();
+    cpu_set_t set;
+    if (pinned || cpu < 0) {
+        return;
+    }
+    pinned = 1;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        fprintf(stderr, "warning: could not pin to CPU %d\n", cpu);
+    }
+#endif
+}
+
+static int bench_compare_double(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/* Returns the p-th percentile of n sorted values. */
+static double bench_percentile(const double *sorted, int n, double p) {
+    int i = (int)(p * (n - 1) / 100.0 + 0.5);
+    return sorted[i];
 }
 
 void print_number(double x) {
@@ -30,37 +97,92 @@ void print_number(double x) {
     printf("%.*f", c, x);
 }
 
-void run_benchmark(char *name, void (*benchmark)(void*), void (*setup)(void*), void (*teardown)(void*), void* data, int count, int iter) {
+static void bench_write_json(const char *name, int iter, const double *samples, const double *sorted, int n, double avg, double tsc) {
+    const char *path = getenv("SECP256K1_BENCH_JSON");
+    FILE *f;
     int i;
-    double min = HUGE_VAL;
+    if (path == NULL || (f = fopen(path, "a")) == NULL) {
+        return;
+    }
+    fprintf(f, "{\"name\": \"%s\", \"iters\": %d, \"min\": %.6g, \"avg\": %.6g, \"max\": %.6g, \"p50\": %.6g, \"p99\": %.6g, \"tsc\": %.6g, \"samples\": [",
+            name, iter, sorted[0], avg, sorted[n - 1], bench_percentile(sorted, n, 50), bench_percentile(sorted, n, 99), tsc);
+    for (i = 0; i < n; i++) {
+        fprintf(f, "%s%.6g", i ? ", " : "", samples[i]);
+    }
+    fprintf(f, "]}\n");
+    fclose(f);
+}
+
+/* Runs benchmark count times for iter iterations each, after one untimed warm-up run.
+ * Each run is timed in batches of consecutive iterations (single iterations when iter
+ * is small), and statistics are computed over the per-iteration time of all batches. */
+void run_benchmark(char *name, void (*benchmark)(void*, int), void (*setup)(void*), void (*teardown)(void*), void* data, int count, int iter) {
+    int i, j;
+    int batches = iter < BENCH_MAX_BATCHES ? iter : BENCH_MAX_BATCHES;
+    int n = 0;
+    double *samples = (double*)malloc(sizeof(double) * count * batches);
+    double *sorted = (double*)malloc(sizeof(double) * count * batches);
     double sum = 0.0;
-    double max = 0.0;
+    uint64_t tsc = 0;
+
+    if (samples == NULL || sorted == NULL) {
+        fprintf(stderr, "%s: out of memory\n", name);
+        exit(EXIT_FAILURE);
+    }
+    bench_pin_cpu();
+    if (setup != NULL) {
+        setup(data);
+    }
+    benchmark(data, iter / 10 > 0 ? iter / 10 : 1);
+    if (teardown != NULL) {
+        teardown(data);
+    }
+
     for (i = 0; i < count; i++) {
-        double begin, total;
         if (setup != NULL) {
             setup(data);
         }
-        begin = gettimedouble();
-        benchmark(data);
-        total = gettimedouble() - begin;
+        for (j = 0; j < batches; j++) {
+            /* Spread the remainder of iter / batches over the first batches. */
+            int len = iter / batches + (j < iter % batches);
+            double begin, total;
+            uint64_t begintsc;
+            begin = gettimedouble();
+            begintsc = gettsc();
+            benchmark(data, len);
+            tsc += gettsc() - begintsc;
+            total = gettimedouble() - begin;
+            samples[n++] = total * 1000000.0 / len;
+            sum += total;
+        }
         if (teardown != NULL) {
             teardown(data);
         }
-        if (total < min) {
-            min = total;
-        }
-        if (total > max) {
-            max = total;
-        }
-        sum += total;
     }
+    memcpy(sorted, samples, sizeof(double) * n);
+    qsort(sorted, n, sizeof(double), bench_compare_double);
+
     printf("%s: min ", name);
-    print_number(min * 1000000.0 / iter);
+    print_number(sorted[0]);
     printf("us / avg ");
-    print_number((sum / count) * 1000000.0 / iter);
+    print_number(sum * 1000000.0 / ((double)iter * count));
     printf("us / max ");
-    print_number(max * 1000000.0 / iter);
-    printf("us\n");
+    print_number(sorted[n - 1]);
+    printf("us / p50 ");
+    print_number(bench_percentile(sorted, n, 50));
+    printf("us / p99 ");
+    print_number(bench_percentile(sorted, n, 99));
+    printf("us");
+    if (tsc != 0) {
+        printf(" / ");
+        print_number((double)tsc / ((double)iter * count));
+        printf(" cycles");
+    }
+    printf("\n");
+    bench_write_json(name, iter, samples, sorted, n, sum * 1000000.0 / ((double)iter * count), (double)tsc / ((double)iter * count));
+
+    free(samples);
+    free(sorted);
 }
 
 #endif
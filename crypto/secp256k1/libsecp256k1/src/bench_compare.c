@@ -0,0 +1,205 @@
+/**********************************************************************
+ * Copyright (c) 2020 The libsecp256k1 developers                    *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+/* Compares two result files written by the benchmarks with SECP256K1_BENCH_JSON set.
+ *
+ * For every benchmark present in both files it prints the change of the median time
+ * per operation, and uses a Mann-Whitney U test over the samples to decide whether the
+ * change is significant. Changes of the median below COMPARE_MIN_DELTA percent are
+ * not flagged, however many samples support them. The exit code is 1 if any benchmark got significantly slower.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* |z| above which a difference is reported as significant (two-sided p < 0.001). */
+#define COMPARE_Z_THRESHOLD 3.29
+/* Significant differences of the medians below this many percent are still ignored. */
+#define COMPARE_MIN_DELTA 1.0
+
+typedef struct {
+    char name[64];
+    double *samples;
+    int n;
+    double p50;
+} bench_result;
+
+typedef struct {
+    bench_result *results;
+    int n;
+} bench_file;
+
+/* Reads a line of arbitrary length. Returns NULL at end of file. */
+static char *read_line(FILE *f) {
+    size_t len = 0, cap = 4096;
+    char *buf = (char*)malloc(cap);
+    int c;
+    if (buf == NULL) {
+        return NULL;
+    }
+    while ((c = fgetc(f)) != EOF && c != '\n') {
+        if (len + 1 == cap) {
+            char *nbuf = (char*)realloc(buf, cap * 2);
+            if (nbuf == NULL) {
+                free(buf);
+                return NULL;
+            }
+            buf = nbuf;
+            cap *= 2;
+        }
+        buf[len++] = (char)c;
+    }
+    if (c == EOF && len == 0) {
+        free(buf);
+        return NULL;
+    }
+    buf[len] = 0;
+    return buf;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/* Parses one object as written by bench_write_json in bench.h. */
+static int parse_result(const char *line, bench_result *r) {
+    const char *p = strstr(line, "\"name\": \"");
+    const char *end;
+    int cap = 256;
+    if (p == NULL) {
+        return 0;
+    }
+    p += 9;
+    end = strchr(p, '"');
+    if (end == NULL || end - p >= (int)sizeof(r->name)) {
+        return 0;
+    }
+    memcpy(r->name, p, end - p);
+    r->name[end - p] = 0;
+    p = strstr(line, "\"samples\": [");
+    if (p == NULL) {
+        return 0;
+    }
+    p += 12;
+    r->n = 0;
+    r->samples = (double*)malloc(sizeof(double) * cap);
+    while (r->samples != NULL) {
+        char *next;
+        double v = strtod(p, &next);
+        if (next == p) {
+            break;
+        }
+        if (r->n == cap) {
+            cap *= 2;
+            r->samples = (double*)realloc(r->samples, sizeof(double) * cap);
+            if (r->samples == NULL) {
+                break;
+            }
+        }
+        r->samples[r->n++] = v;
+        p = next;
+        while (*p == ',' || *p == ' ') {
+            p++;
+        }
+    }
+    if (r->samples == NULL || r->n == 0) {
+        free(r->samples);
+        return 0;
+    }
+    qsort(r->samples, r->n, sizeof(double), compare_double);
+    r->p50 = r->samples[r->n / 2];
+    return 1;
+}
+
+static int load_file(const char *path, bench_file *file) {
+    FILE *f = fopen(path, "r");
+    char *line;
+    int cap = 16;
+    if (f == NULL) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return 0;
+    }
+    file->n = 0;
+    file->results = (bench_result*)malloc(sizeof(bench_result) * cap);
+    while (file->results != NULL && (line = read_line(f)) != NULL) {
+        if (file->n == cap) {
+            cap *= 2;
+            file->results = (bench_result*)realloc(file->results, sizeof(bench_result) * cap);
+        }
+        if (file->results != NULL && parse_result(line, &file->results[file->n])) {
+            file->n++;
+        }
+        free(line);
+    }
+    fclose(f);
+    return file->results != NULL;
+}
+
+/* Returns the z score of the Mann-Whitney U statistic of two sorted sample sets. It is
+ * positive if the values in b tend to be larger than those in a. */
+static double mann_whitney_z(const double *a, int na, const double *b, int nb) {
+    double ranksum = 0.0, ties = 0.0;
+    double n = (double)na + nb, mean, var;
+    int i = 0, j = 0;
+    while (i < na || j < nb) {
+        /* Assign the average rank to the whole group of values equal to the next smallest. */
+        double v = (j == nb || (i < na && a[i] <= b[j])) ? a[i] : b[j];
+        int ca = 0, cb = 0;
+        double first;
+        while (i < na && a[i] == v) {
+            i++;
+            ca++;
+        }
+        while (j < nb && b[j] == v) {
+            j++;
+            cb++;
+        }
+        first = (double)(i + j - ca - cb) + 1.0;
+        ranksum += cb * (first + (ca + cb - 1) / 2.0);
+        ties += (double)(ca + cb) * (ca + cb) * (ca + cb) - (ca + cb);
+    }
+    mean = nb * (n + 1) / 2.0;
+    var = (double)na * nb / 12.0 * ((n + 1) - ties / (n * (n - 1)));
+    return var > 0.0 ? (ranksum - mean) / sqrt(var) : 0.0;
+}
+
+int main(int argc, char **argv) {
+    bench_file base, cur;
+    int i, j, regressions = 0;
+
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <base.json> <new.json>\n", argv[0]);
+        return 2;
+    }
+    if (!load_file(argv[1], &base) || !load_file(argv[2], &cur)) {
+        return 2;
+    }
+    printf("%-32s %12s %12s %8s %8s\n", "benchmark", "base p50", "new p50", "delta", "z");
+    for (i = 0; i < cur.n; i++) {
+        const bench_result *b = NULL, *c = &cur.results[i];
+        double delta, z;
+        for (j = 0; j < base.n; j++) {
+            if (strcmp(base.results[j].name, c->name) == 0) {
+                b = &base.results[j];
+            }
+        }
+        if (b == NULL) {
+            continue;
+        }
+        delta = (c->p50 - b->p50) / b->p50 * 100.0;
+        z = mann_whitney_z(b->samples, b->n, c->samples, c->n);
+        printf("%-32s %10.4gus %10.4gus %+7.2f%% %8.2f", c->name, b->p50, c->p50, delta, z);
+        if (fabs(z) > COMPARE_Z_THRESHOLD && fabs(delta) >= COMPARE_MIN_DELTA) {
+            printf(z > 0 ? "  slower" : "  faster");
+            regressions += z > 0;
+        }
+        printf("\n");
+    }
+    return regressions > 0;
+}
@@ -11,10 +11,15 @@
 #include "util.h"
 #include "bench.h"
 
+#define BATCH 32
+
 typedef struct {
     secp256k1_context *ctx;
     secp256k1_pubkey point;
     unsigned char scalar[32];
+    secp256k1_pubkey points[BATCH];
+    unsigned char scalars[BATCH * 32];
+    secp256k1_ecdh_table *table;
 } bench_ecdh_t;
 
 static void bench_ecdh_setup(void* arg) {
@@ -34,21 +39,63 @@ static void bench_ecdh_setup(void* arg) {
         data->scalar[i] = i + 1;
     }
     CHECK(secp256k1_ec_pubkey_parse(data->ctx, &data->point, point, sizeof(point)) == 1);
+    for (i = 0; i < BATCH; i++) {
+        data->points[i] = data->point;
+        memcpy(data->scalars + i * 32, data->scalar, 32);
+        data->scalars[i * 32] = i + 1;
+    }
 }
 
-static void bench_ecdh(void* arg) {
+static void bench_ecdh(void* arg, int iters) {
     int i;
     unsigned char res[32];
     bench_ecdh_t *data = (bench_ecdh_t*)arg;
 
-    for (i = 0; i < 20000; i++) {
+    for (i = 0; i < iters; i++) {
         CHECK(secp256k1_ecdh(data->ctx, res, &data->point, data->scalar) == 1);
     }
 }
 
+static void bench_ecdh_batch(void* arg, int iters) {
+    int i;
+    unsigned char res[BATCH * 32];
+    bench_ecdh_t *data = (bench_ecdh_t*)arg;
+
+    for (i = 0; i < iters; i += BATCH) {
+        CHECK(secp256k1_ecdh_batch(data->ctx, res, data->points, data->scalars, BATCH) == 1);
+    }
+}
+
+static void bench_ecdh_table_setup(void* arg) {
+    bench_ecdh_t *data = (bench_ecdh_t*)arg;
+
+    bench_ecdh_setup(arg);
+    data->table = secp256k1_ecdh_table_create(data->ctx, &data->point, data->scalar);
+    CHECK(data->table != NULL);
+}
+
+static void bench_ecdh_table_teardown(void* arg) {
+    bench_ecdh_t *data = (bench_ecdh_t*)arg;
+
+    secp256k1_ecdh_table_destroy(data->table);
+    secp256k1_context_destroy(data->ctx);
+}
+
+static void bench_ecdh_table(void* arg, int iters) {
+    int i;
+    unsigned char res[32];
+    bench_ecdh_t *data = (bench_ecdh_t*)arg;
+
+    for (i = 0; i < iters; i++) {
+        CHECK(secp256k1_ecdh_table_ecdh(data->ctx, res, data->table, data->scalar) == 1);
+    }
+}
+
 int main(void) {
     bench_ecdh_t data;
 
     run_benchmark("ecdh", bench_ecdh, bench_ecdh_setup, NULL, &data, 10, 20000);
+    run_benchmark("ecdh_table", bench_ecdh_table, bench_ecdh_table_setup, bench_ecdh_table_teardown, &data, 10, 20000);
+    run_benchmark("ecdh_batch32", bench_ecdh_batch, bench_ecdh_setup, NULL, &data, 10, 19200);
     return 0;
 }
@@ -23,6 +23,7 @@ typedef struct {
     secp256k1_fe fe_x, fe_y;
     secp256k1_ge ge_x, ge_y;
     secp256k1_gej gej_x, gej_y;
+    secp256k1_gep gep_x;
     unsigned char data[64];
     int wnaf[256];
 } bench_inv_t;
@@ -52,52 +53,53 @@ void bench_setup(void* arg) {
     CHECK(secp256k1_ge_set_xo_var(&data->ge_y, &data->fe_y, 1));
     secp256k1_gej_set_ge(&data->gej_x, &data->ge_x);
     secp256k1_gej_set_ge(&data->gej_y, &data->ge_y);
+    secp256k1_gep_set_gej(&data->gep_x, &data->gej_x);
     memcpy(data->data, init_x, 32);
     memcpy(data->data + 32, init_y, 32);
 }
 
-void bench_scalar_add(void* arg) {
+void bench_scalar_add(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
 
-    for (i = 0; i < 2000000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_scalar_add(&data->scalar_x, &data->scalar_x, &data->scalar_y);
     }
 }
 
-void bench_scalar_negate(void* arg) {
+void bench_scalar_negate(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
 
-    for (i = 0; i < 2000000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_scalar_negate(&data->scalar_x, &data->scalar_x);
     }
 }
 
-void bench_scalar_sqr(void* arg) {
+void bench_scalar_sqr(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
 
-    for (i = 0; i < 200000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_scalar_sqr(&data->scalar_x, &data->scalar_x);
     }
 }
 
-void bench_scalar_mul(void* arg) {
+void bench_scalar_mul(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
 
-    for (i = 0; i < 200000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_scalar_mul(&data->scalar_x, &data->scalar_x, &data->scalar_y);
     }
 }
 
 #ifdef USE_ENDOMORPHISM
-void bench_scalar_split(void* arg) {
+void bench_scalar_split(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
 
-    for (i = 0; i < 20000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_scalar l, r;
         secp256k1_scalar_split_lambda(&l, &r, &data->scalar_x);
         secp256k1_scalar_add(&data->scalar_x, &data->scalar_x, &data->scalar_y);
@@ -105,211 +107,230 @@ void bench_scalar_split(void* arg) {
 }
 #endif
 
-void bench_scalar_inverse(void* arg) {
+void bench_scalar_inverse(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
 
-    for (i = 0; i < 2000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_scalar_inverse(&data->scalar_x, &data->scalar_x);
         secp256k1_scalar_add(&data->scalar_x, &data->scalar_x, &data->scalar_y);
     }
 }
 
-void bench_scalar_inverse_var(void* arg) {
+void bench_scalar_inverse_var(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
 
-    for (i = 0; i < 2000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_scalar_inverse_var(&data->scalar_x, &data->scalar_x);
         secp256k1_scalar_add(&data->scalar_x, &data->scalar_x, &data->scalar_y);
     }
 }
 
-void bench_field_normalize(void* arg) {
+void bench_field_normalize(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
 
-    for (i = 0; i < 2000000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_fe_normalize(&data->fe_x);
     }
 }
 
-void bench_field_normalize_weak(void* arg) {
+void bench_field_normalize_weak(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
 
-    for (i = 0; i < 2000000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_fe_normalize_weak(&data->fe_x);
     }
 }
 
-void bench_field_mul(void* arg) {
+void bench_field_mul(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
 
-    for (i = 0; i < 200000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_fe_mul(&data->fe_x, &data->fe_x, &data->fe_y);
     }
 }
 
-void bench_field_sqr(void* arg) {
+void bench_field_sqr(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
 
-    for (i = 0; i < 200000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_fe_sqr(&data->fe_x, &data->fe_x);
     }
 }
 
-void bench_field_inverse(void* arg) {
+void bench_field_inverse(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
 
-    for (i = 0; i < 20000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_fe_inv(&data->fe_x, &data->fe_x);
         secp256k1_fe_add(&data->fe_x, &data->fe_y);
     }
 }
 
-void bench_field_inverse_var(void* arg) {
+void bench_field_inverse_var(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
 
-    for (i = 0; i < 20000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_fe_inv_var(&data->fe_x, &data->fe_x);
         secp256k1_fe_add(&data->fe_x, &data->fe_y);
     }
 }
 
-void bench_field_sqrt(void* arg) {
+void bench_field_sqrt(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
 
-    for (i = 0; i < 20000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_fe_sqrt(&data->fe_x, &data->fe_x);
         secp256k1_fe_add(&data->fe_x, &data->fe_y);
     }
 }
 
-void bench_group_double_var(void* arg) {
+void bench_field_is_quad_var(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
 
-    for (i = 0; i < 200000; i++) {
+    for (i = 0; i < iters; i++) {
+        secp256k1_fe_is_quad_var(&data->fe_x);
+        secp256k1_fe_add(&data->fe_x, &data->fe_y);
+    }
+}
+
+void bench_group_double_var(void* arg, int iters) {
+    int i;
+    bench_inv_t *data = (bench_inv_t*)arg;
+
+    for (i = 0; i < iters; i++) {
         secp256k1_gej_double_var(&data->gej_x, &data->gej_x, NULL);
     }
 }
 
-void bench_group_add_var(void* arg) {
+void bench_group_add_var(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
 
-    for (i = 0; i < 200000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_gej_add_var(&data->gej_x, &data->gej_x, &data->gej_y, NULL);
     }
 }
 
-void bench_group_add_affine(void* arg) {
+void bench_group_add_affine(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
 
-    for (i = 0; i < 200000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_gej_add_ge(&data->gej_x, &data->gej_x, &data->ge_y);
     }
 }
 
-void bench_group_add_affine_var(void* arg) {
+void bench_group_add_affine_var(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
 
-    for (i = 0; i < 200000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_gej_add_ge_var(&data->gej_x, &data->gej_x, &data->ge_y, NULL);
     }
 }
 
-void bench_group_jacobi_var(void* arg) {
+void bench_group_add_affine_complete(void* arg, int iters) {
+    int i;
+    bench_inv_t *data = (bench_inv_t*)arg;
+
+    for (i = 0; i < iters; i++) {
+        secp256k1_gep_add_ge(&data->gep_x, &data->gep_x, &data->ge_y);
+    }
+}
+
+void bench_group_jacobi_var(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
 
-    for (i = 0; i < 20000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_gej_has_quad_y_var(&data->gej_x);
     }
 }
 
-void bench_ecmult_wnaf(void* arg) {
+void bench_ecmult_wnaf(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
 
-    for (i = 0; i < 20000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_ecmult_wnaf(data->wnaf, 256, &data->scalar_x, WINDOW_A);
         secp256k1_scalar_add(&data->scalar_x, &data->scalar_x, &data->scalar_y);
     }
 }
 
-void bench_wnaf_const(void* arg) {
+void bench_wnaf_const(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
 
-    for (i = 0; i < 20000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_wnaf_const(data->wnaf, data->scalar_x, WINDOW_A);
         secp256k1_scalar_add(&data->scalar_x, &data->scalar_x, &data->scalar_y);
     }
 }
 
 
-void bench_sha256(void* arg) {
+void bench_sha256(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
     secp256k1_sha256_t sha;
 
-    for (i = 0; i < 20000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_sha256_initialize(&sha);
         secp256k1_sha256_write(&sha, data->data, 32);
         secp256k1_sha256_finalize(&sha, data->data);
     }
 }
 
-void bench_hmac_sha256(void* arg) {
+void bench_hmac_sha256(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
     secp256k1_hmac_sha256_t hmac;
 
-    for (i = 0; i < 20000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_hmac_sha256_initialize(&hmac, data->data, 32);
         secp256k1_hmac_sha256_write(&hmac, data->data, 32);
         secp256k1_hmac_sha256_finalize(&hmac, data->data);
     }
 }
 
-void bench_rfc6979_hmac_sha256(void* arg) {
+void bench_rfc6979_hmac_sha256(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
     secp256k1_rfc6979_hmac_sha256_t rng;
 
-    for (i = 0; i < 20000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_rfc6979_hmac_sha256_initialize(&rng, data->data, 64);
         secp256k1_rfc6979_hmac_sha256_generate(&rng, data->data, 32);
     }
 }
 
-void bench_context_verify(void* arg) {
+void bench_context_verify(void* arg, int iters) {
     int i;
     (void)arg;
-    for (i = 0; i < 20; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_context_destroy(secp256k1_context_create(SECP256K1_CONTEXT_VERIFY));
     }
 }
 
-void bench_context_sign(void* arg) {
+void bench_context_sign(void* arg, int iters) {
     int i;
     (void)arg;
-    for (i = 0; i < 200; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_context_destroy(secp256k1_context_create(SECP256K1_CONTEXT_SIGN));
     }
 }
 
 #ifndef USE_NUM_NONE
-void bench_num_jacobi(void* arg) {
+void bench_num_jacobi(void* arg, int iters) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
     secp256k1_num nx, norder;
@@ -318,7 +339,7 @@ void bench_num_jacobi(void* arg) {
     secp256k1_scalar_order_get_num(&norder);
     secp256k1_scalar_get_num(&norder, &data->scalar_y);
 
-    for (i = 0; i < 200000; i++) {
+    for (i = 0; i < iters; i++) {
         secp256k1_num_jacobi(&nx, &norder);
     }
 }
@@ -358,11 +379,13 @@ int main(int argc, char **argv) {
     if (have_flag(argc, argv, "field") || have_flag(argc, argv, "inverse")) run_benchmark("field_inverse", bench_field_inverse, bench_setup, NULL, &data, 10, 20000);
     if (have_flag(argc, argv, "field") || have_flag(argc, argv, "inverse")) run_benchmark("field_inverse_var", bench_field_inverse_var, bench_setup, NULL, &data, 10, 20000);
     if (have_flag(argc, argv, "field") || have_flag(argc, argv, "sqrt")) run_benchmark("field_sqrt", bench_field_sqrt, bench_setup, NULL, &data, 10, 20000);
+    if (have_flag(argc, argv, "field") || have_flag(argc, argv, "jacobi")) run_benchmark("field_is_quad_var", bench_field_is_quad_var, bench_setup, NULL, &data, 10, 20000);
 
     if (have_flag(argc, argv, "group") || have_flag(argc, argv, "double")) run_benchmark("group_double_var", bench_group_double_var, bench_setup, NULL, &data, 10, 200000);
     if (have_flag(argc, argv, "group") || have_flag(argc, argv, "add")) run_benchmark("group_add_var", bench_group_add_var, bench_setup, NULL, &data, 10, 200000);
     if (have_flag(argc, argv, "group") || have_flag(argc, argv, "add")) run_benchmark("group_add_affine", bench_group_add_affine, bench_setup, NULL, &data, 10, 200000);
     if (have_flag(argc, argv, "group") || have_flag(argc, argv, "add")) run_benchmark("group_add_affine_var", bench_group_add_affine_var, bench_setup, NULL, &data, 10, 200000);
+    if (have_flag(argc, argv, "group") || have_flag(argc, argv, "add")) run_benchmark("group_add_affine_complete", bench_group_add_affine_complete, bench_setup, NULL, &data, 10, 200000);
     if (have_flag(argc, argv, "group") || have_flag(argc, argv, "jacobi")) run_benchmark("group_jacobi_var", bench_group_jacobi_var, bench_setup, NULL, &data, 10, 20000);
 
     if (have_flag(argc, argv, "ecmult") || have_flag(argc, argv, "wnaf")) run_benchmark("wnaf_const", bench_wnaf_const, bench_setup, NULL, &data, 10, 20000);
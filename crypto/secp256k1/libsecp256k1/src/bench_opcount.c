@@ -0,0 +1,163 @@
+/**********************************************************************
+ * Copyright (c) 2020 The libsecp256k1 developers                    *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+/* Prints how many field, group and scalar operations each public API call performs,
+ * averaged over a number of random-looking inputs. Needs --enable-opcount. */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "include/secp256k1.h"
+#include "include/secp256k1_opcount.h"
+#include "util.h"
+#ifdef ENABLE_MODULE_RECOVERY
+#include "include/secp256k1_recovery.h"
+#endif
+#ifdef ENABLE_MODULE_ECDH
+#include "include/secp256k1_ecdh.h"
+#endif
+
+#define OPCOUNT_RUNS 64
+
+typedef enum {
+    API_PUBKEY_CREATE,
+    API_PUBKEY_PARSE,
+    API_TWEAK_ADD,
+    API_TWEAK_MUL,
+    API_SIGN,
+    API_VERIFY,
+#ifdef ENABLE_MODULE_RECOVERY
+    API_RECOVER,
+#endif
+#ifdef ENABLE_MODULE_ECDH
+    API_ECDH,
+#endif
+    API_COUNT
+} bench_opcount_api;
+
+static const char *api_names[] = {
+    "pubkey",
+    "parse33",
+    "tweak_add",
+    "tweak_mul",
+    "sign",
+    "verify",
+#ifdef ENABLE_MODULE_RECOVERY
+    "recover",
+#endif
+#ifdef ENABLE_MODULE_ECDH
+    "ecdh",
+#endif
+};
+
+typedef struct {
+    secp256k1_context *ctx;
+    unsigned char key[32];
+    unsigned char msg[32];
+    unsigned char pubkey33[33];
+    secp256k1_pubkey pubkey;
+    secp256k1_ecdsa_signature sig;
+#ifdef ENABLE_MODULE_RECOVERY
+    secp256k1_ecdsa_recoverable_signature rsig;
+#endif
+} bench_opcount_data;
+
+static void prepare(bench_opcount_data *d, int run) {
+    size_t len = 33;
+    int i;
+    for (i = 0; i < 32; i++) {
+        d->key[i] = (unsigned char)(i * 7 + run * 13 + 1);
+        d->msg[i] = (unsigned char)(i * 11 + run * 17 + 3);
+    }
+    CHECK(secp256k1_ec_pubkey_create(d->ctx, &d->pubkey, d->key) == 1);
+    CHECK(secp256k1_ec_pubkey_serialize(d->ctx, d->pubkey33, &len, &d->pubkey, SECP256K1_EC_COMPRESSED) == 1);
+    CHECK(secp256k1_ecdsa_sign(d->ctx, &d->sig, d->msg, d->key, NULL, NULL) == 1);
+#ifdef ENABLE_MODULE_RECOVERY
+    CHECK(secp256k1_ecdsa_sign_recoverable(d->ctx, &d->rsig, d->msg, d->key, NULL, NULL) == 1);
+#endif
+}
+
+static void call_api(bench_opcount_data *d, bench_opcount_api api) {
+    secp256k1_pubkey pubkey = d->pubkey;
+    secp256k1_ecdsa_signature sig;
+    switch (api) {
+    case API_PUBKEY_CREATE:
+        CHECK(secp256k1_ec_pubkey_create(d->ctx, &pubkey, d->key) == 1);
+        break;
+    case API_PUBKEY_PARSE:
+        CHECK(secp256k1_ec_pubkey_parse(d->ctx, &pubkey, d->pubkey33, 33) == 1);
+        break;
+    case API_TWEAK_ADD:
+        CHECK(secp256k1_ec_pubkey_tweak_add(d->ctx, &pubkey, d->msg) == 1);
+        break;
+    case API_TWEAK_MUL:
+        CHECK(secp256k1_ec_pubkey_tweak_mul(d->ctx, &pubkey, d->msg) == 1);
+        break;
+    case API_SIGN:
+        CHECK(secp256k1_ecdsa_sign(d->ctx, &sig, d->msg, d->key, NULL, NULL) == 1);
+        break;
+    case API_VERIFY:
+        CHECK(secp256k1_ecdsa_verify(d->ctx, &d->sig, d->msg, &d->pubkey) == 1);
+        break;
+#ifdef ENABLE_MODULE_RECOVERY
+    case API_RECOVER:
+        CHECK(secp256k1_ecdsa_recover(d->ctx, &pubkey, &d->rsig, d->msg) == 1);
+        break;
+#endif
+#ifdef ENABLE_MODULE_ECDH
+    case API_ECDH: {
+        unsigned char out[32];
+        CHECK(secp256k1_ecdh(d->ctx, out, &d->pubkey, d->msg) == 1);
+        break;
+    }
+#endif
+    default:
+        break;
+    }
+}
+
+#define OPCOUNT_FIELDS(X) \
+    X(fe_mul) X(fe_sqr) X(fe_inv) X(fe_inv_var) X(fe_sqrt) X(fe_is_quad_var) \
+    X(gej_double_var) X(gej_add_var) X(gej_add_ge) X(gej_add_ge_var) X(gej_add_zinv_var) X(gep_add_ge) \
+    X(scalar_inverse) X(scalar_inverse_var) X(ecmult) X(ecmult_gen) X(ecmult_const)
+
+int main(void) {
+    bench_opcount_data data;
+    secp256k1_opcount totals[API_COUNT];
+    int api, run;
+
+    memset(totals, 0, sizeof(totals));
+    data.ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+    for (run = 0; run < OPCOUNT_RUNS; run++) {
+        prepare(&data, run);
+        for (api = 0; api < API_COUNT; api++) {
+            secp256k1_opcount counts;
+            secp256k1_opcount_reset();
+            call_api(&data, (bench_opcount_api)api);
+            secp256k1_opcount_snapshot(&counts);
+#define ADD_FIELD(f) totals[api].f += counts.f;
+            OPCOUNT_FIELDS(ADD_FIELD)
+#undef ADD_FIELD
+        }
+    }
+
+    printf("%-18s", "per call");
+    for (api = 0; api < API_COUNT; api++) {
+        printf(" %10s", api_names[api]);
+    }
+    printf("\n");
+#define PRINT_FIELD(f) \
+    printf("%-18s", #f); \
+    for (api = 0; api < API_COUNT; api++) { \
+        printf(" %10.1f", (double)totals[api].f / OPCOUNT_RUNS); \
+    } \
+    printf("\n");
+    OPCOUNT_FIELDS(PRINT_FIELD)
+#undef PRINT_FIELD
+
+    secp256k1_context_destroy(data.ctx);
+    return 0;
+}
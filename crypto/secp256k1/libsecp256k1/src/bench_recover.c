@@ -15,13 +15,13 @@ typedef struct {
     unsigned char sig[64];
 } bench_recover_t;
 
-void bench_recover(void* arg) {
+void bench_recover(void* arg, int iters) {
     int i;
     bench_recover_t *data = (bench_recover_t*)arg;
     secp256k1_pubkey pubkey;
     unsigned char pubkeyc[33];
 
-    for (i = 0; i < 20000; i++) {
+    for (i = 0; i < iters; i++) {
         int j;
         size_t pubkeylen = 33;
         secp256k1_ecdsa_recoverable_signature sig;
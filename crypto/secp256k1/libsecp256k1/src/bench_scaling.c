@@ -0,0 +1,257 @@
+/**********************************************************************
+ * Copyright (c) 2020 The libsecp256k1 developers                    *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+/* Measures how throughput scales with the number of threads, both when all threads
+ * share one context (as a process-wide context does in practice) and when every thread
+ * has its own. A drop in efficiency for the shared context only points at contention
+ * on the context, such as false sharing or bandwidth on the precomputed tables.
+ *
+ * Usage: bench_scaling [max_threads [seconds_per_point]]
+ */
+
+#ifdef __linux__
+/* For pthread_setaffinity_np and CPU_SET. */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <sched.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "include/secp256k1.h"
+#include "util.h"
+#ifdef ENABLE_MODULE_RECOVERY
+#include "include/secp256k1_recovery.h"
+#endif
+#ifdef ENABLE_MODULE_ECDH
+#include "include/secp256k1_ecdh.h"
+#endif
+#include "bench.h"
+
+typedef enum {
+    OP_VERIFY,
+    OP_SIGN,
+#ifdef ENABLE_MODULE_RECOVERY
+    OP_RECOVER,
+#endif
+#ifdef ENABLE_MODULE_ECDH
+    OP_ECDH,
+#endif
+    OP_COUNT
+} bench_scaling_op;
+
+static const char *op_names[] = {
+    "verify",
+    "sign",
+#ifdef ENABLE_MODULE_RECOVERY
+    "recover",
+#endif
+#ifdef ENABLE_MODULE_ECDH
+    "ecdh",
+#endif
+};
+
+/* Releases all waiting threads once count of them have arrived. A minimal barrier, as
+ * pthread_barrier_t is not available everywhere (for example on macOS). */
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int count;
+} bench_scaling_gate;
+
+static void gate_init(bench_scaling_gate *g, int count) {
+    pthread_mutex_init(&g->lock, NULL);
+    pthread_cond_init(&g->cond, NULL);
+    g->count = count;
+}
+
+static void gate_wait(bench_scaling_gate *g) {
+    pthread_mutex_lock(&g->lock);
+    if (--g->count == 0) {
+        pthread_cond_broadcast(&g->cond);
+    }
+    while (g->count > 0) {
+        pthread_cond_wait(&g->cond, &g->lock);
+    }
+    pthread_mutex_unlock(&g->lock);
+}
+
+static void gate_destroy(bench_scaling_gate *g) {
+    pthread_cond_destroy(&g->cond);
+    pthread_mutex_destroy(&g->lock);
+}
+
+typedef struct {
+    secp256k1_context *ctx;
+    bench_scaling_gate *gate;
+    bench_scaling_op op;
+    int cpu;
+    double seconds;
+    unsigned long ops;
+    unsigned char key[32];
+    unsigned char msg[32];
+    secp256k1_pubkey pubkey;
+    secp256k1_ecdsa_signature sig;
+#ifdef ENABLE_MODULE_RECOVERY
+    secp256k1_ecdsa_recoverable_signature rsig;
+#endif
+} bench_scaling_thread;
+
+static void run_op(bench_scaling_thread *t, unsigned long i) {
+    switch (t->op) {
+    case OP_VERIFY:
+        CHECK(secp256k1_ecdsa_verify(t->ctx, &t->sig, t->msg, &t->pubkey) == 1);
+        break;
+    case OP_SIGN: {
+        secp256k1_ecdsa_signature sig;
+        t->msg[0] ^= (unsigned char)i;
+        CHECK(secp256k1_ecdsa_sign(t->ctx, &sig, t->msg, t->key, NULL, NULL) == 1);
+        t->msg[0] ^= (unsigned char)i;
+        break;
+    }
+#ifdef ENABLE_MODULE_RECOVERY
+    case OP_RECOVER: {
+        secp256k1_pubkey pubkey;
+        CHECK(secp256k1_ecdsa_recover(t->ctx, &pubkey, &t->rsig, t->msg) == 1);
+        break;
+    }
+#endif
+#ifdef ENABLE_MODULE_ECDH
+    case OP_ECDH: {
+        unsigned char out[32];
+        CHECK(secp256k1_ecdh(t->ctx, out, &t->pubkey, t->key) == 1);
+        break;
+    }
+#endif
+    default:
+        break;
+    }
+}
+
+static void *thread_main(void *arg) {
+    bench_scaling_thread *t = (bench_scaling_thread*)arg;
+    double deadline;
+    unsigned long i = 0;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(t->cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+    /* Warm up caches and the shared tables before everyone starts together. */
+    for (i = 0; i < 16; i++) {
+        run_op(t, i);
+    }
+    gate_wait(t->gate);
+    deadline = gettimedouble() + t->seconds;
+    i = 0;
+    do {
+        int j;
+        for (j = 0; j < 16; j++, i++) {
+            run_op(t, i);
+        }
+    } while (gettimedouble() < deadline);
+    t->ops = i;
+    return NULL;
+}
+
+static void setup_thread(bench_scaling_thread *t, const secp256k1_context *ctx, int index) {
+    int i;
+    for (i = 0; i < 32; i++) {
+        t->key[i] = (unsigned char)(i + 1 + index);
+        t->msg[i] = (unsigned char)(i + 65 + index);
+    }
+    CHECK(secp256k1_ec_pubkey_create(ctx, &t->pubkey, t->key) == 1);
+    CHECK(secp256k1_ecdsa_sign(ctx, &t->sig, t->msg, t->key, NULL, NULL) == 1);
+#ifdef ENABLE_MODULE_RECOVERY
+    CHECK(secp256k1_ecdsa_sign_recoverable(ctx, &t->rsig, t->msg, t->key, NULL, NULL) == 1);
+#endif
+}
+
+/* Runs op on nthreads threads for the given time and returns the total operations per second. */
+static double run_point(secp256k1_context *shared, bench_scaling_op op, int nthreads, int ncpus, double seconds) {
+    bench_scaling_thread *threads = (bench_scaling_thread*)calloc(nthreads, sizeof(bench_scaling_thread));
+    pthread_t *ids = (pthread_t*)calloc(nthreads, sizeof(pthread_t));
+    bench_scaling_gate gate;
+    double begin, total;
+    unsigned long ops = 0;
+    int i;
+
+    CHECK(threads != NULL && ids != NULL);
+    gate_init(&gate, nthreads + 1);
+    for (i = 0; i < nthreads; i++) {
+        threads[i].ctx = shared != NULL ? shared : secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+        threads[i].gate = &gate;
+        threads[i].op = op;
+        threads[i].cpu = i % ncpus;
+        threads[i].seconds = seconds;
+        setup_thread(&threads[i], threads[i].ctx, i);
+        CHECK(pthread_create(&ids[i], NULL, thread_main, &threads[i]) == 0);
+    }
+    gate_wait(&gate);
+    begin = gettimedouble();
+    for (i = 0; i < nthreads; i++) {
+        pthread_join(ids[i], NULL);
+        ops += threads[i].ops;
+    }
+    total = gettimedouble() - begin;
+    for (i = 0; i < nthreads; i++) {
+        if (shared == NULL) {
+            secp256k1_context_destroy(threads[i].ctx);
+        }
+    }
+    gate_destroy(&gate);
+    free(threads);
+    free(ids);
+    return ops / total;
+}
+
+int main(int argc, char **argv) {
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int maxthreads = ncpus > 0 ? (int)ncpus : 1;
+    double seconds = 1.0;
+    secp256k1_context *shared = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+    int op, mode, n;
+
+    if (ncpus < 1) {
+        ncpus = 1;
+    }
+    if (argc > 1) {
+        maxthreads = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        seconds = atof(argv[2]);
+    }
+    if (maxthreads < 1 || seconds <= 0.0) {
+        fprintf(stderr, "usage: %s [max_threads [seconds_per_point]]\n", argv[0]);
+        return 1;
+    }
+
+    printf("%-8s %-10s %7s %12s %12s %10s\n", "op", "context", "threads", "ops/s", "ops/s/core", "efficiency");
+    for (op = 0; op < OP_COUNT; op++) {
+        for (mode = 0; mode < 2; mode++) {
+            double single = 0.0;
+            /* 1, 2, 4, ... threads, always ending with maxthreads. */
+            for (n = 1; n <= maxthreads; n = (n * 2 > maxthreads && n != maxthreads) ? maxthreads : n * 2) {
+                double rate = run_point(mode == 0 ? shared : NULL, (bench_scaling_op)op, n, (int)ncpus, seconds);
+                int cores = n < ncpus ? n : (int)ncpus;
+                if (n == 1) {
+                    single = rate;
+                }
+                printf("%-8s %-10s %7d %12.0f %12.0f %9.1f%%\n", op_names[op], mode == 0 ? "shared" : "per-thread",
+                       n, rate, rate / cores, 100.0 * rate / (cores * single));
+                fflush(stdout);
+            }
+        }
+    }
+    secp256k1_context_destroy(shared);
+    return 0;
+}
@@ -12,17 +12,21 @@
 #include "util.h"
 #include "bench.h"
 
+#define MAX_SIGS 128
+
 typedef struct {
     unsigned char key[32];
+    unsigned char msg[32];
     unsigned char sig[64];
-    unsigned char pubkey[33];
-    size_t pubkeylen;
+    secp256k1_pubkey pubkey;
 } benchmark_schnorr_sig_t;
 
 typedef struct {
     secp256k1_context *ctx;
-    unsigned char msg[32];
-    benchmark_schnorr_sig_t sigs[64];
+    benchmark_schnorr_sig_t sigs[MAX_SIGS];
+    const unsigned char *sigps[MAX_SIGS];
+    const unsigned char *msgps[MAX_SIGS];
+    const secp256k1_pubkey *pubkeyps[MAX_SIGS];
     int numsigs;
 } benchmark_schnorr_verify_t;
 
@@ -30,43 +34,70 @@ static void benchmark_schnorr_init(void* arg) {
     int i, k;
     benchmark_schnorr_verify_t* data = (benchmark_schnorr_verify_t*)arg;
 
-    for (i = 0; i < 32; i++) {
-        data->msg[i] = 1 + i;
-    }
-    for (k = 0; k < data->numsigs; k++) {
-        secp256k1_pubkey pubkey;
+    for (k = 0; k < MAX_SIGS; k++) {
         for (i = 0; i < 32; i++) {
             data->sigs[k].key[i] = 33 + i + k;
+            data->sigs[k].msg[i] = 1 + i + k;
         }
-        secp256k1_schnorr_sign(data->ctx, data->sigs[k].sig, data->msg, data->sigs[k].key, NULL, NULL);
-        data->sigs[k].pubkeylen = 33;
-        CHECK(secp256k1_ec_pubkey_create(data->ctx, &pubkey, data->sigs[k].key));
-        CHECK(secp256k1_ec_pubkey_serialize(data->ctx, data->sigs[k].pubkey, &data->sigs[k].pubkeylen, &pubkey, SECP256K1_EC_COMPRESSED));
+        CHECK(secp256k1_schnorr_sign(data->ctx, data->sigs[k].sig, data->sigs[k].msg, data->sigs[k].key, NULL));
+        CHECK(secp256k1_ec_pubkey_create(data->ctx, &data->sigs[k].pubkey, data->sigs[k].key));
+        data->sigps[k] = data->sigs[k].sig;
+        data->msgps[k] = data->sigs[k].msg;
+        data->pubkeyps[k] = &data->sigs[k].pubkey;
     }
 }
 
-static void benchmark_schnorr_verify(void* arg) {
+static void benchmark_schnorr_verify(void* arg, int iters) {
     int i;
     benchmark_schnorr_verify_t* data = (benchmark_schnorr_verify_t*)arg;
 
-    for (i = 0; i < 20000 / data->numsigs; i++) {
-        secp256k1_pubkey pubkey;
-        data->sigs[0].sig[(i >> 8) % 64] ^= (i & 0xFF);
-        CHECK(secp256k1_ec_pubkey_parse(data->ctx, &pubkey, data->sigs[0].pubkey, data->sigs[0].pubkeylen));
-        CHECK(secp256k1_schnorr_verify(data->ctx, data->sigs[0].sig, data->msg, &pubkey) == ((i & 0xFF) == 0));
-        data->sigs[0].sig[(i >> 8) % 64] ^= (i & 0xFF);
+    for (i = 0; i < iters; i++) {
+        benchmark_schnorr_sig_t *s = &data->sigs[i % MAX_SIGS];
+        s->sig[(i >> 8) % 64] ^= (i & 0xFF);
+        CHECK(secp256k1_schnorr_verify(data->ctx, s->sig, s->msg, &s->pubkey) == ((i & 0xFF) == 0));
+        s->sig[(i >> 8) % 64] ^= (i & 0xFF);
     }
 }
 
+/* Verifies iters signatures in batches of numsigs, so the reported time is per signature. */
+static void benchmark_schnorr_verify_batch(void* arg, int iters) {
+    int i;
+    benchmark_schnorr_verify_t* data = (benchmark_schnorr_verify_t*)arg;
 
+    for (i = 0; i < iters; i += data->numsigs) {
+        CHECK(secp256k1_schnorr_verify_batch(data->ctx, data->sigps, data->msgps, data->pubkeyps, data->numsigs) == 1);
+    }
+}
 
 int main(void) {
-    benchmark_schnorr_verify_t data;
+    static benchmark_schnorr_verify_t data;
+    char name[64];
+    double single, begin;
+    int n, i;
 
     data.ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+    benchmark_schnorr_init(&data);
+
+    run_benchmark("schnorr_verify", benchmark_schnorr_verify, NULL, NULL, &data, 10, 20000);
+    for (n = 1; n <= MAX_SIGS; n *= 2) {
+        data.numsigs = n;
+        sprintf(name, "schnorr_verify_batch%d", n);
+        /* 12800 is a multiple of 100 * MAX_SIGS, so every timed batch holds whole calls. */
+        run_benchmark(name, benchmark_schnorr_verify_batch, NULL, NULL, &data, 3, 12800);
+    }
 
-    data.numsigs = 1;
-    run_benchmark("schnorr_verify", benchmark_schnorr_verify, benchmark_schnorr_init, NULL, &data, 10, 20000);
+    /* Report the speedup of batch verification over verifying one signature at a time. */
+    begin = gettimedouble();
+    benchmark_schnorr_verify(&data, 2560);
+    single = gettimedouble() - begin;
+    for (n = 1; n <= MAX_SIGS; n *= 2) {
+        data.numsigs = n;
+        begin = gettimedouble();
+        for (i = 0; i < 2560; i += n) {
+            CHECK(secp256k1_schnorr_verify_batch(data.ctx, data.sigps, data.msgps, data.pubkeyps, n) == 1);
+        }
+        printf("schnorr_verify_batch%d: speedup %.2fx\n", n, single / (gettimedouble() - begin));
+    }
 
     secp256k1_context_destroy(data.ctx);
     return 0;
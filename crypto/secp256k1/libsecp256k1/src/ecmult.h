@@ -28,4 +28,8 @@ static int secp256k1_ecmult_context_is_built(const secp256k1_ecmult_context *ctx
 /** Double multiply: R = na*A + ng*G */
 static void secp256k1_ecmult(const secp256k1_ecmult_context *ctx, secp256k1_gej *r, const secp256k1_gej *a, const secp256k1_scalar *na, const secp256k1_scalar *ng);
 
+/** Multi-multiply: R = sum(scalars[i] * points[i]) + ng*G, for n points which must be affine.
+ *  Variable time, and temporaries are allocated through cb. */
+static void secp256k1_ecmult_multi_var(const secp256k1_ecmult_context *ctx, secp256k1_gej *r, const secp256k1_ge *points, const secp256k1_scalar *scalars, size_t n, const secp256k1_scalar *ng, const secp256k1_callback *cb);
+
 #endif
@@ -10,6 +10,7 @@
 #include "scalar.h"
 #include "group.h"
 #include "ecmult_const.h"
+#include "opcount.h"
 #include "ecmult_impl.h"
 
 #ifdef USE_ENDOMORPHISM
@@ -135,6 +136,7 @@ static void secp256k1_ecmult_const(secp256k1_gej *r, const secp256k1_ge *a, cons
 
     int i;
     secp256k1_scalar sc = *scalar;
+    SECP256K1_OPCOUNT_INC(ecmult_const);
 
     /* build wnaf representation for q. */
 #ifdef USE_ENDOMORPHISM
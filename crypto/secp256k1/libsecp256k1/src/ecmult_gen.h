@@ -35,6 +35,11 @@ static void secp256k1_ecmult_gen_context_clone(secp256k1_ecmult_gen_context *dst
 static void secp256k1_ecmult_gen_context_clear(secp256k1_ecmult_gen_context* ctx);
 static int secp256k1_ecmult_gen_context_is_built(const secp256k1_ecmult_gen_context* ctx);
 
+/** Fill prec with the table of secp256k1_ecmult_gen_context for an arbitrary base point instead of G.
+ *  The table of a context built this way must be blinded with a non-NULL seed, as resetting the
+ *  blinding assumes the base point is G. */
+static void secp256k1_ecmult_gen_compute_table(secp256k1_ge_storage (*prec)[64][16], const secp256k1_ge *base, const secp256k1_callback* cb);
+
 /** Multiply with the generator: R = a*G */
 static void secp256k1_ecmult_gen(const secp256k1_ecmult_gen_context* ctx, secp256k1_gej *r, const secp256k1_scalar *a);
 
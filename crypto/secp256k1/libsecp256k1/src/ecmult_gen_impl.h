@@ -10,6 +10,7 @@
 #include "scalar.h"
 #include "group.h"
 #include "ecmult_gen.h"
+#include "opcount.h"
 #include "hash_impl.h"
 #ifdef USE_ECMULT_STATIC_PRECOMPUTATION
 #include "ecmult_static_context.h"
@@ -18,22 +19,14 @@ static void secp256k1_ecmult_gen_context_init(secp256k1_ecmult_gen_context *ctx)
     ctx->prec = NULL;
 }
 
-static void secp256k1_ecmult_gen_context_build(secp256k1_ecmult_gen_context *ctx, const secp256k1_callback* cb) {
-#ifndef USE_ECMULT_STATIC_PRECOMPUTATION
-    secp256k1_ge prec[1024];
-    secp256k1_gej gj;
+/* Set prec[j][i] to 16^j * i * base + U_j, see secp256k1_ecmult_gen_context. */
+static void secp256k1_ecmult_gen_compute_table(secp256k1_ge_storage (*prec)[64][16], const secp256k1_ge *base, const secp256k1_callback* cb) {
+    secp256k1_ge *precg = (secp256k1_ge*)checked_malloc(cb, sizeof(secp256k1_ge) * 1024);
+    secp256k1_gej *precj = (secp256k1_gej*)checked_malloc(cb, sizeof(secp256k1_gej) * 1024); /* Jacobian versions of prec. */
+    secp256k1_gej gbase;
+    secp256k1_gej numsbase;
     secp256k1_gej nums_gej;
     int i, j;
-#endif
-
-    if (ctx->prec != NULL) {
-        return;
-    }
-#ifndef USE_ECMULT_STATIC_PRECOMPUTATION
-    ctx->prec = (secp256k1_ge_storage (*)[64][16])checked_malloc(cb, sizeof(*ctx->prec));
-
-    /* get the generator */
-    secp256k1_gej_set_ge(&gj, &secp256k1_ge_const_g);
 
     /* Construct a group element with no known corresponding scalar (nothing up my sleeve). */
     {
@@ -53,37 +46,43 @@ static void secp256k1_ecmult_gen_context_build(secp256k1_ecmult_gen_context *ctx
     }
 
     /* compute prec. */
-    {
-        secp256k1_gej precj[1024]; /* Jacobian versions of prec. */
-        secp256k1_gej gbase;
-        secp256k1_gej numsbase;
-        gbase = gj; /* 16^j * G */
-        numsbase = nums_gej; /* 2^j * nums. */
-        for (j = 0; j < 64; j++) {
-            /* Set precj[j*16 .. j*16+15] to (numsbase, numsbase + gbase, ..., numsbase + 15*gbase). */
-            precj[j*16] = numsbase;
-            for (i = 1; i < 16; i++) {
-                secp256k1_gej_add_var(&precj[j*16 + i], &precj[j*16 + i - 1], &gbase, NULL);
-            }
-            /* Multiply gbase by 16. */
-            for (i = 0; i < 4; i++) {
-                secp256k1_gej_double_var(&gbase, &gbase, NULL);
-            }
-            /* Multiply numbase by 2. */
-            secp256k1_gej_double_var(&numsbase, &numsbase, NULL);
-            if (j == 62) {
-                /* In the last iteration, numsbase is (1 - 2^j) * nums instead. */
-                secp256k1_gej_neg(&numsbase, &numsbase);
-                secp256k1_gej_add_var(&numsbase, &numsbase, &nums_gej, NULL);
-            }
+    secp256k1_gej_set_ge(&gbase, base); /* 16^j * base */
+    numsbase = nums_gej; /* 2^j * nums. */
+    for (j = 0; j < 64; j++) {
+        /* Set precj[j*16 .. j*16+15] to (numsbase, numsbase + gbase, ..., numsbase + 15*gbase). */
+        precj[j*16] = numsbase;
+        for (i = 1; i < 16; i++) {
+            secp256k1_gej_add_var(&precj[j*16 + i], &precj[j*16 + i - 1], &gbase, NULL);
+        }
+        /* Multiply gbase by 16. */
+        for (i = 0; i < 4; i++) {
+            secp256k1_gej_double_var(&gbase, &gbase, NULL);
+        }
+        /* Multiply numbase by 2. */
+        secp256k1_gej_double_var(&numsbase, &numsbase, NULL);
+        if (j == 62) {
+            /* In the last iteration, numsbase is (1 - 2^j) * nums instead. */
+            secp256k1_gej_neg(&numsbase, &numsbase);
+            secp256k1_gej_add_var(&numsbase, &numsbase, &nums_gej, NULL);
         }
-        secp256k1_ge_set_all_gej_var(prec, precj, 1024, cb);
     }
+    secp256k1_ge_set_all_gej_var(precg, precj, 1024, cb);
     for (j = 0; j < 64; j++) {
         for (i = 0; i < 16; i++) {
-            secp256k1_ge_to_storage(&(*ctx->prec)[j][i], &prec[j*16 + i]);
+            secp256k1_ge_to_storage(&(*prec)[j][i], &precg[j*16 + i]);
         }
     }
+    free(precg);
+    free(precj);
+}
+
+static void secp256k1_ecmult_gen_context_build(secp256k1_ecmult_gen_context *ctx, const secp256k1_callback* cb) {
+    if (ctx->prec != NULL) {
+        return;
+    }
+#ifndef USE_ECMULT_STATIC_PRECOMPUTATION
+    ctx->prec = (secp256k1_ge_storage (*)[64][16])checked_malloc(cb, sizeof(*ctx->prec));
+    secp256k1_ecmult_gen_compute_table(ctx->prec, &secp256k1_ge_const_g, cb);
 #else
     (void)cb;
     ctx->prec = (secp256k1_ge_storage (*)[64][16])secp256k1_ecmult_static_context;
@@ -124,11 +123,16 @@ static void secp256k1_ecmult_gen_context_clear(secp256k1_ecmult_gen_context *ctx
 static void secp256k1_ecmult_gen(const secp256k1_ecmult_gen_context *ctx, secp256k1_gej *r, const secp256k1_scalar *gn) {
     secp256k1_ge add;
     secp256k1_ge_storage adds;
+    secp256k1_gep rp;
     secp256k1_scalar gnb;
     int bits;
     int i, j;
+    SECP256K1_OPCOUNT_INC(ecmult_gen);
     memset(&adds, 0, sizeof(adds));
-    *r = ctx->initial;
+    /* Accumulate in projective coordinates, whose complete addition formula needs no
+     * special cases for an infinite or equal accumulator, and is cheaper than the
+     * jacobian constant-time one. */
+    secp256k1_gep_set_gej(&rp, &ctx->initial);
     /* Blind scalar/point multiplication by computing (n-b)G + bG instead of nG. */
     secp256k1_scalar_add(&gnb, gn, &ctx->blind);
     add.infinity = 0;
@@ -148,10 +152,12 @@ static void secp256k1_ecmult_gen(const secp256k1_ecmult_gen_context *ctx, secp25
             secp256k1_ge_storage_cmov(&adds, &(*ctx->prec)[j][i], i == bits);
         }
         secp256k1_ge_from_storage(&add, &adds);
-        secp256k1_gej_add_ge(r, r, &add);
+        secp256k1_gep_add_ge(&rp, &rp, &add);
     }
+    secp256k1_gej_set_gep(r, &rp);
     bits = 0;
     secp256k1_ge_clear(&add);
+    secp256k1_gep_clear(&rp);
     secp256k1_scalar_clear(&gnb);
 }
 
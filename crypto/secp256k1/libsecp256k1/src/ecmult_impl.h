@@ -12,6 +12,7 @@
 #include "group.h"
 #include "scalar.h"
 #include "ecmult.h"
+#include "opcount.h"
 
 #if defined(EXHAUSTIVE_TEST_ORDER)
 /* We need to lower these values for exhaustive tests because
@@ -308,6 +309,7 @@ static void secp256k1_ecmult(const secp256k1_ecmult_context *ctx, secp256k1_gej
 #endif
     int i;
     int bits;
+    SECP256K1_OPCOUNT_INC(ecmult);
 
 #ifdef USE_ENDOMORPHISM
     /* split na into na_1 and na_lam (where na = na_1 + na_lam*lambda, and na_1 and na_lam are ~128 bit) */
@@ -403,4 +405,243 @@ static void secp256k1_ecmult(const secp256k1_ecmult_context *ctx, secp256k1_gej
     }
 }
 
+/** One nonzero wNAF digit: the bit position it applies to and the odd multiple itself. */
+typedef struct {
+    unsigned char pos;
+    int16_t n;
+} secp256k1_ecmult_digit;
+
+/** Nonzero digits of a len-bit wNAF are at least w positions apart, so there are at most this many. */
+#define ECMULT_MAX_DIGITS(len,w) (((len) + (w) - 1) / (w))
+
+/** Convert a number to WNAF notation, storing only its nonzero digits, by ascending position.
+ *  The number becomes represented by sum(2^digits[i].pos * digits[i].n),
+ *  with the following guarantees:
+ *  - each digits[i].n is an odd integer between -(1<<(w-1) - 1) and (1<<(w-1) - 1)
+ *  - two positions are at least w apart, and all are below len.
+ *  - the number of digits is returned. This number is at most ECMULT_MAX_DIGITS(len, w).
+ */
+static int secp256k1_ecmult_wnaf_digits(secp256k1_ecmult_digit *digits, int len, const secp256k1_scalar *a, int w) {
+    secp256k1_scalar s = *a;
+    int count = 0;
+    int bit = 0;
+    int sign = 1;
+    int carry = 0;
+
+    VERIFY_CHECK(digits != NULL);
+    VERIFY_CHECK(0 <= len && len <= 256);
+    VERIFY_CHECK(a != NULL);
+    VERIFY_CHECK(2 <= w && w <= 16);
+
+    if (secp256k1_scalar_get_bits(&s, 255, 1)) {
+        secp256k1_scalar_negate(&s, &s);
+        sign = -1;
+    }
+
+    while (bit < len) {
+        int now;
+        int word;
+        if (secp256k1_scalar_get_bits(&s, bit, 1) == (unsigned int)carry) {
+            bit++;
+            continue;
+        }
+
+        now = w;
+        if (now > len - bit) {
+            now = len - bit;
+        }
+
+        word = secp256k1_scalar_get_bits_var(&s, bit, now) + carry;
+
+        carry = (word >> (w-1)) & 1;
+        word -= carry << w;
+
+        digits[count].pos = bit;
+        digits[count].n = sign * word;
+        count++;
+
+        bit += now;
+    }
+#ifdef VERIFY
+    CHECK(carry == 0);
+    while (bit < 256) {
+        CHECK(secp256k1_scalar_get_bits(&s, bit++, 1) == 0);
+    }
+#endif
+    return count;
+}
+
+/** One nonzero wNAF digit of secp256k1_ecmult_multi_var, with the odd multiples table it selects from. */
+typedef struct {
+    const secp256k1_ge *pre;
+    int16_t n;
+    unsigned char pos;
+} secp256k1_ecmult_multi_digit;
+
+#ifdef USE_ENDOMORPHISM
+/* Every point has a table for itself and one for its lambda image, for scalars split in ~128-bit halves. */
+#  define ECMULT_MULTI_TABLES 2
+#  define ECMULT_MULTI_BITS 130
+#else
+#  define ECMULT_MULTI_TABLES 1
+#  define ECMULT_MULTI_BITS 256
+#endif
+
+/** Whether a scalar is below 2^128, so its wNAF is short without splitting it. */
+static int secp256k1_ecmult_multi_is_short(const secp256k1_scalar *a) {
+    return (secp256k1_scalar_get_bits(a, 128, 32) | secp256k1_scalar_get_bits(a, 160, 32) |
+            secp256k1_scalar_get_bits(a, 192, 32) | secp256k1_scalar_get_bits(a, 224, 32)) == 0;
+}
+
+/* This is Strauss' algorithm: the wNAFs of all scalars are interleaved, so all points share
+ * one chain of doublings. Every point gets a table of ECMULT_TABLE_SIZE(WINDOW_A) odd
+ * multiples, which are converted to affine coordinates with a single shared inversion.
+ * Scalars below 2^128, like the random weights of a batch verification, are not split. */
+static void secp256k1_ecmult_multi_var(const secp256k1_ecmult_context *ctx, secp256k1_gej *r, const secp256k1_ge *points, const secp256k1_scalar *scalars, size_t n, const secp256k1_scalar *ng, const secp256k1_callback *cb) {
+    const size_t tsize = ECMULT_TABLE_SIZE(WINDOW_A);
+    secp256k1_gej *prej = NULL;
+    secp256k1_ge *pre = NULL;
+    secp256k1_ecmult_multi_digit *digits = NULL;
+    secp256k1_ecmult_multi_digit *sched = NULL;
+    secp256k1_ecmult_digit wnaf[ECMULT_MAX_DIGITS(ECMULT_MULTI_BITS, WINDOW_A)];
+    size_t first[ECMULT_MULTI_BITS + 1];
+    size_t next[ECMULT_MULTI_BITS];
+    size_t ndigits = 0;
+    size_t i, k;
+    secp256k1_ge tmpa;
+#ifdef USE_ENDOMORPHISM
+    secp256k1_scalar ng_1, ng_128;
+    int wnaf_ng_1[129];
+    int bits_ng_1;
+    int wnaf_ng_128[129];
+    int bits_ng_128;
+#else
+    int wnaf_ng[256];
+    int bits_ng;
+#endif
+    int bits = 0;
+    int pos;
+    SECP256K1_OPCOUNT_INC(ecmult);
+
+    if (n > 0) {
+        prej = (secp256k1_gej*)checked_malloc(cb, sizeof(secp256k1_gej) * n * tsize);
+        pre = (secp256k1_ge*)checked_malloc(cb, sizeof(secp256k1_ge) * n * tsize * ECMULT_MULTI_TABLES);
+        digits = (secp256k1_ecmult_multi_digit*)checked_malloc(cb, sizeof(secp256k1_ecmult_multi_digit) * n * ECMULT_MULTI_TABLES * ECMULT_MAX_DIGITS(ECMULT_MULTI_BITS, WINDOW_A));
+        sched = (secp256k1_ecmult_multi_digit*)checked_malloc(cb, sizeof(secp256k1_ecmult_multi_digit) * n * ECMULT_MULTI_TABLES * ECMULT_MAX_DIGITS(ECMULT_MULTI_BITS, WINDOW_A));
+    }
+
+    /* Compute the odd multiples of all points, then make them affine in one go. */
+    for (i = 0; i < n; i++) {
+        secp256k1_gej d;
+        VERIFY_CHECK(!points[i].infinity);
+        secp256k1_gej_set_ge(&prej[i * tsize], &points[i]);
+        secp256k1_gej_double_var(&d, &prej[i * tsize], NULL);
+        for (k = 1; k < tsize; k++) {
+            secp256k1_gej_add_var(&prej[i * tsize + k], &prej[i * tsize + k - 1], &d, NULL);
+        }
+    }
+    if (n > 0) {
+        secp256k1_ge_set_all_gej_var(pre, prej, n * tsize, cb);
+    }
+#ifdef USE_ENDOMORPHISM
+    for (k = 0; k < n * tsize; k++) {
+        secp256k1_ge_mul_lambda(&pre[n * tsize + k], &pre[k]);
+    }
+#endif
+
+    /* Collect the nonzero digits of all scalars. */
+    for (i = 0; i < n; i++) {
+        const secp256k1_ge *tables[ECMULT_MULTI_TABLES];
+        secp256k1_scalar parts[ECMULT_MULTI_TABLES];
+        int nparts = 1;
+        int len = ECMULT_MULTI_BITS;
+        int part, count, j;
+
+        tables[0] = &pre[i * tsize];
+        parts[0] = scalars[i];
+        if (secp256k1_ecmult_multi_is_short(&scalars[i])) {
+            len = 129;
+        } else {
+#ifdef USE_ENDOMORPHISM
+            secp256k1_scalar_split_lambda(&parts[0], &parts[1], &scalars[i]);
+            tables[1] = &pre[(n + i) * tsize];
+            nparts = 2;
+#endif
+        }
+        for (part = 0; part < nparts; part++) {
+            count = secp256k1_ecmult_wnaf_digits(wnaf, len, &parts[part], WINDOW_A);
+            for (j = 0; j < count; j++) {
+                digits[ndigits].pre = tables[part];
+                digits[ndigits].n = wnaf[j].n;
+                digits[ndigits].pos = wnaf[j].pos;
+                ndigits++;
+            }
+            if (count > 0 && wnaf[count - 1].pos + 1 > bits) {
+                bits = wnaf[count - 1].pos + 1;
+            }
+        }
+    }
+
+    /* Order them by position with a counting sort, so that the digits at position pos are
+     * sched[first[pos]] up to sched[first[pos + 1]]. */
+    memset(first, 0, sizeof(first));
+    for (k = 0; k < ndigits; k++) {
+        first[digits[k].pos + 1]++;
+    }
+    for (pos = 0; pos < ECMULT_MULTI_BITS; pos++) {
+        first[pos + 1] += first[pos];
+        next[pos] = first[pos];
+    }
+    for (k = 0; k < ndigits; k++) {
+        sched[next[digits[k].pos]++] = digits[k];
+    }
+
+#ifdef USE_ENDOMORPHISM
+    secp256k1_scalar_split_128(&ng_1, &ng_128, ng);
+    bits_ng_1   = secp256k1_ecmult_wnaf(wnaf_ng_1,   129, &ng_1,   WINDOW_G);
+    bits_ng_128 = secp256k1_ecmult_wnaf(wnaf_ng_128, 129, &ng_128, WINDOW_G);
+    if (bits_ng_1 > bits) {
+        bits = bits_ng_1;
+    }
+    if (bits_ng_128 > bits) {
+        bits = bits_ng_128;
+    }
+#else
+    bits_ng     = secp256k1_ecmult_wnaf(wnaf_ng,     256, ng,      WINDOW_G);
+    if (bits_ng > bits) {
+        bits = bits_ng;
+    }
+#endif
+
+    secp256k1_gej_set_infinity(r);
+    for (pos = bits - 1; pos >= 0; pos--) {
+        int m;
+        secp256k1_gej_double_var(r, r, NULL);
+        for (k = first[pos]; k < first[pos + 1]; k++) {
+            ECMULT_TABLE_GET_GE(&tmpa, sched[k].pre, sched[k].n, WINDOW_A);
+            secp256k1_gej_add_ge_var(r, r, &tmpa, NULL);
+        }
+#ifdef USE_ENDOMORPHISM
+        if (pos < bits_ng_1 && (m = wnaf_ng_1[pos])) {
+            ECMULT_TABLE_GET_GE_STORAGE(&tmpa, *ctx->pre_g, m, WINDOW_G);
+            secp256k1_gej_add_ge_var(r, r, &tmpa, NULL);
+        }
+        if (pos < bits_ng_128 && (m = wnaf_ng_128[pos])) {
+            ECMULT_TABLE_GET_GE_STORAGE(&tmpa, *ctx->pre_g_128, m, WINDOW_G);
+            secp256k1_gej_add_ge_var(r, r, &tmpa, NULL);
+        }
+#else
+        if (pos < bits_ng && (m = wnaf_ng[pos])) {
+            ECMULT_TABLE_GET_GE_STORAGE(&tmpa, *ctx->pre_g, m, WINDOW_G);
+            secp256k1_gej_add_ge_var(r, r, &tmpa, NULL);
+        }
+#endif
+    }
+
+    free(prej);
+    free(pre);
+    free(digits);
+    free(sched);
+}
+
 #endif
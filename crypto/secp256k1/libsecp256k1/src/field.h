@@ -105,6 +105,11 @@ static int secp256k1_fe_sqrt(secp256k1_fe *r, const secp256k1_fe *a);
 /** Checks whether a field element is a quadratic residue. */
 static int secp256k1_fe_is_quad_var(const secp256k1_fe *a);
 
+/** Compute the Jacobi symbol (a | p) of a normalized nonzero field element, without constant-time
+ *  guarantee. Returns 1 or -1, or 0 if the result could not be determined, in which case the caller
+ *  has to fall back to secp256k1_fe_sqrt. */
+static int secp256k1_fe_jacobi_var(const secp256k1_fe *a);
+
 /** Sets a field element to be the (modular) inverse of another. Requires the input's magnitude to be
  *  at most 8. The output magnitude is 1 (but not guaranteed to be normalized). */
 static void secp256k1_fe_inv(secp256k1_fe *r, const secp256k1_fe *a);
@@ -112,6 +117,10 @@ static void secp256k1_fe_inv(secp256k1_fe *r, const secp256k1_fe *a);
 /** Potentially faster version of secp256k1_fe_inv, without constant-time guarantee. */
 static void secp256k1_fe_inv_var(secp256k1_fe *r, const secp256k1_fe *a);
 
+/** Compute the inverse of a normalized nonzero field element using posdivsteps, without
+ *  constant-time guarantee. Returns 0 (leaving r undefined) if the computation did not converge. */
+static int secp256k1_fe_inv_divsteps_var(secp256k1_fe *r, const secp256k1_fe *a);
+
 /** Calculate the (modular) inverses of a batch of field elements. Requires the inputs' magnitudes to be
  *  at most 8. The output magnitudes are 1 (but not guaranteed to be normalized). The inputs and
  *  outputs must not overlap in memory. */
@@ -10,6 +10,7 @@
 #include "util.h"
 #include "num.h"
 #include "field.h"
+#include "modinv32_impl.h"
 
 #ifdef VERIFY
 static void secp256k1_fe_verify(const secp256k1_fe *a) {
@@ -1042,6 +1043,7 @@ SECP256K1_INLINE static void secp256k1_fe_sqr_inner(uint32_t *r, const uint32_t
 #endif
 
 static void secp256k1_fe_mul(secp256k1_fe *r, const secp256k1_fe *a, const secp256k1_fe * SECP256K1_RESTRICT b) {
+    SECP256K1_OPCOUNT_INC(fe_mul);
 #ifdef VERIFY
     VERIFY_CHECK(a->magnitude <= 8);
     VERIFY_CHECK(b->magnitude <= 8);
@@ -1058,6 +1060,7 @@ static void secp256k1_fe_mul(secp256k1_fe *r, const secp256k1_fe *a, const secp2
 }
 
 static void secp256k1_fe_sqr(secp256k1_fe *r, const secp256k1_fe *a) {
+    SECP256K1_OPCOUNT_INC(fe_sqr);
 #ifdef VERIFY
     VERIFY_CHECK(a->magnitude <= 8);
     secp256k1_fe_verify(a);
@@ -1137,4 +1140,88 @@ static SECP256K1_INLINE void secp256k1_fe_from_storage(secp256k1_fe *r, const se
 #endif
 }
 
+/* secp256k1 field prime in signed30 notation. */
+static const secp256k1_modinv32_signed30 secp256k1_const_modulus_fe30 = {{
+    0x3FFFFC2FL, 0x3FFFFFFBL, 0x3FFFFFFFL, 0x3FFFFFFFL, 0x3FFFFFFFL,
+    0x3FFFFFFFL, 0x3FFFFFFFL, 0x3FFFFFFFL, 0xFFFFL
+}};
+
+static void secp256k1_fe_to_signed30(secp256k1_modinv32_signed30 *r, const secp256k1_fe *a) {
+    const uint32_t M30 = UINT32_MAX >> 2;
+    const uint32_t a0 = a->n[0], a1 = a->n[1], a2 = a->n[2], a3 = a->n[3], a4 = a->n[4],
+                   a5 = a->n[5], a6 = a->n[6], a7 = a->n[7], a8 = a->n[8], a9 = a->n[9];
+#ifdef VERIFY
+    VERIFY_CHECK(a->normalized);
+#endif
+    r->v[0] = (a0       | a1 << 26) & M30;
+    r->v[1] = (a1 >>  4 | a2 << 22) & M30;
+    r->v[2] = (a2 >>  8 | a3 << 18) & M30;
+    r->v[3] = (a3 >> 12 | a4 << 14) & M30;
+    r->v[4] = (a4 >> 16 | a5 << 10) & M30;
+    r->v[5] = (a5 >> 20 | a6 <<  6) & M30;
+    r->v[6] = (a6 >> 24 | a7 <<  2 | a8 << 28) & M30;
+    r->v[7] = (a8 >>  2 | a9 << 24) & M30;
+    r->v[8] =  a9 >>  6;
+}
+
+static SECP256K1_INLINE void secp256k1_fe_set_u32(secp256k1_fe *r, uint32_t a) {
+    r->n[0] = a & 0x3FFFFFFUL;
+    r->n[1] = a >> 26;
+    r->n[2] = r->n[3] = r->n[4] = r->n[5] = r->n[6] = r->n[7] = r->n[8] = r->n[9] = 0;
+#ifdef VERIFY
+    r->magnitude = 1;
+    r->normalized = 1;
+#endif
+}
+
+static int secp256k1_fe_jacobi_var(const secp256k1_fe *a) {
+    secp256k1_modinv32_signed30 s;
+    secp256k1_fe_to_signed30(&s, a);
+    return secp256k1_jacobi32_maybe_var(&s, &secp256k1_const_modulus_fe30);
+}
+
+static int secp256k1_fe_inv_divsteps_var(secp256k1_fe *r, const secp256k1_fe *a) {
+    /* 2^-30 mod p. */
+    static const secp256k1_fe inv2p30 = SECP256K1_FE_CONST(
+        0x4894D4C3UL, 0xFFFFFFFFUL, 0xFFFFFFFFUL, 0xFFFFFFFFUL,
+        0xFFFFFFFFUL, 0xFFFFFFFFUL, 0xFFFFFFFFUL, 0xB76B2A27UL
+    );
+    secp256k1_modinv32_signed30 x;
+    secp256k1_modinv32_state s;
+    secp256k1_fe d, e, scale;
+    int count;
+
+    /* Track f = d*a*scale and g = e*a*scale (mod p), where scale = 2^(-30*count) undoes the
+     * division performed by every step. Once f = 1, d*scale is the inverse. */
+    secp256k1_fe_to_signed30(&x, a);
+    secp256k1_modinv32_init(&s, &x, &secp256k1_const_modulus_fe30);
+    secp256k1_fe_set_int(&d, 0);
+    secp256k1_fe_set_int(&e, 1);
+    secp256k1_fe_set_int(&scale, 1);
+
+    for (count = 0; count < 50; count++) {
+        secp256k1_modinv32_trans2x2 t;
+        secp256k1_fe c, nd, tmp;
+        int done = secp256k1_modinv32_step_var(&s, &t);
+        secp256k1_fe_set_u32(&c, (uint32_t)t.u);
+        secp256k1_fe_mul(&nd, &d, &c);
+        secp256k1_fe_set_u32(&c, (uint32_t)t.v);
+        secp256k1_fe_mul(&tmp, &e, &c);
+        secp256k1_fe_add(&nd, &tmp);
+        secp256k1_fe_set_u32(&c, (uint32_t)t.r);
+        secp256k1_fe_mul(&e, &e, &c);
+        secp256k1_fe_set_u32(&c, (uint32_t)t.q);
+        secp256k1_fe_mul(&tmp, &d, &c);
+        secp256k1_fe_add(&e, &tmp);
+        d = nd;
+        secp256k1_fe_mul(&scale, &scale, &inv2p30);
+        if (done) {
+            secp256k1_fe_mul(r, &d, &scale);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
 #endif
@@ -15,8 +15,16 @@
 #include "num.h"
 #include "field.h"
 
+#if defined(HAVE___INT128)
+#include "modinv64_impl.h"
+#endif
+
 #if defined(USE_ASM_X86_64)
 #include "field_5x52_asm_impl.h"
+#elif defined(USE_EXTERNAL_ASM)
+/* External assembler implementation */
+void secp256k1_fe_mul_inner(uint64_t *r, const uint64_t *a, const uint64_t * SECP256K1_RESTRICT b);
+void secp256k1_fe_sqr_inner(uint64_t *r, const uint64_t *a);
 #else
 #include "field_5x52_int128_impl.h"
 #endif
@@ -371,6 +379,7 @@ SECP256K1_INLINE static void secp256k1_fe_add(secp256k1_fe *r, const secp256k1_f
 }
 
 static void secp256k1_fe_mul(secp256k1_fe *r, const secp256k1_fe *a, const secp256k1_fe * SECP256K1_RESTRICT b) {
+    SECP256K1_OPCOUNT_INC(fe_mul);
 #ifdef VERIFY
     VERIFY_CHECK(a->magnitude <= 8);
     VERIFY_CHECK(b->magnitude <= 8);
@@ -387,6 +396,7 @@ static void secp256k1_fe_mul(secp256k1_fe *r, const secp256k1_fe *a, const secp2
 }
 
 static void secp256k1_fe_sqr(secp256k1_fe *r, const secp256k1_fe *a) {
+    SECP256K1_OPCOUNT_INC(fe_sqr);
 #ifdef VERIFY
     VERIFY_CHECK(a->magnitude <= 8);
     secp256k1_fe_verify(a);
@@ -448,4 +458,97 @@ static SECP256K1_INLINE void secp256k1_fe_from_storage(secp256k1_fe *r, const se
 #endif
 }
 
+#if defined(HAVE___INT128)
+/* secp256k1 field prime in signed62 notation. */
+static const secp256k1_modinv64_signed62 secp256k1_const_modulus_fe62 = {{
+    0x3FFFFFFEFFFFFC2FLL, 0x3FFFFFFFFFFFFFFFLL, 0x3FFFFFFFFFFFFFFFLL, 0x3FFFFFFFFFFFFFFFLL, 0xFFLL
+}};
+
+static void secp256k1_fe_to_signed62(secp256k1_modinv64_signed62 *r, const secp256k1_fe *a) {
+    const uint64_t M62 = UINT64_MAX >> 2;
+    const uint64_t a0 = a->n[0], a1 = a->n[1], a2 = a->n[2], a3 = a->n[3], a4 = a->n[4];
+#ifdef VERIFY
+    VERIFY_CHECK(a->normalized);
+#endif
+    r->v[0] = (a0       | a1 << 52) & M62;
+    r->v[1] = (a1 >> 10 | a2 << 42) & M62;
+    r->v[2] = (a2 >> 20 | a3 << 32) & M62;
+    r->v[3] = (a3 >> 30 | a4 << 22) & M62;
+    r->v[4] =  a4 >> 40;
+}
+
+static SECP256K1_INLINE void secp256k1_fe_set_u64(secp256k1_fe *r, uint64_t a) {
+    r->n[0] = a & 0xFFFFFFFFFFFFFULL;
+    r->n[1] = a >> 52;
+    r->n[2] = 0;
+    r->n[3] = 0;
+    r->n[4] = 0;
+#ifdef VERIFY
+    r->magnitude = 1;
+    r->normalized = 1;
+#endif
+}
+
+static int secp256k1_fe_jacobi_var(const secp256k1_fe *a) {
+    secp256k1_modinv64_signed62 s;
+    secp256k1_fe_to_signed62(&s, a);
+    return secp256k1_jacobi64_maybe_var(&s, &secp256k1_const_modulus_fe62);
+}
+
+static int secp256k1_fe_inv_divsteps_var(secp256k1_fe *r, const secp256k1_fe *a) {
+    /* 2^-62 mod p. */
+    static const secp256k1_fe inv2p62 = SECP256K1_FE_CONST(
+        0x60E02477UL, 0x4894D4C3UL, 0xFFFFFFFFUL, 0xFFFFFFFFUL,
+        0xFFFFFFFFUL, 0xFFFFFFFFUL, 0xFFFFFFFFUL, 0x9F1FDA17UL
+    );
+    secp256k1_modinv64_signed62 x;
+    secp256k1_modinv64_state s;
+    secp256k1_fe d, e, scale;
+    int count;
+
+    /* Track f = d*a*scale and g = e*a*scale (mod p), where scale = 2^(-62*count) undoes the
+     * division performed by every step. Once f = 1, d*scale is the inverse. */
+    secp256k1_fe_to_signed62(&x, a);
+    secp256k1_modinv64_init(&s, &x, &secp256k1_const_modulus_fe62);
+    secp256k1_fe_set_int(&d, 0);
+    secp256k1_fe_set_int(&e, 1);
+    secp256k1_fe_set_int(&scale, 1);
+
+    for (count = 0; count < 25; count++) {
+        secp256k1_modinv64_trans2x2 t;
+        secp256k1_fe c, nd, tmp;
+        int done = secp256k1_modinv64_step_var(&s, &t);
+        secp256k1_fe_set_u64(&c, (uint64_t)t.u);
+        secp256k1_fe_mul(&nd, &d, &c);
+        secp256k1_fe_set_u64(&c, (uint64_t)t.v);
+        secp256k1_fe_mul(&tmp, &e, &c);
+        secp256k1_fe_add(&nd, &tmp);
+        secp256k1_fe_set_u64(&c, (uint64_t)t.r);
+        secp256k1_fe_mul(&e, &e, &c);
+        secp256k1_fe_set_u64(&c, (uint64_t)t.q);
+        secp256k1_fe_mul(&tmp, &d, &c);
+        secp256k1_fe_add(&e, &tmp);
+        d = nd;
+        secp256k1_fe_mul(&scale, &scale, &inv2p62);
+        if (done) {
+            secp256k1_fe_mul(r, &d, &scale);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+#else
+static int secp256k1_fe_jacobi_var(const secp256k1_fe *a) {
+    (void)a;
+    return 0;
+}
+
+static int secp256k1_fe_inv_divsteps_var(secp256k1_fe *r, const secp256k1_fe *a) {
+    (void)r;
+    (void)a;
+    return 0;
+}
+#endif
+
 #endif
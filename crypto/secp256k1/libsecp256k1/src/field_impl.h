@@ -12,6 +12,7 @@
 #endif
 
 #include "util.h"
+#include "opcount.h"
 
 #if defined(USE_FIELD_10X26)
 #include "field_10x26_impl.h"
@@ -47,6 +48,7 @@ static int secp256k1_fe_sqrt(secp256k1_fe *r, const secp256k1_fe *a) {
      */
     secp256k1_fe x2, x3, x6, x9, x11, x22, x44, x88, x176, x220, x223, t1;
     int j;
+    SECP256K1_OPCOUNT_INC(fe_sqrt);
 
     /** The binary representation of (p + 1)/4 has 3 blocks of 1s, with lengths in
      *  { 2, 22, 223 }. Use an addition chain to calculate 2^n - 1 for each block:
@@ -136,6 +138,7 @@ static int secp256k1_fe_sqrt(secp256k1_fe *r, const secp256k1_fe *a) {
 static void secp256k1_fe_inv(secp256k1_fe *r, const secp256k1_fe *a) {
     secp256k1_fe x2, x3, x6, x9, x11, x22, x44, x88, x176, x220, x223, t1;
     int j;
+    SECP256K1_OPCOUNT_INC(fe_inv);
 
     /** The binary representation of (p - 2) has 5 blocks of 1s, with lengths in
      *  { 1, 2, 22, 223 }. Use an addition chain to calculate 2^n - 1 for each block:
@@ -225,7 +228,20 @@ static void secp256k1_fe_inv(secp256k1_fe *r, const secp256k1_fe *a) {
 
 static void secp256k1_fe_inv_var(secp256k1_fe *r, const secp256k1_fe *a) {
 #if defined(USE_FIELD_INV_BUILTIN)
-    secp256k1_fe_inv(r, a);
+    secp256k1_fe c = *a;
+    SECP256K1_OPCOUNT_INC(fe_inv_var);
+    secp256k1_fe_normalize_var(&c);
+    if (secp256k1_fe_is_zero(&c)) {
+        /* Zero has no inverse; return zero like secp256k1_fe_inv. */
+        *r = c;
+        return;
+    }
+    if (!secp256k1_fe_inv_divsteps_var(r, &c)) {
+        /* Without __int128 the 5x52 field has no divsteps implementation and always ends up
+         * here. Elsewhere this is a safety net only: posdivsteps has no proven bound, but
+         * nonzero inputs have never needed more than about 60% of the steps allowed. */
+        secp256k1_fe_inv(r, a);
+    }
 #elif defined(USE_FIELD_INV_NUM)
     secp256k1_num n, m;
     static const secp256k1_fe negone = SECP256K1_FE_CONST(
@@ -242,6 +258,7 @@ static void secp256k1_fe_inv_var(secp256k1_fe *r, const secp256k1_fe *a) {
     unsigned char b[32];
     int res;
     secp256k1_fe c = *a;
+    SECP256K1_OPCOUNT_INC(fe_inv_var);
     secp256k1_fe_normalize_var(&c);
     secp256k1_fe_get_b32(b, &c);
     secp256k1_num_set_bin(&n, b, 32);
@@ -288,28 +305,21 @@ static void secp256k1_fe_inv_all_var(secp256k1_fe *r, const secp256k1_fe *a, siz
 }
 
 static int secp256k1_fe_is_quad_var(const secp256k1_fe *a) {
-#ifndef USE_NUM_NONE
-    unsigned char b[32];
-    secp256k1_num n;
-    secp256k1_num m;
-    /* secp256k1 field prime, value p defined in "Standards for Efficient Cryptography" (SEC2) 2.7.1. */
-    static const unsigned char prime[32] = {
-        0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
-        0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
-        0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
-        0xFF,0xFF,0xFF,0xFE,0xFF,0xFF,0xFC,0x2F
-    };
-
     secp256k1_fe c = *a;
+    int ret;
+    SECP256K1_OPCOUNT_INC(fe_is_quad_var);
     secp256k1_fe_normalize_var(&c);
-    secp256k1_fe_get_b32(b, &c);
-    secp256k1_num_set_bin(&n, b, 32);
-    secp256k1_num_set_bin(&m, prime, 32);
-    return secp256k1_num_jacobi(&n, &m) >= 0;
-#else
-    secp256k1_fe r;
-    return secp256k1_fe_sqrt(&r, a);
-#endif
+    if (secp256k1_fe_is_zero(&c)) {
+        return 1;
+    }
+    ret = secp256k1_fe_jacobi_var(&c);
+    if (ret == 0) {
+        /* The Jacobi computation did not converge (which does not happen in practice); learn
+         * the answer the slow way. */
+        secp256k1_fe r;
+        return secp256k1_fe_sqrt(&r, &c);
+    }
+    return ret > 0;
 }
 
 #endif
@@ -31,6 +31,14 @@ typedef struct {
 #define SECP256K1_GEJ_CONST(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p) {SECP256K1_FE_CONST((a),(b),(c),(d),(e),(f),(g),(h)), SECP256K1_FE_CONST((i),(j),(k),(l),(m),(n),(o),(p)), SECP256K1_FE_CONST(0, 0, 0, 0, 0, 0, 0, 1), 0}
 #define SECP256K1_GEJ_CONST_INFINITY {SECP256K1_FE_CONST(0, 0, 0, 0, 0, 0, 0, 0), SECP256K1_FE_CONST(0, 0, 0, 0, 0, 0, 0, 0), SECP256K1_FE_CONST(0, 0, 0, 0, 0, 0, 0, 0), 1}
 
+/** A group element of the secp256k1 curve, in homogeneous projective coordinates.
+ *  The point at infinity is any (0, y, 0) with y != 0, so no flag is needed. */
+typedef struct {
+    secp256k1_fe x; /* actual X: x/z */
+    secp256k1_fe y; /* actual Y: y/z */
+    secp256k1_fe z;
+} secp256k1_gep;
+
 typedef struct {
     secp256k1_fe_storage x;
     secp256k1_fe_storage y;
@@ -67,6 +75,10 @@ static void secp256k1_ge_set_gej(secp256k1_ge *r, secp256k1_gej *a);
 /** Set a batch of group elements equal to the inputs given in jacobian coordinates */
 static void secp256k1_ge_set_all_gej_var(secp256k1_ge *r, const secp256k1_gej *a, size_t len, const secp256k1_callback *cb);
 
+/** Set r to the sum of the len (at least 1) affine points in a, which are overwritten. The sum is
+ *  computed as a tree of affine additions, where all additions of one level share an inversion. */
+static void secp256k1_ge_sum_all_var(secp256k1_ge *r, secp256k1_ge *a, size_t len, const secp256k1_callback *cb);
+
 /** Set a batch of group elements equal to the inputs given in jacobian
  *  coordinates (with known z-ratios). zr must contain the known z-ratios such
  *  that mul(a[i].z, zr[i+1]) == a[i+1].z. zr[0] is ignored. */
@@ -110,6 +122,17 @@ static void secp256k1_gej_add_var(secp256k1_gej *r, const secp256k1_gej *a, cons
 /** Set r equal to the sum of a and b (with b given in affine coordinates, and not infinity). */
 static void secp256k1_gej_add_ge(secp256k1_gej *r, const secp256k1_gej *a, const secp256k1_ge *b);
 
+/** Set r equal to the sum of a and b (with b given in affine coordinates, and not infinity).
+ *  Unlike secp256k1_gej_add_ge the formula is complete: a may be infinity, equal to b or
+ *  equal to -b without any special-casing. Constant time. */
+static void secp256k1_gep_add_ge(secp256k1_gep *r, const secp256k1_gep *a, const secp256k1_ge *b);
+
+/** Convert a jacobian group element to projective coordinates. Constant time. */
+static void secp256k1_gep_set_gej(secp256k1_gep *r, const secp256k1_gej *a);
+
+/** Convert a projective group element to jacobian coordinates. Constant time. */
+static void secp256k1_gej_set_gep(secp256k1_gej *r, const secp256k1_gep *a);
+
 /** Set r equal to the sum of a and b (with b given in affine coordinates). This is more efficient
     than secp256k1_gej_add_var. It is identical to secp256k1_gej_add_ge but without constant-time
     guarantee, and b is allowed to be infinity. If rzr is non-NULL, r->z = a->z * *rzr (a cannot be infinity in that case). */
@@ -126,6 +149,9 @@ static void secp256k1_ge_mul_lambda(secp256k1_ge *r, const secp256k1_ge *a);
 /** Clear a secp256k1_gej to prevent leaking sensitive information. */
 static void secp256k1_gej_clear(secp256k1_gej *r);
 
+/** Clear a secp256k1_gep to prevent leaking sensitive information. */
+static void secp256k1_gep_clear(secp256k1_gep *r);
+
 /** Clear a secp256k1_ge to prevent leaking sensitive information. */
 static void secp256k1_ge_clear(secp256k1_ge *r);
 
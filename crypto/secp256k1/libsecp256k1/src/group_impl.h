@@ -10,6 +10,7 @@
 #include "num.h"
 #include "field.h"
 #include "group.h"
+#include "opcount.h"
 
 /* These points can be generated in sage as follows:
  *
@@ -133,10 +134,16 @@ static void secp256k1_ge_set_all_gej_var(secp256k1_ge *r, const secp256k1_gej *a
     size_t count = 0;
     az = (secp256k1_fe *)checked_malloc(cb, sizeof(secp256k1_fe) * len);
     for (i = 0; i < len; i++) {
+        r[i].infinity = a[i].infinity;
         if (!a[i].infinity) {
             az[count++] = a[i].z;
         }
     }
+    if (count == 0) {
+        /* All points are infinity; there is nothing to invert. */
+        free(az);
+        return;
+    }
 
     azi = (secp256k1_fe *)checked_malloc(cb, sizeof(secp256k1_fe) * count);
     secp256k1_fe_inv_all_var(azi, az, count);
@@ -144,7 +151,6 @@ static void secp256k1_ge_set_all_gej_var(secp256k1_ge *r, const secp256k1_gej *a
 
     count = 0;
     for (i = 0; i < len; i++) {
-        r[i].infinity = a[i].infinity;
         if (!a[i].infinity) {
             secp256k1_ge_set_gej_zinv(&r[i], &a[i], &azi[count++]);
         }
@@ -152,6 +158,99 @@ static void secp256k1_ge_set_all_gej_var(secp256k1_ge *r, const secp256k1_gej *a
     free(azi);
 }
 
+static void secp256k1_ge_sum_all_var(secp256k1_ge *r, secp256k1_ge *a, size_t len, const secp256k1_callback *cb) {
+    secp256k1_fe *den;
+    secp256k1_fe *deni;
+    VERIFY_CHECK(len >= 1);
+    den = (secp256k1_fe *)checked_malloc(cb, sizeof(secp256k1_fe) * (len / 2 + 1));
+    deni = (secp256k1_fe *)checked_malloc(cb, sizeof(secp256k1_fe) * (len / 2 + 1));
+
+    /* Every level adds a[2i] and a[2i+1] into a[i], and carries an odd last point along. */
+    while (len > 1) {
+        size_t half = len / 2;
+        size_t i;
+
+        /* Collect the denominators of the slopes: x2 - x1 for an addition, 2*y1 for a
+         * doubling, and 1 where the sum is trivial (an input or the result is infinity). */
+        for (i = 0; i < half; i++) {
+            const secp256k1_ge *p = &a[2 * i];
+            const secp256k1_ge *q = &a[2 * i + 1];
+            secp256k1_fe_set_int(&den[i], 1);
+            if (!p->infinity && !q->infinity) {
+                secp256k1_fe d;
+                secp256k1_fe_negate(&d, &p->x, 1);
+                secp256k1_fe_add(&d, &q->x);
+                if (!secp256k1_fe_normalizes_to_zero_var(&d)) {
+                    den[i] = d;
+                } else {
+                    secp256k1_fe_negate(&d, &p->y, 1);
+                    secp256k1_fe_add(&d, &q->y);
+                    if (secp256k1_fe_normalizes_to_zero_var(&d)) {
+                        den[i] = p->y;
+                        secp256k1_fe_mul_int(&den[i], 2);
+                    }
+                }
+            }
+        }
+        secp256k1_fe_inv_all_var(deni, den, half);
+
+        /* Going forward, a[i] is only written after every pair that reads it is done. */
+        for (i = 0; i < half; i++) {
+            secp256k1_ge p = a[2 * i];
+            const secp256k1_ge *q = &a[2 * i + 1];
+            secp256k1_fe lambda, t;
+            if (p.infinity) {
+                a[i] = *q;
+                continue;
+            }
+            if (q->infinity) {
+                a[i] = p;
+                continue;
+            }
+            secp256k1_fe_negate(&t, &p.x, 1);
+            secp256k1_fe_add(&t, &q->x);
+            if (!secp256k1_fe_normalizes_to_zero_var(&t)) {
+                /* lambda = (y2 - y1) / (x2 - x1) */
+                secp256k1_fe_negate(&lambda, &p.y, 1);
+                secp256k1_fe_add(&lambda, &q->y);
+            } else {
+                secp256k1_fe_negate(&t, &p.y, 1);
+                secp256k1_fe_add(&t, &q->y);
+                if (!secp256k1_fe_normalizes_to_zero_var(&t)) {
+                    /* q = -p */
+                    a[i].infinity = 1;
+                    continue;
+                }
+                /* lambda = 3*x1^2 / (2*y1) */
+                secp256k1_fe_sqr(&lambda, &p.x);
+                secp256k1_fe_mul_int(&lambda, 3);
+            }
+            secp256k1_fe_mul(&lambda, &lambda, &deni[i]);
+            /* x3 = lambda^2 - x1 - x2, y3 = lambda*(x1 - x3) - y1 */
+            secp256k1_fe_sqr(&a[i].x, &lambda);
+            secp256k1_fe_negate(&t, &p.x, 1);
+            secp256k1_fe_add(&a[i].x, &t);
+            secp256k1_fe_negate(&t, &q->x, 1);
+            secp256k1_fe_add(&a[i].x, &t);
+            secp256k1_fe_normalize_weak(&a[i].x);
+            secp256k1_fe_negate(&t, &a[i].x, 1);
+            secp256k1_fe_add(&t, &p.x);
+            secp256k1_fe_mul(&a[i].y, &lambda, &t);
+            secp256k1_fe_negate(&t, &p.y, 1);
+            secp256k1_fe_add(&a[i].y, &t);
+            secp256k1_fe_normalize_weak(&a[i].y);
+            a[i].infinity = 0;
+        }
+        if (len & 1) {
+            a[half] = a[len - 1];
+        }
+        len = half + (len & 1);
+    }
+    *r = a[0];
+    free(den);
+    free(deni);
+}
+
 static void secp256k1_ge_set_table_gej_var(secp256k1_ge *r, const secp256k1_gej *a, const secp256k1_fe *zr, size_t len) {
     size_t i = len - 1;
     secp256k1_fe zi;
@@ -207,6 +306,12 @@ static void secp256k1_gej_clear(secp256k1_gej *r) {
     secp256k1_fe_clear(&r->z);
 }
 
+static void secp256k1_gep_clear(secp256k1_gep *r) {
+    secp256k1_fe_clear(&r->x);
+    secp256k1_fe_clear(&r->y);
+    secp256k1_fe_clear(&r->z);
+}
+
 static void secp256k1_ge_clear(secp256k1_ge *r) {
     r->infinity = 0;
     secp256k1_fe_clear(&r->x);
@@ -317,6 +422,7 @@ static void secp256k1_gej_double_var(secp256k1_gej *r, const secp256k1_gej *a, s
      *  the infinity flag even though the point doubles to infinity, and the result
      *  point will be gibberish (z = 0 but infinity = 0).
      */
+    SECP256K1_OPCOUNT_INC(gej_double_var);
     r->infinity = a->infinity;
     if (r->infinity) {
         if (rzr != NULL) {
@@ -361,6 +467,7 @@ static SECP256K1_INLINE void secp256k1_gej_double_nonzero(secp256k1_gej *r, cons
 static void secp256k1_gej_add_var(secp256k1_gej *r, const secp256k1_gej *a, const secp256k1_gej *b, secp256k1_fe *rzr) {
     /* Operations: 12 mul, 4 sqr, 2 normalize, 12 mul_int/add/negate */
     secp256k1_fe z22, z12, u1, u2, s1, s2, h, i, i2, h2, h3, t;
+    SECP256K1_OPCOUNT_INC(gej_add_var);
 
     if (a->infinity) {
         VERIFY_CHECK(rzr == NULL);
@@ -414,6 +521,7 @@ static void secp256k1_gej_add_var(secp256k1_gej *r, const secp256k1_gej *a, cons
 static void secp256k1_gej_add_ge_var(secp256k1_gej *r, const secp256k1_gej *a, const secp256k1_ge *b, secp256k1_fe *rzr) {
     /* 8 mul, 3 sqr, 4 normalize, 12 mul_int/add/negate */
     secp256k1_fe z12, u1, u2, s1, s2, h, i, i2, h2, h3, t;
+    SECP256K1_OPCOUNT_INC(gej_add_ge_var);
     if (a->infinity) {
         VERIFY_CHECK(rzr == NULL);
         secp256k1_gej_set_ge(r, b);
@@ -463,6 +571,7 @@ static void secp256k1_gej_add_ge_var(secp256k1_gej *r, const secp256k1_gej *a, c
 static void secp256k1_gej_add_zinv_var(secp256k1_gej *r, const secp256k1_gej *a, const secp256k1_ge *b, const secp256k1_fe *bzinv) {
     /* 9 mul, 3 sqr, 4 normalize, 12 mul_int/add/negate */
     secp256k1_fe az, z12, u1, u2, s1, s2, h, i, i2, h2, h3, t;
+    SECP256K1_OPCOUNT_INC(gej_add_zinv_var);
 
     if (b->infinity) {
         *r = *a;
@@ -523,6 +632,7 @@ static void secp256k1_gej_add_ge(secp256k1_gej *r, const secp256k1_gej *a, const
     secp256k1_fe zz, u1, u2, s1, s2, t, tt, m, n, q, rr;
     secp256k1_fe m_alt, rr_alt;
     int infinity, degenerate;
+    SECP256K1_OPCOUNT_INC(gej_add_ge);
     VERIFY_CHECK(!b->infinity);
     VERIFY_CHECK(a->infinity == 0 || a->infinity == 1);
 
@@ -639,6 +749,87 @@ static void secp256k1_gej_add_ge(secp256k1_gej *r, const secp256k1_gej *a, const
     r->infinity = infinity;
 }
 
+static void secp256k1_gep_add_ge(secp256k1_gep *r, const secp256k1_gep *a, const secp256k1_ge *b) {
+    /* Operations: 11 mul, 5 normalize_weak, 16 mul_int/add/negate */
+    secp256k1_fe t0, t1, t2, t3, t4, x3, y3, z3;
+    SECP256K1_OPCOUNT_INC(gep_add_ge);
+    VERIFY_CHECK(!b->infinity);
+
+    /** Algorithm 8 (mixed addition for a = 0) of:
+     *    Joost Renes, Craig Costello and Lejla Batina, Complete addition formulas for prime
+     *    order elliptic curves. In EUROCRYPT 2016, vol. 9665 of Lecture Notes in Computer Science,
+     *    pages 403-428. Springer-Verlag, 2016.
+     *  with b3 = 3*CURVE_B. It is correct for every projective a, including infinity and +-b,
+     *  because the curve has prime order. The magnitudes below assume those of a are at most
+     *  (3, 2, 2), which holds for the outputs of this function and of secp256k1_gep_set_gej.
+     */
+    secp256k1_fe_mul(&t0, &a->x, &b->x);                /* t0 = X1*X2 (1) */
+    secp256k1_fe_mul(&t1, &a->y, &b->y);                /* t1 = Y1*Y2 (1) */
+    t3 = b->x; secp256k1_fe_add(&t3, &b->y);
+    secp256k1_fe_normalize_weak(&t3);                   /* t3 = X2+Y2 (1) */
+    t4 = a->x; secp256k1_fe_add(&t4, &a->y);            /* t4 = X1+Y1 (5) */
+    secp256k1_fe_mul(&t3, &t3, &t4);                    /* t3 = (X2+Y2)*(X1+Y1) (1) */
+    secp256k1_fe_negate(&t4, &t0, 1);
+    secp256k1_fe_add(&t3, &t4);
+    secp256k1_fe_negate(&t4, &t1, 1);
+    secp256k1_fe_add(&t3, &t4);                         /* t3 = X1*Y2+X2*Y1 (5) */
+    secp256k1_fe_mul(&t4, &b->y, &a->z);
+    secp256k1_fe_add(&t4, &a->y);                       /* t4 = Y2*Z1+Y1 (3) */
+    secp256k1_fe_mul(&y3, &b->x, &a->z);
+    secp256k1_fe_add(&y3, &a->x);                       /* y3 = X2*Z1+X1 (4) */
+    secp256k1_fe_normalize_weak(&y3);
+    secp256k1_fe_mul_int(&y3, 3 * CURVE_B);
+    secp256k1_fe_normalize_weak(&y3);                   /* y3 = b3*(X2*Z1+X1) (1) */
+    t2 = a->z; secp256k1_fe_normalize_weak(&t2);
+    secp256k1_fe_mul_int(&t2, 3 * CURVE_B);
+    secp256k1_fe_normalize_weak(&t2);                   /* t2 = b3*Z1 (1) */
+    secp256k1_fe_mul_int(&t0, 3);                       /* t0 = 3*X1*X2 (3) */
+    z3 = t1; secp256k1_fe_add(&z3, &t2);                /* z3 = Y1*Y2+b3*Z1 (2) */
+    secp256k1_fe_negate(&t2, &t2, 1);
+    secp256k1_fe_add(&t1, &t2);                         /* t1 = Y1*Y2-b3*Z1 (3) */
+    secp256k1_fe_mul(&x3, &t4, &y3);                    /* x3 = t4*y3 (1) */
+    secp256k1_fe_mul(&t2, &t3, &t1);                    /* t2 = t3*t1 (1) */
+    secp256k1_fe_negate(&x3, &x3, 1);
+    secp256k1_fe_add(&x3, &t2);                         /* x3 = t3*t1-t4*y3 (3) */
+    secp256k1_fe_mul(&y3, &y3, &t0);                    /* y3 = y3*t0 (1) */
+    secp256k1_fe_mul(&t1, &t1, &z3);                    /* t1 = t1*z3 (1) */
+    secp256k1_fe_add(&y3, &t1);                         /* y3 = t1*z3+y3*t0 (2) */
+    secp256k1_fe_mul(&t0, &t0, &t3);                    /* t0 = t0*t3 (1) */
+    secp256k1_fe_mul(&z3, &z3, &t4);                    /* z3 = z3*t4 (1) */
+    secp256k1_fe_add(&z3, &t0);                         /* z3 = z3*t4+t0*t3 (2) */
+    r->x = x3;
+    r->y = y3;
+    r->z = z3;
+}
+
+static void secp256k1_gep_set_gej(secp256k1_gep *r, const secp256k1_gej *a) {
+    /* (X, Y, Z) jacobian is (X*Z, Y, Z^3) projective. Infinity becomes (0, 1, 0). */
+    static const secp256k1_fe fe_1 = SECP256K1_FE_CONST(0, 0, 0, 0, 0, 0, 0, 1);
+    secp256k1_fe x = a->x, z = a->z, zz;
+    secp256k1_fe_normalize_weak(&x);
+    secp256k1_fe_normalize_weak(&z);
+    secp256k1_fe_sqr(&zz, &z);
+    secp256k1_fe_mul(&r->x, &x, &z);
+    r->y = a->y;
+    secp256k1_fe_normalize_weak(&r->y);
+    secp256k1_fe_mul(&r->z, &zz, &z);
+    secp256k1_fe_clear(&zz);
+    secp256k1_fe_cmov(&r->x, &zz, a->infinity);
+    secp256k1_fe_cmov(&r->y, &fe_1, a->infinity);
+    secp256k1_fe_cmov(&r->z, &zz, a->infinity);
+}
+
+static void secp256k1_gej_set_gep(secp256k1_gej *r, const secp256k1_gep *a) {
+    /* (X, Y, Z) projective is (X*Z, Y*Z^2, Z) jacobian. */
+    secp256k1_fe zz;
+    secp256k1_fe_sqr(&zz, &a->z);
+    secp256k1_fe_mul(&r->x, &a->x, &a->z);
+    secp256k1_fe_mul(&r->y, &a->y, &zz);
+    r->z = a->z;
+    secp256k1_fe_normalize_weak(&r->z);
+    r->infinity = secp256k1_fe_normalizes_to_zero(&r->z);
+}
+
 static void secp256k1_gej_rescale(secp256k1_gej *r, const secp256k1_fe *s) {
     /* Operations: 4 mul, 1 sqr */
     secp256k1_fe zz;
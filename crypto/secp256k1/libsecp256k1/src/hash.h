@@ -28,6 +28,24 @@ static void secp256k1_hmac_sha256_initialize(secp256k1_hmac_sha256_t *hash, cons
 static void secp256k1_hmac_sha256_write(secp256k1_hmac_sha256_t *hash, const unsigned char *data, size_t size);
 static void secp256k1_hmac_sha256_finalize(secp256k1_hmac_sha256_t *hash, unsigned char *out32);
 
+typedef struct {
+    uint64_t s[8];
+    unsigned char buf[128];
+    size_t bytes;
+} secp256k1_sha512_t;
+
+static void secp256k1_sha512_initialize(secp256k1_sha512_t *hash);
+static void secp256k1_sha512_write(secp256k1_sha512_t *hash, const unsigned char *data, size_t size);
+static void secp256k1_sha512_finalize(secp256k1_sha512_t *hash, unsigned char *out64);
+
+typedef struct {
+    secp256k1_sha512_t inner, outer;
+} secp256k1_hmac_sha512_t;
+
+static void secp256k1_hmac_sha512_initialize(secp256k1_hmac_sha512_t *hash, const unsigned char *key, size_t size);
+static void secp256k1_hmac_sha512_write(secp256k1_hmac_sha512_t *hash, const unsigned char *data, size_t size);
+static void secp256k1_hmac_sha512_finalize(secp256k1_hmac_sha512_t *hash, unsigned char *out64);
+
 typedef struct {
     unsigned char v[32];
     unsigned char k[32];
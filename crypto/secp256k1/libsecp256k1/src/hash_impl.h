@@ -13,6 +13,14 @@
 #include <stdint.h>
 #include <string.h>
 
+#if defined(USE_ASM_AARCH64) && defined(HAVE_SYS_AUXV_H) && defined(HAVE_GETAUXVAL)
+#define USE_SHA256_ARMV8 1
+#include <sys/auxv.h>
+#ifndef HWCAP_SHA2
+#define HWCAP_SHA2 (1 << 6)
+#endif
+#endif
+
 #define Ch(x,y,z) ((z) ^ ((x) & ((y) ^ (z))))
 #define Maj(x,y,z) (((x) & (y)) | ((z) & ((x) | (y))))
 #define Sigma0(x) (((x) >> 2 | (x) << 30) ^ ((x) >> 13 | (x) << 19) ^ ((x) >> 22 | (x) << 10))
@@ -128,6 +136,25 @@ static void secp256k1_sha256_transform(uint32_t* s, const uint32_t* chunk) {
     s[7] += h;
 }
 
+#ifdef USE_SHA256_ARMV8
+/* External assembler implementation using the ARMv8 SHA-2 instructions */
+void secp256k1_sha256_transform_armv8(uint32_t* s, const uint32_t* chunk);
+
+/* 0 until the first transformation, then 1 if HWCAP_SHA2 is absent and 2 if present.
+ * Hashing needs no context, so this cannot be set up at context creation. Threads may
+ * race to detect it, but they all store the same value, so relaxed atomics suffice. */
+static int secp256k1_sha256_armv8 = 0;
+
+static int secp256k1_sha256_have_armv8(void) {
+    int have = __atomic_load_n(&secp256k1_sha256_armv8, __ATOMIC_RELAXED);
+    if (have == 0) {
+        have = (getauxval(AT_HWCAP) & HWCAP_SHA2) ? 2 : 1;
+        __atomic_store_n(&secp256k1_sha256_armv8, have, __ATOMIC_RELAXED);
+    }
+    return have == 2;
+}
+#endif
+
 static void secp256k1_sha256_write(secp256k1_sha256_t *hash, const unsigned char *data, size_t len) {
     size_t bufsize = hash->bytes & 0x3F;
     hash->bytes += len;
@@ -136,6 +163,11 @@ static void secp256k1_sha256_write(secp256k1_sha256_t *hash, const unsigned char
         memcpy(((unsigned char*)hash->buf) + bufsize, data, 64 - bufsize);
         data += 64 - bufsize;
         len -= 64 - bufsize;
+#ifdef USE_SHA256_ARMV8
+        if (secp256k1_sha256_have_armv8()) {
+            secp256k1_sha256_transform_armv8(hash->s, hash->buf);
+        } else
+#endif
         secp256k1_sha256_transform(hash->s, hash->buf);
         bufsize = 0;
     }
@@ -202,6 +234,170 @@ static void secp256k1_hmac_sha256_finalize(secp256k1_hmac_sha256_t *hash, unsign
 }
 
 
+static void secp256k1_sha512_initialize(secp256k1_sha512_t *hash) {
+    hash->s[0] = 0x6a09e667f3bcc908ULL;
+    hash->s[1] = 0xbb67ae8584caa73bULL;
+    hash->s[2] = 0x3c6ef372fe94f82bULL;
+    hash->s[3] = 0xa54ff53a5f1d36f1ULL;
+    hash->s[4] = 0x510e527fade682d1ULL;
+    hash->s[5] = 0x9b05688c2b3e6c1fULL;
+    hash->s[6] = 0x1f83d9abfb41bd6bULL;
+    hash->s[7] = 0x5be0cd19137e2179ULL;
+    hash->bytes = 0;
+}
+
+#define Ch64(x,y,z) ((z) ^ ((x) & ((y) ^ (z))))
+#define Maj64(x,y,z) (((x) & (y)) | ((z) & ((x) | (y))))
+#define ROTR64(x,n) ((x) >> (n) | (x) << (64 - (n)))
+#define Sigma0_64(x) (ROTR64(x, 28) ^ ROTR64(x, 34) ^ ROTR64(x, 39))
+#define Sigma1_64(x) (ROTR64(x, 14) ^ ROTR64(x, 18) ^ ROTR64(x, 41))
+#define sigma0_64(x) (ROTR64(x, 1) ^ ROTR64(x, 8) ^ ((x) >> 7))
+#define sigma1_64(x) (ROTR64(x, 19) ^ ROTR64(x, 61) ^ ((x) >> 6))
+
+/** Perform one SHA-512 transformation, processing 128 bytes. */
+static void secp256k1_sha512_transform(uint64_t* s, const unsigned char* chunk) {
+    static const uint64_t k[80] = {
+        0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+        0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+        0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+        0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+        0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+        0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+        0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+        0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+        0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+        0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+        0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+        0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+        0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+        0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+        0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+        0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+        0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+        0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+        0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+        0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL,
+    };
+    uint64_t w[16];
+    uint64_t a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+    int i, j;
+
+    for (i = 0; i < 16; i++) {
+        w[i] = 0;
+        for (j = 0; j < 8; j++) {
+            w[i] = (w[i] << 8) | chunk[i * 8 + j];
+        }
+    }
+    for (i = 0; i < 80; i++) {
+        uint64_t t1, t2;
+        if (i >= 16) {
+            w[i & 15] += sigma1_64(w[(i + 14) & 15]) + w[(i + 9) & 15] + sigma0_64(w[(i + 1) & 15]);
+        }
+        t1 = h + Sigma1_64(e) + Ch64(e, f, g) + k[i] + w[i & 15];
+        t2 = Sigma0_64(a) + Maj64(a, b, c);
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    s[0] += a;
+    s[1] += b;
+    s[2] += c;
+    s[3] += d;
+    s[4] += e;
+    s[5] += f;
+    s[6] += g;
+    s[7] += h;
+}
+
+#undef sigma1_64
+#undef sigma0_64
+#undef Sigma1_64
+#undef Sigma0_64
+#undef ROTR64
+#undef Maj64
+#undef Ch64
+
+static void secp256k1_sha512_write(secp256k1_sha512_t *hash, const unsigned char *data, size_t len) {
+    size_t bufsize = hash->bytes & 0x7F;
+    hash->bytes += len;
+    while (bufsize + len >= 128) {
+        /* Fill the buffer, and process it. */
+        memcpy(hash->buf + bufsize, data, 128 - bufsize);
+        data += 128 - bufsize;
+        len -= 128 - bufsize;
+        secp256k1_sha512_transform(hash->s, hash->buf);
+        bufsize = 0;
+    }
+    if (len) {
+        /* Fill the buffer with what remains. */
+        memcpy(hash->buf + bufsize, data, len);
+    }
+}
+
+static void secp256k1_sha512_finalize(secp256k1_sha512_t *hash, unsigned char *out64) {
+    static const unsigned char pad[128] = {0x80};
+    unsigned char sizedesc[16];
+    uint64_t bits = (uint64_t)hash->bytes << 3;
+    int i;
+    /* The length is a 128-bit number; sizes of 2^61 bytes or more are not supported. */
+    memset(sizedesc, 0, 8);
+    for (i = 0; i < 8; i++) {
+        sizedesc[15 - i] = (unsigned char)(bits >> (i * 8));
+    }
+    secp256k1_sha512_write(hash, pad, 1 + ((239 - (hash->bytes % 128)) % 128));
+    secp256k1_sha512_write(hash, sizedesc, 16);
+    for (i = 0; i < 64; i++) {
+        out64[i] = (unsigned char)(hash->s[i / 8] >> (56 - (i % 8) * 8));
+    }
+    memset(hash->s, 0, sizeof(hash->s));
+}
+
+static void secp256k1_hmac_sha512_initialize(secp256k1_hmac_sha512_t *hash, const unsigned char *key, size_t keylen) {
+    int n;
+    unsigned char rkey[128];
+    if (keylen <= 128) {
+        memcpy(rkey, key, keylen);
+        memset(rkey + keylen, 0, 128 - keylen);
+    } else {
+        secp256k1_sha512_t sha512;
+        secp256k1_sha512_initialize(&sha512);
+        secp256k1_sha512_write(&sha512, key, keylen);
+        secp256k1_sha512_finalize(&sha512, rkey);
+        memset(rkey + 64, 0, 64);
+    }
+
+    secp256k1_sha512_initialize(&hash->outer);
+    for (n = 0; n < 128; n++) {
+        rkey[n] ^= 0x5c;
+    }
+    secp256k1_sha512_write(&hash->outer, rkey, 128);
+
+    secp256k1_sha512_initialize(&hash->inner);
+    for (n = 0; n < 128; n++) {
+        rkey[n] ^= 0x5c ^ 0x36;
+    }
+    secp256k1_sha512_write(&hash->inner, rkey, 128);
+    memset(rkey, 0, 128);
+}
+
+static void secp256k1_hmac_sha512_write(secp256k1_hmac_sha512_t *hash, const unsigned char *data, size_t size) {
+    secp256k1_sha512_write(&hash->inner, data, size);
+}
+
+static void secp256k1_hmac_sha512_finalize(secp256k1_hmac_sha512_t *hash, unsigned char *out64) {
+    unsigned char temp[64];
+    secp256k1_sha512_finalize(&hash->inner, temp);
+    secp256k1_sha512_write(&hash->outer, temp, 64);
+    memset(temp, 0, 64);
+    secp256k1_sha512_finalize(&hash->outer, out64);
+}
+
 static void secp256k1_rfc6979_hmac_sha256_initialize(secp256k1_rfc6979_hmac_sha256_t *rng, const unsigned char *key, size_t keylen) {
     secp256k1_hmac_sha256_t hmac;
     static const unsigned char zero[1] = {0x00};
@@ -180,6 +180,123 @@ public class NativeSecp256k1 {
         return retVal == 0 ? new byte[0]: pubArr;
     }
 
+    /**
+     * Returns the size of the direct buffer needed by verifyBatch.
+     *
+     * @param n Number of signatures
+     * @param pubLen Length of the public keys, 33 or 65
+     */
+    public static int verifyBatchSize(int n, int pubLen) {
+        return n * (32 + 64 + pubLen + 1);
+    }
+
+    /**
+     * libsecp256k1 batch verify - verifies n signatures with one native call
+     *
+     * The buffer holds n records of a 32-byte message hash, a 64-byte compact signature
+     * and a public key of pubLen bytes, followed by room for n status bytes, which are
+     * set to 1 for a valid and 0 for an invalid signature.
+     *
+     * @param buf Direct buffer of at least verifyBatchSize(n, pubLen) bytes
+     * @param n Number of signatures
+     * @param pubLen Length of the public keys, 33 or 65
+     *
+     * Return values
+     * @return the number of valid signatures
+     */
+    public static int verifyBatch(ByteBuffer buf, int n, int pubLen) throws AssertFailException{
+        Preconditions.checkArgument(buf.isDirect() && n >= 0 && (pubLen == 33 || pubLen == 65));
+        Preconditions.checkArgument(buf.capacity() >= verifyBatchSize(n, pubLen));
+
+        int retVal;
+        r.lock();
+        try {
+          retVal = secp256k1_ecdsa_verify_batch(buf, Secp256k1Context.getContext(), n, pubLen);
+        } finally {
+          r.unlock();
+        }
+
+        assertEquals(retVal >= 0, true, "Failed return value check.");
+        return retVal;
+    }
+
+    /**
+     * Returns the size of the direct buffer needed by signBatch.
+     *
+     * @param n Number of signatures
+     */
+    public static int signBatchSize(int n) {
+        return n * (32 + 32 + 64 + 1);
+    }
+
+    /**
+     * libsecp256k1 batch sign - creates n ECDSA signatures with one native call
+     *
+     * The buffer holds n records of a 32-byte message hash and a 32-byte secret key. The
+     * n 64-byte compact signatures are written behind the records, followed by n status
+     * bytes. The secret keys are cleared from the buffer.
+     *
+     * @param buf Direct buffer of at least signBatchSize(n) bytes
+     * @param n Number of signatures
+     *
+     * Return values
+     * @return the number of signatures created
+     */
+    public static int signBatch(ByteBuffer buf, int n) throws AssertFailException{
+        Preconditions.checkArgument(buf.isDirect() && n >= 0);
+        Preconditions.checkArgument(buf.capacity() >= signBatchSize(n));
+
+        int retVal;
+        r.lock();
+        try {
+          retVal = secp256k1_ecdsa_sign_batch(buf, Secp256k1Context.getContext(), n);
+        } finally {
+          r.unlock();
+        }
+
+        assertEquals(retVal >= 0, true, "Failed return value check.");
+        return retVal;
+    }
+
+    /**
+     * Returns the size of the direct buffer needed by computePubkeyBatch.
+     *
+     * @param n Number of secret keys
+     * @param pubLen Length of the public keys, 33 or 65
+     */
+    public static int computePubkeyBatchSize(int n, int pubLen) {
+        return n * (32 + pubLen + 1);
+    }
+
+    /**
+     * libsecp256k1 batch compute pubkey - computes n public keys with one native call
+     *
+     * The buffer holds n 32-byte secret keys. The n public keys of pubLen bytes are written
+     * behind them, followed by n status bytes. The secret keys are cleared from the buffer.
+     *
+     * @param buf Direct buffer of at least computePubkeyBatchSize(n, pubLen) bytes
+     * @param n Number of secret keys
+     * @param pubLen Length of the public keys, 33 (compressed) or 65 (uncompressed)
+     *
+     * Return values
+     * @return the number of public keys computed
+     */
+    public static int computePubkeyBatch(ByteBuffer buf, int n, int pubLen) throws AssertFailException{
+        Preconditions.checkArgument(buf.isDirect() && n >= 0 && (pubLen == 33 || pubLen == 65));
+        Preconditions.checkArgument(buf.capacity() >= computePubkeyBatchSize(n, pubLen));
+
+        int retVal;
+        r.lock();
+        try {
+          retVal = secp256k1_ec_pubkey_create_batch(buf, Secp256k1Context.getContext(), n, pubLen);
+        } finally {
+          r.unlock();
+        }
+
+        assertEquals(retVal >= 0, true, "Failed return value check.");
+        return retVal;
+    }
+
     /**
      * libsecp256k1 Cleanup - This destroys the secp256k1 context object
      * This should be called at the end of the program for proper cleanup of the context.
@@ -443,4 +560,10 @@ public class NativeSecp256k1 {
 
     private static native byte[][] secp256k1_ecdh(ByteBuffer byteBuff, long context, int inputLen);
 
+    private static native int secp256k1_ecdsa_verify_batch(ByteBuffer byteBuff, long context, int n, int pubLen);
+
+    private static native int secp256k1_ecdsa_sign_batch(ByteBuffer byteBuff, long context, int n);
+
+    private static native int secp256k1_ec_pubkey_create_batch(ByteBuffer byteBuff, long context, int n, int pubLen);
+
 }
@@ -1,6 +1,7 @@
 package org.bitcoin;
 
 import com.google.common.io.BaseEncoding;
+import java.nio.ByteBuffer;
 import java.util.Arrays;
 import java.math.BigInteger;
 import javax.xml.bind.DatatypeConverter;
@@ -177,6 +178,42 @@ public class NativeSecp256k1Test {
         assertEquals( ecdhString, "2A2A67007A926E6594AF3EB564FC74005B37A9C8AEF2033C4552051B5C87F043" , "testCreateECDHSecret");
     }
 
+    /**
+      * This tests the batch functions against the single-item vectors above
+      */
+    public static void testBatch() throws AssertFailException{
+        byte[] data = BaseEncoding.base16().lowerCase().decode("CF80CD8AED482D5D1527D7DC72FCEFF84E6326592848447D2DC0B0E87DFC9A90".toLowerCase()); //sha256hash of "testing"
+        byte[] sec = BaseEncoding.base16().lowerCase().decode("67E56582298859DDAE725F972992A07C6C4FB9F62A8FFF58CE3CA926A1063530".toLowerCase());
+        byte[] bad = BaseEncoding.base16().lowerCase().decode("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF".toLowerCase());
+        byte[] sig = BaseEncoding.base16().lowerCase().decode("182A108E1448DC8F1FB467D06A0F3BB8EA0533584CB954EF8DA112F1D60E39A21C66F36DA211C087F3AF88B50EDF4F9BDAA6CF5FD6817E74DCA34DB12390C6E9".toLowerCase());
+        byte[] pub = BaseEncoding.base16().lowerCase().decode("04C591A8FF19AC9C4E4E5793673B83123437E975285E7B442F4EE2654DFFCA5E2D2103ED494718C697AC9AEBCFD19612E224DB46661011863ED2FC54E71861E2A6".toLowerCase());
+        byte[] out = new byte[65];
+
+        ByteBuffer buf = ByteBuffer.allocateDirect(NativeSecp256k1.signBatchSize(2));
+        buf.put(data).put(sec).put(data).put(bad);
+        assertEquals(NativeSecp256k1.signBatch(buf, 2), 1, "testBatch sign");
+        buf.position(128);
+        buf.get(out, 0, 64);
+        assertEquals(DatatypeConverter.printHexBinary(Arrays.copyOf(out, 64)), DatatypeConverter.printHexBinary(sig), "testBatch sign result");
+        assertEquals(buf.get(256) == 1 && buf.get(257) == 0, true, "testBatch sign status");
+        assertEquals(buf.get(32) == 0 && buf.get(63) == 0, true, "testBatch sign clears keys");
+
+        buf = ByteBuffer.allocateDirect(NativeSecp256k1.computePubkeyBatchSize(2, 65));
+        buf.put(bad).put(sec);
+        assertEquals(NativeSecp256k1.computePubkeyBatch(buf, 2, 65), 1, "testBatch pubkey");
+        buf.position(64 + 65);
+        buf.get(out, 0, 65);
+        assertEquals(DatatypeConverter.printHexBinary(out), DatatypeConverter.printHexBinary(pub), "testBatch pubkey result");
+        assertEquals(buf.get(194) == 0 && buf.get(195) == 1, true, "testBatch pubkey status");
+
+        buf = ByteBuffer.allocateDirect(NativeSecp256k1.verifyBatchSize(2, 65));
+        buf.put(data).put(sig).put(pub);
+        data[0] ^= 1;
+        buf.put(data).put(sig).put(pub);
+        assertEquals(NativeSecp256k1.verifyBatch(buf, 2, 65), 1, "testBatch verify");
+        assertEquals(buf.get(2 * 161) == 1 && buf.get(2 * 161 + 1) == 0, true, "testBatch verify status");
+    }
+
     public static void main(String[] args) throws AssertFailException{
 
 
@@ -218,6 +255,9 @@ public class NativeSecp256k1Test {
         //Test ECDH
         testCreateECDHSecret();
 
+        //Test batch functions
+        testBatch();
+
         NativeSecp256k1.cleanup();
 
         System.out.println(" All tests passed." );
@@ -375,3 +375,120 @@ SECP256K1_API jobjectArray JNICALL Java_org_bitcoin_NativeSecp256k1_secp256k1_1e
 
   return retArray;
 }
+
+/* The batch functions below read n fixed-size records from a direct buffer and write their
+ * outputs behind the records, followed by one status byte per record (1 on success, 0 on
+ * failure). They return the number of successful records, or -1 if the buffer is not a
+ * direct buffer or too small. Nothing is allocated on the Java heap. */
+
+static unsigned char* secp256k1_jni_batch_buffer(JNIEnv* env, jobject byteBufferObject, jint n, jlong len)
+{
+  unsigned char* data = (unsigned char*) (*env)->GetDirectBufferAddress(env, byteBufferObject);
+
+  if (data == NULL || n < 0 || (*env)->GetDirectBufferCapacity(env, byteBufferObject) < len) {
+    return NULL;
+  }
+  return data;
+}
+
+SECP256K1_API jint JNICALL Java_org_bitcoin_NativeSecp256k1_secp256k1_1ecdsa_1verify_1batch
+  (JNIEnv* env, jclass classObject, jobject byteBufferObject, jlong ctx_l, jint n, jint publen)
+{
+  secp256k1_context *ctx = (secp256k1_context*)(uintptr_t)ctx_l;
+  const jlong reclen = 32 + 64 + (jlong)publen;
+  unsigned char* data = secp256k1_jni_batch_buffer(env, byteBufferObject, n, (reclen + 1) * n);
+  unsigned char* status;
+  jint i, count = 0;
+
+  (void)classObject;
+
+  if (data == NULL || (publen != 33 && publen != 65)) {
+    return -1;
+  }
+  status = data + reclen * n;
+  for (i = 0; i < n; i++) {
+    const unsigned char* rec = data + reclen * i;
+    secp256k1_ecdsa_signature sig;
+    secp256k1_pubkey pubkey;
+
+    int ret = secp256k1_ecdsa_signature_parse_compact(ctx, &sig, rec + 32);
+    if( ret ) {
+      ret = secp256k1_ec_pubkey_parse(ctx, &pubkey, rec + 96, publen);
+    }
+    if( ret ) {
+      ret = secp256k1_ecdsa_verify(ctx, &sig, rec, &pubkey);
+    }
+    status[i] = ret;
+    count += ret;
+  }
+  return count;
+}
+
+SECP256K1_API jint JNICALL Java_org_bitcoin_NativeSecp256k1_secp256k1_1ecdsa_1sign_1batch
+  (JNIEnv* env, jclass classObject, jobject byteBufferObject, jlong ctx_l, jint n)
+{
+  secp256k1_context *ctx = (secp256k1_context*)(uintptr_t)ctx_l;
+  unsigned char* data = secp256k1_jni_batch_buffer(env, byteBufferObject, n, (64 + 64 + 1) * (jlong)n);
+  unsigned char* sigs;
+  unsigned char* status;
+  jint i, count = 0;
+
+  (void)classObject;
+
+  if (data == NULL) {
+    return -1;
+  }
+  sigs = data + 64 * n;
+  status = sigs + 64 * n;
+  for (i = 0; i < n; i++) {
+    unsigned char* rec = data + 64 * i;
+    secp256k1_ecdsa_signature sig;
+
+    int ret = secp256k1_ecdsa_sign(ctx, &sig, rec, rec + 32, NULL, NULL);
+    if( ret ) {
+      ret = secp256k1_ecdsa_signature_serialize_compact(ctx, sigs + 64 * i, &sig);
+    } else {
+      memset(sigs + 64 * i, 0, 64);
+    }
+    /* Do not leave secret keys behind in a buffer that may be reused. */
+    memset(rec + 32, 0, 32);
+    status[i] = ret;
+    count += ret;
+  }
+  return count;
+}
+
+SECP256K1_API jint JNICALL Java_org_bitcoin_NativeSecp256k1_secp256k1_1ec_1pubkey_1create_1batch
+  (JNIEnv* env, jclass classObject, jobject byteBufferObject, jlong ctx_l, jint n, jint publen)
+{
+  secp256k1_context *ctx = (secp256k1_context*)(uintptr_t)ctx_l;
+  unsigned char* data = secp256k1_jni_batch_buffer(env, byteBufferObject, n, (32 + (jlong)publen + 1) * n);
+  unsigned char* pubs;
+  unsigned char* status;
+  unsigned int flags = publen == 33 ? SECP256K1_EC_COMPRESSED : SECP256K1_EC_UNCOMPRESSED;
+  jint i, count = 0;
+
+  (void)classObject;
+
+  if (data == NULL || (publen != 33 && publen != 65)) {
+    return -1;
+  }
+  pubs = data + 32 * n;
+  status = pubs + publen * n;
+  for (i = 0; i < n; i++) {
+    unsigned char* secKey = data + 32 * i;
+    secp256k1_pubkey pubkey;
+    size_t outputLen = publen;
+
+    int ret = secp256k1_ec_pubkey_create(ctx, &pubkey, secKey);
+    if( ret ) {
+      ret = secp256k1_ec_pubkey_serialize(ctx, pubs + publen * i, &outputLen, &pubkey, flags);
+    } else {
+      memset(pubs + publen * i, 0, publen);
+    }
+    memset(secKey, 0, 32);
+    status[i] = ret;
+    count += ret;
+  }
+  return count;
+}
@@ -0,0 +1,51 @@
+/**********************************************************************
+ * Copyright (c) 2020 Peter Dettman, Pieter Wuille                    *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#ifndef _SECP256K1_MODINV32_
+#define _SECP256K1_MODINV32_
+
+#if defined HAVE_CONFIG_H
+#include "libsecp256k1-config.h"
+#endif
+
+#include "util.h"
+
+/** Variable-time modular arithmetic helpers based on the "posdivsteps" variant of the Bernstein-Yang
+ *  divsteps algorithm ("Fast constant-time gcd computation and modular inversion", 2019), which keeps
+ *  f and g non-negative so that the Jacobi symbol can be tracked along the way.
+ */
+
+/** A signed 30-bit limb representation of integers: X = sum(i=0..8, v[i]*2^(30*i)). */
+typedef struct {
+    int32_t v[9];
+} secp256k1_modinv32_signed30;
+
+/** Transition matrix of 30 posdivsteps, scaled by 2^30: [f', g'] = [[u, v], [q, r]] * [f, g] / 2^30. */
+typedef struct {
+    int32_t u, v, q, r;
+} secp256k1_modinv32_trans2x2;
+
+/** State of a posdivsteps run starting from f = m, g = x. */
+typedef struct {
+    secp256k1_modinv32_signed30 f, g;
+    int32_t eta;
+    int len;
+    int jac;
+} secp256k1_modinv32_state;
+
+/** Start a posdivsteps run on an odd modulus m and 0 < x < m, both with non-negative limbs. */
+static void secp256k1_modinv32_init(secp256k1_modinv32_state *s, const secp256k1_modinv32_signed30 *x, const secp256k1_modinv32_signed30 *m);
+
+/** Perform 30 posdivsteps and store the transition matrix that was applied to (f, g) in t. Returns 1
+ *  once f = 1, i.e. the run has converged to gcd(x, m) = 1. For 256-bit inputs this happens within 50
+ *  steps in practice. */
+static int secp256k1_modinv32_step_var(secp256k1_modinv32_state *s, secp256k1_modinv32_trans2x2 *t);
+
+/** Compute the Jacobi symbol (x | m) for an odd modulus m and 0 < x < m, both with non-negative
+ *  limbs and gcd(x, m) = 1. Returns 1 or -1, or 0 if the run did not converge within 50 steps. */
+static int secp256k1_jacobi32_maybe_var(const secp256k1_modinv32_signed30 *x, const secp256k1_modinv32_signed30 *m);
+
+#endif
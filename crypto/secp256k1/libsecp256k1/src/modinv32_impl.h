@@ -0,0 +1,154 @@
+/**********************************************************************
+ * Copyright (c) 2020 Peter Dettman, Pieter Wuille                    *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#ifndef _SECP256K1_MODINV32_IMPL_H_
+#define _SECP256K1_MODINV32_IMPL_H_
+
+#include "modinv32.h"
+
+/** Perform 30 posdivsteps on the bottom 32 bits f0 and g0 of f and g, starting from the given
+ *  eta (= -delta). The resulting transition matrix is stored in t and the final eta is returned.
+ *  The bottom bit of *jacp is flipped whenever applying the matrix to (f, g) changes the sign of
+ *  the Jacobi symbol (g | f); the other bits of *jacp are meaningless. f0 has to be odd. */
+static int32_t secp256k1_modinv32_posdivsteps_30_var(int32_t eta, uint32_t f0, uint32_t g0, secp256k1_modinv32_trans2x2 *t, int *jacp) {
+    uint32_t u = 1, v = 0, q = 0, r = 1;
+    uint32_t f = f0, g = g0, m, w;
+    int i = 30, limit, zeros;
+    int jac = *jacp;
+
+    for (;;) {
+        /* Use a sentinel bit to count zeros only up to i. */
+        zeros = secp256k1_ctz32_var(g | (UINT32_MAX << i));
+        /* Perform that many divsteps at once; they all just halve g. */
+        g >>= zeros;
+        u <<= zeros;
+        v <<= zeros;
+        eta -= zeros;
+        i -= zeros;
+        /* Halving g an odd number of times flips the sign when f is 3 or 5 mod 8. */
+        jac ^= (zeros & ((f >> 1) ^ (f >> 2)));
+        if (i == 0) {
+            break;
+        }
+        VERIFY_CHECK((f & 1) == 1);
+        VERIFY_CHECK((g & 1) == 1);
+        VERIFY_CHECK((u * f0 + v * g0) == f << (30 - i));
+        VERIFY_CHECK((q * f0 + r * g0) == g << (30 - i));
+        if (eta < 0) {
+            uint32_t tmp;
+            eta = -eta;
+            tmp = f; f = g; g = tmp;
+            tmp = u; u = q; q = tmp;
+            tmp = v; v = r; r = tmp;
+            /* Quadratic reciprocity: swapping flips the sign when both are 3 mod 4. */
+            jac ^= ((f & g) >> 1);
+            /* Cancel out up to 6 bits of g, but no more than i (we'd be done) or eta+1 (eta would
+             * change sign again). */
+            limit = ((int)eta + 1) > i ? i : ((int)eta + 1);
+            VERIFY_CHECK(limit > 0 && limit <= 30);
+            m = (UINT32_MAX >> (32 - limit)) & 63U;
+            w = (f * g * (f * f - 2)) & m;
+        } else {
+            /* eta tends to be small here, so a simpler formula cancelling up to 4 bits suffices. */
+            limit = ((int)eta + 1) > i ? i : ((int)eta + 1);
+            VERIFY_CHECK(limit > 0 && limit <= 30);
+            m = (UINT32_MAX >> (32 - limit)) & 15U;
+            w = f + (((f + 1) & 4) << 1);
+            w = (-w * g) & m;
+        }
+        g += f * w;
+        q += u * w;
+        r += v * w;
+        VERIFY_CHECK((g & m) == 0);
+    }
+    t->u = (int32_t)u;
+    t->v = (int32_t)v;
+    t->q = (int32_t)q;
+    t->r = (int32_t)r;
+    *jacp = jac;
+    return eta;
+}
+
+/** Compute (t/2^30) * [f, g] on the bottom len limbs of f and g. */
+static void secp256k1_modinv32_update_fg_30_var(int len, secp256k1_modinv32_signed30 *f, secp256k1_modinv32_signed30 *g, const secp256k1_modinv32_trans2x2 *t) {
+    const uint32_t M30 = UINT32_MAX >> 2;
+    const int32_t u = t->u, v = t->v, q = t->q, r = t->r;
+    int64_t cf, cg;
+    int i;
+    VERIFY_CHECK(len > 0);
+    cf = (int64_t)u * f->v[0] + (int64_t)v * g->v[0];
+    cg = (int64_t)q * f->v[0] + (int64_t)r * g->v[0];
+    /* The bottom 30 bits of the result are zero; throw them away. */
+    VERIFY_CHECK(((uint32_t)cf & M30) == 0);
+    VERIFY_CHECK(((uint32_t)cg & M30) == 0);
+    cf >>= 30;
+    cg >>= 30;
+    for (i = 1; i < len; i++) {
+        cf += (int64_t)u * f->v[i] + (int64_t)v * g->v[i];
+        cg += (int64_t)q * f->v[i] + (int64_t)r * g->v[i];
+        f->v[i - 1] = (int32_t)((uint32_t)cf & M30);
+        g->v[i - 1] = (int32_t)((uint32_t)cg & M30);
+        cf >>= 30;
+        cg >>= 30;
+    }
+    f->v[len - 1] = (int32_t)cf;
+    g->v[len - 1] = (int32_t)cg;
+}
+
+static void secp256k1_modinv32_init(secp256k1_modinv32_state *s, const secp256k1_modinv32_signed30 *x, const secp256k1_modinv32_signed30 *m) {
+#ifdef VERIFY
+    int32_t nonzero = 0;
+    int i;
+    for (i = 0; i < 9; i++) {
+        VERIFY_CHECK(x->v[i] >= 0);
+        nonzero |= x->v[i];
+    }
+    VERIFY_CHECK(nonzero != 0);
+    VERIFY_CHECK(m->v[0] & 1);
+#endif
+    s->f = *m;
+    s->g = *x;
+    s->eta = -1;
+    s->len = 9;
+    s->jac = 0;
+}
+
+static int secp256k1_modinv32_step_var(secp256k1_modinv32_state *s, secp256k1_modinv32_trans2x2 *t) {
+    int len = s->len, j;
+
+    s->eta = secp256k1_modinv32_posdivsteps_30_var(s->eta, s->f.v[0] | ((uint32_t)s->f.v[1] << 30), s->g.v[0] | ((uint32_t)s->g.v[1] << 30), t, &s->jac);
+    secp256k1_modinv32_update_fg_30_var(len, &s->f, &s->g, t);
+    if (s->f.v[0] == 1) {
+        int32_t cond = 0;
+        for (j = 1; j < len; j++) {
+            cond |= s->f.v[j];
+        }
+        if (cond == 0) {
+            return 1;
+        }
+    }
+    /* Shrink the active length once the top limbs of both f and g are zero. */
+    if (len > 1 && s->f.v[len - 1] == 0 && s->g.v[len - 1] == 0) {
+        s->len = len - 1;
+    }
+    return 0;
+}
+
+static int secp256k1_jacobi32_maybe_var(const secp256k1_modinv32_signed30 *x, const secp256k1_modinv32_signed30 *m) {
+    secp256k1_modinv32_state s;
+    secp256k1_modinv32_trans2x2 t;
+    int count;
+
+    secp256k1_modinv32_init(&s, x, m);
+    for (count = 0; count < 50; count++) {
+        if (secp256k1_modinv32_step_var(&s, &t)) {
+            return 1 - 2 * (s.jac & 1);
+        }
+    }
+    return 0;
+}
+
+#endif
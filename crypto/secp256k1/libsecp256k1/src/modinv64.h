@@ -0,0 +1,55 @@
+/**********************************************************************
+ * Copyright (c) 2020 Peter Dettman, Pieter Wuille                    *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#ifndef _SECP256K1_MODINV64_
+#define _SECP256K1_MODINV64_
+
+#if defined HAVE_CONFIG_H
+#include "libsecp256k1-config.h"
+#endif
+
+#include "util.h"
+
+#ifndef HAVE___INT128
+#error "modinv64 requires 128-bit wide multiplication support"
+#endif
+
+/** Variable-time modular arithmetic helpers based on the "posdivsteps" variant of the Bernstein-Yang
+ *  divsteps algorithm ("Fast constant-time gcd computation and modular inversion", 2019), which keeps
+ *  f and g non-negative so that the Jacobi symbol can be tracked along the way.
+ */
+
+/** A signed 62-bit limb representation of integers: X = sum(i=0..4, v[i]*2^(62*i)). */
+typedef struct {
+    int64_t v[5];
+} secp256k1_modinv64_signed62;
+
+/** Transition matrix of 62 posdivsteps, scaled by 2^62: [f', g'] = [[u, v], [q, r]] * [f, g] / 2^62. */
+typedef struct {
+    int64_t u, v, q, r;
+} secp256k1_modinv64_trans2x2;
+
+/** State of a posdivsteps run starting from f = m, g = x. */
+typedef struct {
+    secp256k1_modinv64_signed62 f, g;
+    int64_t eta;
+    int len;
+    int jac;
+} secp256k1_modinv64_state;
+
+/** Start a posdivsteps run on an odd modulus m and 0 < x < m, both with non-negative limbs. */
+static void secp256k1_modinv64_init(secp256k1_modinv64_state *s, const secp256k1_modinv64_signed62 *x, const secp256k1_modinv64_signed62 *m);
+
+/** Perform 62 posdivsteps and store the transition matrix that was applied to (f, g) in t. Returns 1
+ *  once f = 1, i.e. the run has converged to gcd(x, m) = 1. For 256-bit inputs this happens within 25
+ *  steps in practice. */
+static int secp256k1_modinv64_step_var(secp256k1_modinv64_state *s, secp256k1_modinv64_trans2x2 *t);
+
+/** Compute the Jacobi symbol (x | m) for an odd modulus m and 0 < x < m, both with non-negative
+ *  limbs and gcd(x, m) = 1. Returns 1 or -1, or 0 if the run did not converge within 25 steps. */
+static int secp256k1_jacobi64_maybe_var(const secp256k1_modinv64_signed62 *x, const secp256k1_modinv64_signed62 *m);
+
+#endif
@@ -10,6 +10,25 @@
 #include "include/secp256k1_ecdh.h"
 #include "ecmult_const_impl.h"
 
+/* Sets result to the hash of pt in compressed form. Unlike secp256k1_eckey_pubkey_serialize,
+ * this has no timing sidechannel, since pt is secret. pt is normalized in place. */
+static void secp256k1_ecdh_hash_point(unsigned char *result, secp256k1_ge *pt) {
+    unsigned char x[32];
+    unsigned char y[1];
+    secp256k1_sha256_t sha;
+
+    secp256k1_fe_normalize(&pt->x);
+    secp256k1_fe_normalize(&pt->y);
+    secp256k1_fe_get_b32(x, &pt->x);
+    y[0] = 0x02 | secp256k1_fe_is_odd(&pt->y);
+
+    secp256k1_sha256_initialize(&sha);
+    secp256k1_sha256_write(&sha, y, sizeof(y));
+    secp256k1_sha256_write(&sha, x, sizeof(x));
+    secp256k1_sha256_finalize(&sha, result);
+    memset(x, 0, sizeof(x));
+}
+
 int secp256k1_ecdh(const secp256k1_context* ctx, unsigned char *result, const secp256k1_pubkey *point, const unsigned char *scalar) {
     int ret = 0;
     int overflow = 0;
@@ -26,24 +45,9 @@ int secp256k1_ecdh(const secp256k1_context* ctx, unsigned char *result, const se
     if (overflow || secp256k1_scalar_is_zero(&s)) {
         ret = 0;
     } else {
-        unsigned char x[32];
-        unsigned char y[1];
-        secp256k1_sha256_t sha;
-
         secp256k1_ecmult_const(&res, &pt, &s);
         secp256k1_ge_set_gej(&pt, &res);
-        /* Compute a hash of the point in compressed form
-         * Note we cannot use secp256k1_eckey_pubkey_serialize here since it does not
-         * expect its output to be secret and has a timing sidechannel. */
-        secp256k1_fe_normalize(&pt.x);
-        secp256k1_fe_normalize(&pt.y);
-        secp256k1_fe_get_b32(x, &pt.x);
-        y[0] = 0x02 | secp256k1_fe_is_odd(&pt.y);
-
-        secp256k1_sha256_initialize(&sha);
-        secp256k1_sha256_write(&sha, y, sizeof(y));
-        secp256k1_sha256_write(&sha, x, sizeof(x));
-        secp256k1_sha256_finalize(&sha, result);
+        secp256k1_ecdh_hash_point(result, &pt);
         ret = 1;
     }
 
@@ -51,4 +55,196 @@ int secp256k1_ecdh(const secp256k1_context* ctx, unsigned char *result, const se
     return ret;
 }
 
+/* Number of ladders whose results share one field inversion in secp256k1_ecdh_batch. Large
+ * enough to make the inversion negligible, small enough to keep the state on the stack. */
+#define SECP256K1_ECDH_BATCH_SIZE 32
+
+/** Sets r[i] to the affine form of a[i], for len points that are not infinity, using one
+ *  inversion. The product of all z coordinates is multiplied by a secret random blinding factor
+ *  before it is inverted, so the value passed to the (variable time) inversion is uniformly
+ *  distributed and independent of the points. Everything else is constant time. */
+static void secp256k1_ecdh_ge_set_all_gej_blind(secp256k1_ge *r, const secp256k1_gej *a, size_t len, secp256k1_rfc6979_hmac_sha256_t *rng) {
+    secp256k1_fe prod[SECP256K1_ECDH_BATCH_SIZE];
+    secp256k1_fe blind, u;
+    unsigned char blind32[32];
+    size_t i;
+    int retry;
+
+    VERIFY_CHECK(len >= 1 && len <= SECP256K1_ECDH_BATCH_SIZE);
+    do {
+        secp256k1_rfc6979_hmac_sha256_generate(rng, blind32, 32);
+        retry = !secp256k1_fe_set_b32(&blind, blind32);
+        retry |= secp256k1_fe_is_zero(&blind);
+    } while (retry); /* This branch true is cryptographically unreachable. Requires sha256_hmac output > Fp. */
+
+    prod[0] = a[0].z;
+    for (i = 1; i < len; i++) {
+        secp256k1_fe_mul(&prod[i], &prod[i - 1], &a[i].z);
+    }
+    secp256k1_fe_mul(&u, &prod[len - 1], &blind);
+    secp256k1_fe_inv_var(&u, &u);
+    secp256k1_fe_mul(&u, &u, &blind);
+    /* u is now the inverse of the product of all z coordinates. */
+    for (i = len - 1; i > 0; i--) {
+        secp256k1_fe zi;
+        secp256k1_fe_mul(&zi, &u, &prod[i - 1]);
+        secp256k1_fe_mul(&u, &u, &a[i].z);
+        secp256k1_ge_set_gej_zinv(&r[i], &a[i], &zi);
+    }
+    secp256k1_ge_set_gej_zinv(&r[0], &a[0], &u);
+
+    secp256k1_fe_clear(&blind);
+    secp256k1_fe_clear(&u);
+    memset(blind32, 0, sizeof(blind32));
+    memset(prod, 0, sizeof(prod));
+}
+
+/** Seeds the generator of the blinding factors for secp256k1_ecdh_batch_ge from all secret
+ *  scalars, so they are unpredictable to anyone who cannot already compute the results. */
+static void secp256k1_ecdh_batch_rng_init(secp256k1_rfc6979_hmac_sha256_t *rng, const unsigned char *scalars, size_t n) {
+    secp256k1_sha256_t sha;
+    unsigned char seed[32];
+
+    secp256k1_sha256_initialize(&sha);
+    secp256k1_sha256_write(&sha, scalars, n * 32);
+    secp256k1_sha256_finalize(&sha, seed);
+    secp256k1_rfc6979_hmac_sha256_initialize(rng, seed, 32);
+    memset(seed, 0, sizeof(seed));
+}
+
+/** Sets pt[i] to scalars[i]*pt[i] in affine coordinates for len <= SECP256K1_ECDH_BATCH_SIZE
+ *  points, sharing one blinded inversion. On input valid[i] tells whether pt[i] is a valid
+ *  point; on output it is cleared for invalid scalars too, and such pt[i] are garbage. */
+static void secp256k1_ecdh_batch_ge(secp256k1_ge *pt, int *valid, const unsigned char *scalars, size_t len, secp256k1_rfc6979_hmac_sha256_t *rng) {
+    secp256k1_gej res[SECP256K1_ECDH_BATCH_SIZE];
+    size_t j;
+
+    for (j = 0; j < len; j++) {
+        secp256k1_scalar s;
+        int overflow = 0;
+
+        secp256k1_scalar_set_b32(&s, scalars + j * 32, &overflow);
+        valid[j] &= !overflow & !secp256k1_scalar_is_zero(&s);
+        if (!valid[j]) {
+            /* Keep the ladder away from the point at infinity; the result is discarded. */
+            pt[j] = secp256k1_ge_const_g;
+            secp256k1_scalar_set_int(&s, 1);
+        }
+        secp256k1_ecmult_const(&res[j], &pt[j], &s);
+        secp256k1_scalar_clear(&s);
+    }
+    secp256k1_ecdh_ge_set_all_gej_blind(pt, res, len, rng);
+    memset(res, 0, sizeof(res));
+}
+
+int secp256k1_ecdh_batch(const secp256k1_context* ctx, unsigned char *results, const secp256k1_pubkey *points, const unsigned char *scalars, size_t n) {
+    secp256k1_rfc6979_hmac_sha256_t rng;
+    size_t i, j, len;
+    int ret = 1;
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(results != NULL || n == 0);
+    ARG_CHECK(points != NULL || n == 0);
+    ARG_CHECK(scalars != NULL || n == 0);
+
+    secp256k1_ecdh_batch_rng_init(&rng, scalars, n);
+    for (i = 0; i < n; i += len) {
+        secp256k1_ge pt[SECP256K1_ECDH_BATCH_SIZE];
+        int valid[SECP256K1_ECDH_BATCH_SIZE];
+
+        len = n - i < SECP256K1_ECDH_BATCH_SIZE ? n - i : SECP256K1_ECDH_BATCH_SIZE;
+        for (j = 0; j < len; j++) {
+            valid[j] = secp256k1_pubkey_load(ctx, &pt[j], &points[i + j]);
+        }
+        secp256k1_ecdh_batch_ge(pt, valid, scalars + i * 32, len, &rng);
+        for (j = 0; j < len; j++) {
+            if (valid[j]) {
+                secp256k1_ecdh_hash_point(results + (i + j) * 32, &pt[j]);
+            } else {
+                memset(results + (i + j) * 32, 0, 32);
+                ret = 0;
+            }
+        }
+        memset(pt, 0, sizeof(pt));
+    }
+    secp256k1_rfc6979_hmac_sha256_finalize(&rng);
+    return ret;
+}
+
+/* A table for one point has the layout of the generator table of a context, and is blinded the
+ * same way: k*P is computed as (k + blind)*P + initial, with initial = -blind*P. */
+struct secp256k1_ecdh_table_struct {
+    secp256k1_ecmult_gen_context gen;
+};
+
+secp256k1_ecdh_table* secp256k1_ecdh_table_create(const secp256k1_context* ctx, const secp256k1_pubkey *pubkey, const unsigned char *seed32) {
+    secp256k1_ecdh_table *table;
+    secp256k1_sha256_t sha;
+    secp256k1_ge pt;
+    unsigned char seed[32];
+    unsigned char ser[65];
+    size_t serlen = sizeof(ser);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(pubkey != NULL);
+    ARG_CHECK(seed32 != NULL);
+
+    if (!secp256k1_pubkey_load(ctx, &pt, pubkey)) {
+        return NULL;
+    }
+    table = (secp256k1_ecdh_table*)checked_malloc(&ctx->error_callback, sizeof(secp256k1_ecdh_table));
+    table->gen.prec = (secp256k1_ge_storage (*)[64][16])checked_malloc(&ctx->error_callback, sizeof(*table->gen.prec));
+    secp256k1_ecmult_gen_compute_table(table->gen.prec, &pt, &ctx->error_callback);
+
+    /* Start from the trivial blinding (k + 1)*P - P and let secp256k1_ecmult_gen_blind derive a
+     * random one. It needs a seed to not reset to a blinding for G. */
+    secp256k1_gej_set_ge(&table->gen.initial, &pt);
+    secp256k1_gej_neg(&table->gen.initial, &table->gen.initial);
+    secp256k1_scalar_set_int(&table->gen.blind, 1);
+    secp256k1_eckey_pubkey_serialize(&pt, ser, &serlen, 0);
+    secp256k1_sha256_initialize(&sha);
+    secp256k1_sha256_write(&sha, ser, serlen);
+    secp256k1_sha256_write(&sha, seed32, 32);
+    secp256k1_sha256_finalize(&sha, seed);
+    secp256k1_ecmult_gen_blind(&table->gen, seed);
+    memset(seed, 0, sizeof(seed));
+    return table;
+}
+
+void secp256k1_ecdh_table_destroy(secp256k1_ecdh_table* table) {
+    if (table != NULL) {
+        free(table->gen.prec);
+        secp256k1_scalar_clear(&table->gen.blind);
+        secp256k1_gej_clear(&table->gen.initial);
+        free(table);
+    }
+}
+
+/** Sets r to s times the point of table, in affine coordinates. Constant time. */
+static void secp256k1_ecdh_table_mul(const secp256k1_ecdh_table *table, secp256k1_ge *r, const secp256k1_scalar *s) {
+    secp256k1_gej res;
+
+    secp256k1_ecmult_gen(&table->gen, &res, s);
+    secp256k1_ge_set_gej(r, &res);
+    secp256k1_gej_clear(&res);
+}
+
+int secp256k1_ecdh_table_ecdh(const secp256k1_context* ctx, unsigned char *result, const secp256k1_ecdh_table *table, const unsigned char *privkey) {
+    int ret = 0;
+    int overflow = 0;
+    secp256k1_ge pt;
+    secp256k1_scalar s;
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(result != NULL);
+    ARG_CHECK(table != NULL);
+    ARG_CHECK(privkey != NULL);
+
+    secp256k1_scalar_set_b32(&s, privkey, &overflow);
+    if (!overflow && !secp256k1_scalar_is_zero(&s)) {
+        secp256k1_ecdh_table_mul(table, &pt, &s);
+        secp256k1_ecdh_hash_point(result, &pt);
+        ret = 1;
+    }
+    secp256k1_scalar_clear(&s);
+    return ret;
+}
+
 #endif
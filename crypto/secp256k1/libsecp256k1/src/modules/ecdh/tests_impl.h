@@ -32,6 +32,10 @@ void test_ecdh_api(void) {
     CHECK(secp256k1_ecdh(tctx, res, &point, s_one) == 1);
     CHECK(ecount == 3);
 
+    /* A table cannot be built without a seed. */
+    CHECK(secp256k1_ecdh_table_create(tctx, &point, NULL) == NULL);
+    CHECK(ecount == 4);
+
     /* Cleanup */
     secp256k1_context_destroy(tctx);
 }
@@ -96,10 +100,83 @@ void test_bad_scalar(void) {
     CHECK(secp256k1_ecdh(ctx, output, &point, s_overflow) == 1);
 }
 
+void test_ecdh_batch(void) {
+    static const size_t sizes[] = { 0, 1, 2, 31, 32, 33, 70 };
+    secp256k1_pubkey points[70];
+    unsigned char scalars[70 * 32];
+    unsigned char results[70 * 32];
+    unsigned char expected[32];
+    size_t i, k;
+
+    for (i = 0; i < 70; i++) {
+        secp256k1_scalar s;
+        unsigned char key[32];
+        random_scalar_order(&s);
+        secp256k1_scalar_get_b32(key, &s);
+        CHECK(secp256k1_ec_pubkey_create(ctx, &points[i], key) == 1);
+        random_scalar_order(&s);
+        secp256k1_scalar_get_b32(scalars + i * 32, &s);
+    }
+    for (k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+        CHECK(secp256k1_ecdh_batch(ctx, results, points, scalars, sizes[k]) == 1);
+        for (i = 0; i < sizes[k]; i++) {
+            CHECK(secp256k1_ecdh(ctx, expected, &points[i], scalars + i * 32) == 1);
+            CHECK(memcmp(results + i * 32, expected, 32) == 0);
+        }
+    }
+    CHECK(secp256k1_ecdh_batch(ctx, NULL, NULL, NULL, 0) == 1);
+
+    /* An invalid scalar only affects its own result. */
+    memset(scalars + 40 * 32, 0xff, 32);
+    CHECK(secp256k1_ecdh_batch(ctx, results, points, scalars, 70) == 0);
+    for (i = 0; i < 70; i++) {
+        if (i == 40) {
+            memset(expected, 0, 32);
+        } else {
+            CHECK(secp256k1_ecdh(ctx, expected, &points[i], scalars + i * 32) == 1);
+        }
+        CHECK(memcmp(results + i * 32, expected, 32) == 0);
+    }
+}
+
+void test_ecdh_table(void) {
+    unsigned char s_zero[32] = { 0 };
+    unsigned char seed[32];
+    int i, j;
+
+    secp256k1_ecdh_table_destroy(NULL);
+    for (i = 0; i < 4; i++) {
+        secp256k1_ecdh_table *table;
+        secp256k1_pubkey point;
+        secp256k1_scalar s;
+        unsigned char key[32];
+
+        random_scalar_order(&s);
+        secp256k1_scalar_get_b32(key, &s);
+        CHECK(secp256k1_ec_pubkey_create(ctx, &point, key) == 1);
+        secp256k1_rand256(seed);
+        table = secp256k1_ecdh_table_create(ctx, &point, seed);
+        CHECK(table != NULL);
+        for (j = 0; j < 16; j++) {
+            unsigned char output_ecdh[32];
+            unsigned char output_table[32];
+            random_scalar_order(&s);
+            secp256k1_scalar_get_b32(key, &s);
+            CHECK(secp256k1_ecdh(ctx, output_ecdh, &point, key) == 1);
+            CHECK(secp256k1_ecdh_table_ecdh(ctx, output_table, table, key) == 1);
+            CHECK(memcmp(output_ecdh, output_table, 32) == 0);
+        }
+        CHECK(secp256k1_ecdh_table_ecdh(ctx, seed, table, s_zero) == 0);
+        secp256k1_ecdh_table_destroy(table);
+    }
+}
+
 void run_ecdh_tests(void) {
     test_ecdh_api();
     test_ecdh_generator_basepoint();
     test_bad_scalar();
+    test_ecdh_batch();
+    test_ecdh_table();
 }
 
 #endif
@@ -120,6 +120,47 @@ static int secp256k1_ecdsa_sig_recover(const secp256k1_ecmult_context *ctx, cons
     return !secp256k1_gej_is_infinity(&qj);
 }
 
+/* Checks that recovering (sigr, sigs, recid) over message yields pubkey, without
+ * decompressing R. Since s*R = r*Q + m*G, R is recomputed from the expected key as
+ * (m/s)*G + (r/s)*Q and its x coordinate compared in Jacobian form, like
+ * secp256k1_ecdsa_sig_verify does. Only if that matches is the point normalized to
+ * compare the parity of y against recid. */
+static int secp256k1_ecdsa_sig_recover_check(const secp256k1_ecmult_context *ctx, const secp256k1_scalar *sigr, const secp256k1_scalar* sigs, const secp256k1_ge *pubkey, const secp256k1_scalar *message, int recid) {
+    unsigned char brx[32];
+    secp256k1_fe fx;
+    secp256k1_ge pr;
+    secp256k1_gej pubkeyj;
+    secp256k1_gej prj;
+    secp256k1_scalar sn, u1, u2;
+    int r;
+
+    if (secp256k1_scalar_is_zero(sigr) || secp256k1_scalar_is_zero(sigs)) {
+        return 0;
+    }
+
+    secp256k1_scalar_get_b32(brx, sigr);
+    r = secp256k1_fe_set_b32(&fx, brx);
+    (void)r;
+    VERIFY_CHECK(r); /* brx comes from a scalar, so is less than the order; certainly less than p */
+    if (recid & 2) {
+        if (secp256k1_fe_cmp_var(&fx, &secp256k1_ecdsa_const_p_minus_order) >= 0) {
+            return 0;
+        }
+        secp256k1_fe_add(&fx, &secp256k1_ecdsa_const_order_as_fe);
+    }
+    secp256k1_scalar_inverse_var(&sn, sigs);
+    secp256k1_scalar_mul(&u1, &sn, message);
+    secp256k1_scalar_mul(&u2, &sn, sigr);
+    secp256k1_gej_set_ge(&pubkeyj, pubkey);
+    secp256k1_ecmult(ctx, &prj, &pubkeyj, &u2, &u1);
+    if (secp256k1_gej_is_infinity(&prj) || !secp256k1_gej_eq_x_var(&fx, &prj)) {
+        return 0;
+    }
+    secp256k1_ge_set_gej_var(&pr, &prj);
+    secp256k1_fe_normalize_var(&pr.y);
+    return secp256k1_fe_is_odd(&pr.y) == (recid & 1);
+}
+
 int secp256k1_ecdsa_sign_recoverable(const secp256k1_context* ctx, secp256k1_ecdsa_recoverable_signature *signature, const unsigned char *msg32, const unsigned char *seckey, secp256k1_nonce_function noncefp, const void* noncedata) {
     secp256k1_scalar r, s;
     secp256k1_scalar sec, non, msg;
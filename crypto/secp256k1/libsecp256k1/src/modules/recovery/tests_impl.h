@@ -205,6 +205,38 @@ void test_ecdsa_recovery_end_to_end(void) {
           memcmp(&pubkey, &recpubkey, sizeof(pubkey)) != 0);
 }
 
+void test_ecdsa_recovery_check(void) {
+    secp256k1_scalar r, s, msg, key;
+    secp256k1_gej qj;
+    secp256k1_ge q, other;
+    int recid, i;
+
+    /* Signatures for which recovery yields q must check against q for the same recid only. */
+    random_scalar_order_test(&r);
+    random_scalar_order_test(&s);
+    random_scalar_order_test(&msg);
+    random_scalar_order_test(&key);
+    secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &qj, &key);
+    secp256k1_ge_set_gej(&other, &qj);
+    for (recid = 0; recid < 4; recid++) {
+        if (!secp256k1_ecdsa_sig_recover(&ctx->ecmult_ctx, &r, &s, &q, &msg, recid)) {
+            CHECK(secp256k1_ecdsa_sig_recover_check(&ctx->ecmult_ctx, &r, &s, &other, &msg, recid) == 0);
+            continue;
+        }
+        CHECK(secp256k1_ecdsa_sig_recover_check(&ctx->ecmult_ctx, &r, &s, &q, &msg, recid) == 1);
+        CHECK(secp256k1_ecdsa_sig_recover_check(&ctx->ecmult_ctx, &r, &s, &other, &msg, recid) == 0);
+        for (i = 0; i < 4; i++) {
+            if (i != recid) {
+                CHECK(secp256k1_ecdsa_sig_recover_check(&ctx->ecmult_ctx, &r, &s, &q, &msg, i) == 0);
+            }
+        }
+        secp256k1_scalar_negate(&s, &s);
+        CHECK(secp256k1_ecdsa_sig_recover_check(&ctx->ecmult_ctx, &r, &s, &q, &msg, recid) == 0);
+        CHECK(secp256k1_ecdsa_sig_recover_check(&ctx->ecmult_ctx, &r, &s, &q, &msg, recid ^ 1) == 1);
+        secp256k1_scalar_negate(&s, &s);
+    }
+}
+
 /* Tests several edge cases. */
 void test_ecdsa_recovery_edge_cases(void) {
     const unsigned char msg32[32] = {
@@ -387,6 +419,9 @@ void run_recovery_tests(void) {
     for (i = 0; i < 64*count; i++) {
         test_ecdsa_recovery_end_to_end();
     }
+    for (i = 0; i < count; i++) {
+        test_ecdsa_recovery_check();
+    }
     test_ecdsa_recovery_edge_cases();
 }
 
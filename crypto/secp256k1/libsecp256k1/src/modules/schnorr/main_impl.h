@@ -0,0 +1,257 @@
+/**********************************************************************
+ * Copyright (c) 2020 The libsecp256k1 developers                    *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#ifndef _SECP256K1_MODULE_SCHNORR_MAIN_
+#define _SECP256K1_MODULE_SCHNORR_MAIN_
+
+#include "include/secp256k1_schnorr.h"
+#include "ecmult_impl.h"
+#include "hash_impl.h"
+
+/* Initializes sha to SHA256(SHA256(tag) || SHA256(tag)), the prefix of a BIP340 tagged hash. */
+static void secp256k1_schnorr_sha256_tagged(secp256k1_sha256_t *sha, const char *tag) {
+    unsigned char buf[32];
+    secp256k1_sha256_initialize(sha);
+    secp256k1_sha256_write(sha, (const unsigned char *)tag, strlen(tag));
+    secp256k1_sha256_finalize(sha, buf);
+
+    secp256k1_sha256_initialize(sha);
+    secp256k1_sha256_write(sha, buf, 32);
+    secp256k1_sha256_write(sha, buf, 32);
+}
+
+/* Sets e to the BIP340 challenge for the nonce x coordinate rx32, the public key x
+ * coordinate px32 and the message msg32. */
+static void secp256k1_schnorr_challenge(secp256k1_scalar *e, const unsigned char *rx32, const unsigned char *px32, const unsigned char *msg32) {
+    unsigned char buf[32];
+    secp256k1_sha256_t sha;
+    secp256k1_schnorr_sha256_tagged(&sha, "BIP0340/challenge");
+    secp256k1_sha256_write(&sha, rx32, 32);
+    secp256k1_sha256_write(&sha, px32, 32);
+    secp256k1_sha256_write(&sha, msg32, 32);
+    secp256k1_sha256_finalize(&sha, buf);
+    secp256k1_scalar_set_b32(e, buf, NULL);
+}
+
+int secp256k1_schnorr_sign(const secp256k1_context* ctx, unsigned char *sig64, const unsigned char *msg32, const unsigned char *seckey, const unsigned char *aux_rand32) {
+    static const unsigned char zero32[32] = {0};
+    secp256k1_sha256_t sha;
+    secp256k1_scalar d, k, e, s;
+    secp256k1_gej pj, rj;
+    secp256k1_ge p, r;
+    unsigned char t[32];
+    unsigned char px[32];
+    unsigned char buf[32];
+    int overflow = 0;
+    int ret;
+    int i;
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx));
+    ARG_CHECK(sig64 != NULL);
+    ARG_CHECK(msg32 != NULL);
+    ARG_CHECK(seckey != NULL);
+    if (aux_rand32 == NULL) {
+        aux_rand32 = zero32;
+    }
+
+    secp256k1_scalar_set_b32(&d, seckey, &overflow);
+    if (overflow || secp256k1_scalar_is_zero(&d)) {
+        secp256k1_scalar_clear(&d);
+        memset(sig64, 0, 64);
+        return 0;
+    }
+
+    /* Use the key whose public key has an even y coordinate. */
+    secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &pj, &d);
+    secp256k1_ge_set_gej(&p, &pj);
+    secp256k1_fe_normalize(&p.x);
+    secp256k1_fe_normalize(&p.y);
+    secp256k1_scalar_cond_negate(&d, secp256k1_fe_is_odd(&p.y));
+    secp256k1_fe_get_b32(px, &p.x);
+
+    /* t = bytes(d) xor hash_aux(aux_rand), k = hash_nonce(t || bytes(P) || m) */
+    secp256k1_schnorr_sha256_tagged(&sha, "BIP0340/aux");
+    secp256k1_sha256_write(&sha, aux_rand32, 32);
+    secp256k1_sha256_finalize(&sha, buf);
+    secp256k1_scalar_get_b32(t, &d);
+    for (i = 0; i < 32; i++) {
+        t[i] ^= buf[i];
+    }
+    secp256k1_schnorr_sha256_tagged(&sha, "BIP0340/nonce");
+    secp256k1_sha256_write(&sha, t, 32);
+    secp256k1_sha256_write(&sha, px, 32);
+    secp256k1_sha256_write(&sha, msg32, 32);
+    secp256k1_sha256_finalize(&sha, buf);
+    secp256k1_scalar_set_b32(&k, buf, NULL);
+    /* A zero nonce is cryptographically unreachable; the signature is still computed and then discarded. */
+    ret = !secp256k1_scalar_is_zero(&k);
+
+    /* R = kG, negating k if R has an odd y coordinate. */
+    secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &rj, &k);
+    secp256k1_ge_set_gej(&r, &rj);
+    secp256k1_fe_normalize(&r.x);
+    secp256k1_fe_normalize(&r.y);
+    secp256k1_scalar_cond_negate(&k, secp256k1_fe_is_odd(&r.y));
+    secp256k1_fe_get_b32(sig64, &r.x);
+
+    /* s = k + e*d */
+    secp256k1_schnorr_challenge(&e, sig64, px, msg32);
+    secp256k1_scalar_mul(&s, &e, &d);
+    secp256k1_scalar_add(&s, &s, &k);
+    secp256k1_scalar_get_b32(sig64 + 32, &s);
+
+    if (!ret) {
+        memset(sig64, 0, 64);
+    }
+    secp256k1_scalar_clear(&d);
+    secp256k1_scalar_clear(&k);
+    secp256k1_scalar_clear(&s);
+    secp256k1_gej_clear(&rj);
+    secp256k1_ge_clear(&r);
+    memset(t, 0, sizeof(t));
+    memset(buf, 0, sizeof(buf));
+    return ret;
+}
+
+/* Loads the x coordinate of a public key into px32, and the point with that x coordinate
+ * and an even y coordinate into p. */
+static int secp256k1_schnorr_pubkey_load(const secp256k1_context* ctx, secp256k1_ge *p, unsigned char *px32, const secp256k1_pubkey *pubkey) {
+    if (!secp256k1_pubkey_load(ctx, p, pubkey)) {
+        return 0;
+    }
+    secp256k1_fe_normalize_var(&p->x);
+    secp256k1_fe_normalize_var(&p->y);
+    if (secp256k1_fe_is_odd(&p->y)) {
+        secp256k1_ge_neg(p, p);
+        secp256k1_fe_normalize_var(&p->y);
+    }
+    secp256k1_fe_get_b32(px32, &p->x);
+    return 1;
+}
+
+/* Parses a signature into the nonce x coordinate rx and s, failing if either is out of range. */
+static int secp256k1_schnorr_sig_load(secp256k1_fe *rx, secp256k1_scalar *s, const unsigned char *sig64) {
+    int overflow = 0;
+    if (!secp256k1_fe_set_b32(rx, sig64)) {
+        return 0;
+    }
+    secp256k1_scalar_set_b32(s, sig64 + 32, &overflow);
+    return !overflow;
+}
+
+int secp256k1_schnorr_verify(const secp256k1_context* ctx, const unsigned char *sig64, const unsigned char *msg32, const secp256k1_pubkey *pubkey) {
+    secp256k1_scalar s, e;
+    secp256k1_fe rx;
+    secp256k1_ge p, r;
+    secp256k1_gej pj, rj;
+    unsigned char px[32];
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_ecmult_context_is_built(&ctx->ecmult_ctx));
+    ARG_CHECK(sig64 != NULL);
+    ARG_CHECK(msg32 != NULL);
+    ARG_CHECK(pubkey != NULL);
+
+    if (!secp256k1_schnorr_sig_load(&rx, &s, sig64) ||
+        !secp256k1_schnorr_pubkey_load(ctx, &p, px, pubkey)) {
+        return 0;
+    }
+
+    /* R = sG - eP must have an even y coordinate and x coordinate rx. */
+    secp256k1_schnorr_challenge(&e, sig64, px, msg32);
+    secp256k1_scalar_negate(&e, &e);
+    secp256k1_gej_set_ge(&pj, &p);
+    secp256k1_ecmult(&ctx->ecmult_ctx, &rj, &pj, &e, &s);
+    if (secp256k1_gej_is_infinity(&rj)) {
+        return 0;
+    }
+    secp256k1_ge_set_gej_var(&r, &rj);
+    secp256k1_fe_normalize_var(&r.x);
+    secp256k1_fe_normalize_var(&r.y);
+    return !secp256k1_fe_is_odd(&r.y) && secp256k1_fe_equal_var(&r.x, &rx);
+}
+
+/* Number of signatures checked by one multi-multiplication in secp256k1_schnorr_verify_batch.
+ * Beyond this, the table building dominates and larger groups gain little. */
+#define SECP256K1_SCHNORR_BATCH_SIZE 64
+
+int secp256k1_schnorr_verify_batch(const secp256k1_context* ctx, const unsigned char * const *sigs64, const unsigned char * const *msgs32, const secp256k1_pubkey * const *pubkeys, size_t n) {
+    secp256k1_ge points[2 * SECP256K1_SCHNORR_BATCH_SIZE];
+    secp256k1_scalar scalars[2 * SECP256K1_SCHNORR_BATCH_SIZE];
+    secp256k1_scalar sg, a, e, s;
+    secp256k1_sha256_t sha;
+    secp256k1_gej rj;
+    secp256k1_fe rx;
+    unsigned char seed[36];
+    unsigned char buf[32];
+    unsigned char px[32];
+    size_t i, j, m;
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_ecmult_context_is_built(&ctx->ecmult_ctx));
+    ARG_CHECK(n == 0 || sigs64 != NULL);
+    ARG_CHECK(n == 0 || msgs32 != NULL);
+    ARG_CHECK(n == 0 || pubkeys != NULL);
+
+    /* The weights are derived from a hash of all inputs, so a signer cannot choose
+     * signatures whose errors cancel out. */
+    secp256k1_sha256_initialize(&sha);
+    for (i = 0; i < n; i++) {
+        ARG_CHECK(sigs64[i] != NULL);
+        ARG_CHECK(msgs32[i] != NULL);
+        ARG_CHECK(pubkeys[i] != NULL);
+        secp256k1_sha256_write(&sha, sigs64[i], 64);
+        secp256k1_sha256_write(&sha, msgs32[i], 32);
+        secp256k1_sha256_write(&sha, pubkeys[i]->data, sizeof(pubkeys[i]->data));
+    }
+    secp256k1_sha256_finalize(&sha, seed);
+
+    /* For each group, check that sum(a_i*s_i)*G - sum(a_i*e_i*P_i) - sum(a_i*R_i) is infinity.
+     * The first weight of a group is 1, the others are random 128-bit numbers. */
+    for (i = 0; i < n; i += m) {
+        m = n - i < SECP256K1_SCHNORR_BATCH_SIZE ? n - i : SECP256K1_SCHNORR_BATCH_SIZE;
+        if (m == 1) {
+            /* A single signature is cheaper to check on its own. */
+            if (!secp256k1_schnorr_verify(ctx, sigs64[i], msgs32[i], pubkeys[i])) {
+                return 0;
+            }
+            continue;
+        }
+        secp256k1_scalar_clear(&sg);
+        for (j = 0; j < m; j++) {
+            if (!secp256k1_schnorr_sig_load(&rx, &s, sigs64[i + j]) ||
+                !secp256k1_ge_set_xo_var(&points[2 * j], &rx, 0) ||
+                !secp256k1_schnorr_pubkey_load(ctx, &points[2 * j + 1], px, pubkeys[i + j])) {
+                return 0;
+            }
+            if (j == 0) {
+                secp256k1_scalar_set_int(&a, 1);
+            } else {
+                seed[32] = (i + j) >> 24;
+                seed[33] = (i + j) >> 16;
+                seed[34] = (i + j) >> 8;
+                seed[35] = i + j;
+                secp256k1_sha256_initialize(&sha);
+                secp256k1_sha256_write(&sha, seed, sizeof(seed));
+                secp256k1_sha256_finalize(&sha, buf);
+                memset(buf, 0, 16);
+                secp256k1_scalar_set_b32(&a, buf, NULL);
+            }
+            secp256k1_ge_neg(&points[2 * j], &points[2 * j]);
+            scalars[2 * j] = a;
+            secp256k1_schnorr_challenge(&e, sigs64[i + j], px, msgs32[i + j]);
+            secp256k1_scalar_mul(&e, &e, &a);
+            secp256k1_scalar_negate(&scalars[2 * j + 1], &e);
+            secp256k1_scalar_mul(&s, &s, &a);
+            secp256k1_scalar_add(&sg, &sg, &s);
+        }
+        secp256k1_ecmult_multi_var(&ctx->ecmult_ctx, &rj, points, scalars, 2 * m, &sg, &ctx->error_callback);
+        if (!secp256k1_gej_is_infinity(&rj)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+#endif
@@ -0,0 +1,273 @@
+/**********************************************************************
+ * Copyright (c) 2020 The libsecp256k1 developers                    *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#ifndef _SECP256K1_MODULE_SCHNORR_TESTS_
+#define _SECP256K1_MODULE_SCHNORR_TESTS_
+
+#include "include/secp256k1_schnorr.h"
+
+void test_schnorr_api(void) {
+    secp256k1_context *none = secp256k1_context_create(SECP256K1_CONTEXT_NONE);
+    secp256k1_context *sign = secp256k1_context_create(SECP256K1_CONTEXT_SIGN);
+    secp256k1_context *vrfy = secp256k1_context_create(SECP256K1_CONTEXT_VERIFY);
+    unsigned char key[32] = {0};
+    unsigned char msg[32] = {0};
+    unsigned char sig[64];
+    const unsigned char *sigp = sig;
+    const unsigned char *msgp = msg;
+    const secp256k1_pubkey *pubkeyp;
+    secp256k1_pubkey pubkey;
+    int32_t ecount = 0;
+
+    secp256k1_context_set_illegal_callback(none, counting_illegal_callback_fn, &ecount);
+    secp256k1_context_set_illegal_callback(sign, counting_illegal_callback_fn, &ecount);
+    secp256k1_context_set_illegal_callback(vrfy, counting_illegal_callback_fn, &ecount);
+    key[31] = 1;
+    CHECK(secp256k1_ec_pubkey_create(ctx, &pubkey, key) == 1);
+    pubkeyp = &pubkey;
+
+    CHECK(secp256k1_schnorr_sign(none, sig, msg, key, NULL) == 0);
+    CHECK(ecount == 1);
+    CHECK(secp256k1_schnorr_sign(vrfy, sig, msg, key, NULL) == 0);
+    CHECK(ecount == 2);
+    CHECK(secp256k1_schnorr_sign(sign, NULL, msg, key, NULL) == 0);
+    CHECK(ecount == 3);
+    CHECK(secp256k1_schnorr_sign(sign, sig, NULL, key, NULL) == 0);
+    CHECK(ecount == 4);
+    CHECK(secp256k1_schnorr_sign(sign, sig, msg, NULL, NULL) == 0);
+    CHECK(ecount == 5);
+    CHECK(secp256k1_schnorr_sign(sign, sig, msg, key, NULL) == 1);
+    CHECK(ecount == 5);
+
+    CHECK(secp256k1_schnorr_verify(sign, sig, msg, &pubkey) == 0);
+    CHECK(ecount == 6);
+    CHECK(secp256k1_schnorr_verify(vrfy, NULL, msg, &pubkey) == 0);
+    CHECK(ecount == 7);
+    CHECK(secp256k1_schnorr_verify(vrfy, sig, NULL, &pubkey) == 0);
+    CHECK(ecount == 8);
+    CHECK(secp256k1_schnorr_verify(vrfy, sig, msg, NULL) == 0);
+    CHECK(ecount == 9);
+    CHECK(secp256k1_schnorr_verify(vrfy, sig, msg, &pubkey) == 1);
+    CHECK(ecount == 9);
+
+    CHECK(secp256k1_schnorr_verify_batch(vrfy, NULL, NULL, NULL, 0) == 1);
+    CHECK(ecount == 9);
+    CHECK(secp256k1_schnorr_verify_batch(vrfy, NULL, &msgp, &pubkeyp, 1) == 0);
+    CHECK(ecount == 10);
+    CHECK(secp256k1_schnorr_verify_batch(vrfy, &sigp, &msgp, &pubkeyp, 1) == 1);
+    CHECK(ecount == 10);
+
+    secp256k1_context_destroy(none);
+    secp256k1_context_destroy(sign);
+    secp256k1_context_destroy(vrfy);
+}
+
+/* Checks signing and verification against a BIP340 test vector. */
+void test_schnorr_vector(const unsigned char *seckey, const unsigned char *px, const unsigned char *aux, const unsigned char *msg, const unsigned char *expected) {
+    unsigned char pubkey33[33];
+    unsigned char sig[64];
+    secp256k1_pubkey pubkey;
+
+    pubkey33[0] = 0x02;
+    memcpy(pubkey33 + 1, px, 32);
+    CHECK(secp256k1_ec_pubkey_parse(ctx, &pubkey, pubkey33, 33) == 1);
+    CHECK(secp256k1_schnorr_sign(ctx, sig, msg, seckey, aux) == 1);
+    CHECK(memcmp(sig, expected, 64) == 0);
+    CHECK(secp256k1_schnorr_verify(ctx, sig, msg, &pubkey) == 1);
+}
+
+void test_schnorr_bip340_vectors(void) {
+    {
+        static const unsigned char seckey[32] = {
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03
+        };
+        static const unsigned char px[32] = {
+            0xF9, 0x30, 0x8A, 0x01, 0x92, 0x58, 0xC3, 0x10, 0x49, 0x34, 0x4F, 0x85, 0xF8, 0x9D, 0x52, 0x29,
+            0xB5, 0x31, 0xC8, 0x45, 0x83, 0x6F, 0x99, 0xB0, 0x86, 0x01, 0xF1, 0x13, 0xBC, 0xE0, 0x36, 0xF9
+        };
+        static const unsigned char aux[32] = {0};
+        static const unsigned char msg[32] = {0};
+        static const unsigned char sig[64] = {
+            0xE9, 0x07, 0x83, 0x1F, 0x80, 0x84, 0x8D, 0x10, 0x69, 0xA5, 0x37, 0x1B, 0x40, 0x24, 0x10, 0x36,
+            0x4B, 0xDF, 0x1C, 0x5F, 0x83, 0x07, 0xB0, 0x08, 0x4C, 0x55, 0xF1, 0xCE, 0x2D, 0xCA, 0x82, 0x15,
+            0x25, 0xF6, 0x6A, 0x4A, 0x85, 0xEA, 0x8B, 0x71, 0xE4, 0x82, 0xA7, 0x4F, 0x38, 0x2D, 0x2C, 0xE5,
+            0xEB, 0xEE, 0xE8, 0xFD, 0xB2, 0x17, 0x2F, 0x47, 0x7D, 0xF4, 0x90, 0x0D, 0x31, 0x05, 0x36, 0xC0
+        };
+        test_schnorr_vector(seckey, px, aux, msg, sig);
+        /* A NULL aux_rand32 is the same as 32 zero bytes. */
+        test_schnorr_vector(seckey, px, NULL, msg, sig);
+    }
+    {
+        static const unsigned char seckey[32] = {
+            0xB7, 0xE1, 0x51, 0x62, 0x8A, 0xED, 0x2A, 0x6A, 0xBF, 0x71, 0x58, 0x80, 0x9C, 0xF4, 0xF3, 0xC7,
+            0x62, 0xE7, 0x16, 0x0F, 0x38, 0xB4, 0xDA, 0x56, 0xA7, 0x84, 0xD9, 0x04, 0x51, 0x90, 0xCF, 0xEF
+        };
+        static const unsigned char px[32] = {
+            0xDF, 0xF1, 0xD7, 0x7F, 0x2A, 0x67, 0x1C, 0x5F, 0x36, 0x18, 0x37, 0x26, 0xDB, 0x23, 0x41, 0xBE,
+            0x58, 0xFE, 0xAE, 0x1D, 0xA2, 0xDE, 0xCE, 0xD8, 0x43, 0x24, 0x0F, 0x7B, 0x50, 0x2B, 0xA6, 0x59
+        };
+        static const unsigned char aux[32] = {
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01
+        };
+        static const unsigned char msg[32] = {
+            0x24, 0x3F, 0x6A, 0x88, 0x85, 0xA3, 0x08, 0xD3, 0x13, 0x19, 0x8A, 0x2E, 0x03, 0x70, 0x73, 0x44,
+            0xA4, 0x09, 0x38, 0x22, 0x29, 0x9F, 0x31, 0xD0, 0x08, 0x2E, 0xFA, 0x98, 0xEC, 0x4E, 0x6C, 0x89
+        };
+        static const unsigned char sig[64] = {
+            0x68, 0x96, 0xBD, 0x60, 0xEE, 0xAE, 0x29, 0x6D, 0xB4, 0x8A, 0x22, 0x9F, 0xF7, 0x1D, 0xFE, 0x07,
+            0x1B, 0xDE, 0x41, 0x3E, 0x6D, 0x43, 0xF9, 0x17, 0xDC, 0x8D, 0xCF, 0x8C, 0x78, 0xDE, 0x33, 0x41,
+            0x89, 0x06, 0xD1, 0x1A, 0xC9, 0x76, 0xAB, 0xCC, 0xB2, 0x0B, 0x09, 0x12, 0x92, 0xBF, 0xF4, 0xEA,
+            0x89, 0x7E, 0xFC, 0xB6, 0x39, 0xEA, 0x87, 0x1C, 0xFA, 0x95, 0xF6, 0xDE, 0x33, 0x9E, 0x4B, 0x0A
+        };
+        test_schnorr_vector(seckey, px, aux, msg, sig);
+    }
+}
+
+void test_schnorr_sign_verify(void) {
+    unsigned char key[32];
+    unsigned char msg[32];
+    unsigned char aux[32];
+    unsigned char sig[64];
+    unsigned char sig2[64];
+    unsigned char pubkey33[33];
+    size_t len = 33;
+    secp256k1_pubkey pubkey, negpubkey;
+    secp256k1_scalar k;
+    int i;
+
+    random_scalar_order_test(&k);
+    secp256k1_scalar_get_b32(key, &k);
+    secp256k1_rand256_test(msg);
+    secp256k1_rand256_test(aux);
+    CHECK(secp256k1_ec_pubkey_create(ctx, &pubkey, key) == 1);
+    CHECK(secp256k1_schnorr_sign(ctx, sig, msg, key, aux) == 1);
+    CHECK(secp256k1_schnorr_verify(ctx, sig, msg, &pubkey) == 1);
+
+    /* Only the x coordinate of the public key matters. */
+    CHECK(secp256k1_ec_pubkey_serialize(ctx, pubkey33, &len, &pubkey, SECP256K1_EC_COMPRESSED) == 1);
+    pubkey33[0] ^= 1;
+    CHECK(secp256k1_ec_pubkey_parse(ctx, &negpubkey, pubkey33, 33) == 1);
+    CHECK(secp256k1_schnorr_verify(ctx, sig, msg, &negpubkey) == 1);
+
+    /* Other auxiliary randomness gives another valid signature. */
+    aux[0] ^= 1;
+    CHECK(secp256k1_schnorr_sign(ctx, sig2, msg, key, aux) == 1);
+    CHECK(memcmp(sig, sig2, 64) != 0);
+    CHECK(secp256k1_schnorr_verify(ctx, sig2, msg, &pubkey) == 1);
+
+    /* Changing any byte of the signature or the message makes it invalid. */
+    i = secp256k1_rand_int(64);
+    sig[i] ^= 1 + secp256k1_rand_int(255);
+    CHECK(secp256k1_schnorr_verify(ctx, sig, msg, &pubkey) == 0);
+    i = secp256k1_rand_int(32);
+    msg[i] ^= 1 + secp256k1_rand_int(255);
+    CHECK(secp256k1_schnorr_verify(ctx, sig2, msg, &pubkey) == 0);
+}
+
+void test_schnorr_sign_verify_edge_cases(void) {
+    static const unsigned char order[32] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE,
+        0xBA, 0xAE, 0xDC, 0xE6, 0xAF, 0x48, 0xA0, 0x3B, 0xBF, 0xD2, 0x5E, 0x8C, 0xD0, 0x36, 0x41, 0x41
+    };
+    static const unsigned char prime[32] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0xFF, 0xFF, 0xFC, 0x2F
+    };
+    unsigned char key[32] = {0};
+    unsigned char msg[32] = {0};
+    unsigned char sig[64];
+    secp256k1_pubkey pubkey;
+
+    /* Invalid secret keys. */
+    CHECK(secp256k1_schnorr_sign(ctx, sig, msg, key, NULL) == 0);
+    CHECK(secp256k1_schnorr_sign(ctx, sig, msg, order, NULL) == 0);
+
+    key[31] = 1;
+    CHECK(secp256k1_ec_pubkey_create(ctx, &pubkey, key) == 1);
+    CHECK(secp256k1_schnorr_sign(ctx, sig, msg, key, NULL) == 1);
+    CHECK(secp256k1_schnorr_verify(ctx, sig, msg, &pubkey) == 1);
+
+    /* s >= n and r >= p are rejected. */
+    memcpy(sig + 32, order, 32);
+    CHECK(secp256k1_schnorr_verify(ctx, sig, msg, &pubkey) == 0);
+    CHECK(secp256k1_schnorr_sign(ctx, sig, msg, key, NULL) == 1);
+    memcpy(sig, prime, 32);
+    CHECK(secp256k1_schnorr_verify(ctx, sig, msg, &pubkey) == 0);
+}
+
+void test_schnorr_verify_batch(size_t n, int bad) {
+    unsigned char (*keys)[32];
+    unsigned char (*msgs)[32];
+    unsigned char (*sigs)[64];
+    secp256k1_pubkey *pubkeys;
+    const unsigned char **sigps;
+    const unsigned char **msgps;
+    const secp256k1_pubkey **pubkeyps;
+    size_t i;
+
+    if (n == 0) {
+        /* An empty batch is valid and needs no arrays. */
+        CHECK(secp256k1_schnorr_verify_batch(ctx, NULL, NULL, NULL, 0) == 1);
+        return;
+    }
+    keys = (unsigned char (*)[32])checked_malloc(&ctx->error_callback, n * 32);
+    msgs = (unsigned char (*)[32])checked_malloc(&ctx->error_callback, n * 32);
+    sigs = (unsigned char (*)[64])checked_malloc(&ctx->error_callback, n * 64);
+    pubkeys = (secp256k1_pubkey *)checked_malloc(&ctx->error_callback, n * sizeof(secp256k1_pubkey));
+    sigps = (const unsigned char **)checked_malloc(&ctx->error_callback, n * sizeof(unsigned char *));
+    msgps = (const unsigned char **)checked_malloc(&ctx->error_callback, n * sizeof(unsigned char *));
+    pubkeyps = (const secp256k1_pubkey **)checked_malloc(&ctx->error_callback, n * sizeof(secp256k1_pubkey *));
+
+    for (i = 0; i < n; i++) {
+        secp256k1_scalar k;
+        random_scalar_order_test(&k);
+        secp256k1_scalar_get_b32(keys[i], &k);
+        secp256k1_rand256_test(msgs[i]);
+        CHECK(secp256k1_ec_pubkey_create(ctx, &pubkeys[i], keys[i]) == 1);
+        CHECK(secp256k1_schnorr_sign(ctx, sigs[i], msgs[i], keys[i], NULL) == 1);
+        sigps[i] = sigs[i];
+        msgps[i] = msgs[i];
+        pubkeyps[i] = &pubkeys[i];
+    }
+    CHECK(secp256k1_schnorr_verify_batch(ctx, sigps, msgps, pubkeyps, n) == 1);
+    if (bad) {
+        i = secp256k1_rand_int(n);
+        if (secp256k1_rand_bits(1)) {
+            sigs[i][32 + secp256k1_rand_int(32)] ^= 1;
+        } else {
+            msgs[i][secp256k1_rand_int(32)] ^= 1;
+        }
+        CHECK(secp256k1_schnorr_verify_batch(ctx, sigps, msgps, pubkeyps, n) == 0);
+        CHECK(secp256k1_schnorr_verify(ctx, sigs[i], msgs[i], &pubkeys[i]) == 0);
+    }
+
+    free(keys);
+    free(msgs);
+    free(sigs);
+    free(pubkeys);
+    free(sigps);
+    free(msgps);
+    free(pubkeyps);
+}
+
+void run_schnorr_tests(void) {
+    int i;
+    test_schnorr_api();
+    test_schnorr_bip340_vectors();
+    test_schnorr_sign_verify_edge_cases();
+    for (i = 0; i < count; i++) {
+        test_schnorr_sign_verify();
+    }
+    test_schnorr_verify_batch(0, 0);
+    test_schnorr_verify_batch(1, 1);
+    test_schnorr_verify_batch(2, 1);
+    test_schnorr_verify_batch(70, 0);
+    test_schnorr_verify_batch(70, 1);
+}
+
+#endif
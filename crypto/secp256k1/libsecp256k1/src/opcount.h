@@ -0,0 +1,38 @@
+/**********************************************************************
+ * Copyright (c) 2020 The libsecp256k1 developers                    *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#ifndef _SECP256K1_OPCOUNT_IMPL_H_
+#define _SECP256K1_OPCOUNT_IMPL_H_
+
+#if defined HAVE_CONFIG_H
+#include "libsecp256k1-config.h"
+#endif
+
+/* SECP256K1_OPCOUNT_INC(op) counts one call of op in the calling thread when the
+ * library is built with SECP256K1_OPCOUNT, and compiles to nothing otherwise. */
+#ifdef SECP256K1_OPCOUNT
+
+#include "include/secp256k1_opcount.h"
+
+#if defined(__GNUC__)
+# define SECP256K1_OPCOUNT_TLS __thread
+#elif defined(_MSC_VER)
+# define SECP256K1_OPCOUNT_TLS __declspec(thread)
+#else
+# error "SECP256K1_OPCOUNT needs thread-local storage"
+#endif
+
+static SECP256K1_OPCOUNT_TLS secp256k1_opcount secp256k1_opcount_counts;
+
+#define SECP256K1_OPCOUNT_INC(op) (secp256k1_opcount_counts.op++)
+
+#else
+
+#define SECP256K1_OPCOUNT_INC(op) ((void)0)
+
+#endif
+
+#endif
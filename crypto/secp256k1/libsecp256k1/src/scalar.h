@@ -63,6 +63,10 @@ static void secp256k1_scalar_inverse(secp256k1_scalar *r, const secp256k1_scalar
 /** Compute the inverse of a scalar (modulo the group order), without constant-time guarantee. */
 static void secp256k1_scalar_inverse_var(secp256k1_scalar *r, const secp256k1_scalar *a);
 
+/** Compute the inverse of a nonzero scalar using posdivsteps, without constant-time guarantee.
+ *  Returns 0 (leaving r undefined) if the computation did not converge. */
+static int secp256k1_scalar_inverse_divsteps_var(secp256k1_scalar *r, const secp256k1_scalar *a);
+
 /** Compute the complement of a scalar (modulo the group order). */
 static void secp256k1_scalar_negate(secp256k1_scalar *r, const secp256k1_scalar *a);
 
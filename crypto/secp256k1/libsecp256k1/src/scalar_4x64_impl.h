@@ -7,6 +7,8 @@
 #ifndef _SECP256K1_SCALAR_REPR_IMPL_H_
 #define _SECP256K1_SCALAR_REPR_IMPL_H_
 
+#include "modinv64_impl.h"
+
 /* Limbs of the secp256k1 order. */
 #define SECP256K1_N_0 ((uint64_t)0xBFD25E8CD0364141ULL)
 #define SECP256K1_N_1 ((uint64_t)0xBAAEDCE6AF48A03BULL)
@@ -946,4 +948,64 @@ SECP256K1_INLINE static void secp256k1_scalar_mul_shift_var(secp256k1_scalar *r,
     secp256k1_scalar_cadd_bit(r, 0, (l[(shift - 1) >> 6] >> ((shift - 1) & 0x3f)) & 1);
 }
 
+/* The secp256k1 order in signed62 notation. */
+static const secp256k1_modinv64_signed62 secp256k1_const_modulus_scalar62 = {{
+    0x3FD25E8CD0364141LL, 0x2ABB739ABD2280EELL, 0x3FFFFFFFFFFFFFEBLL, 0x3FFFFFFFFFFFFFFFLL, 0xFFLL
+}};
+
+static void secp256k1_scalar_to_signed62(secp256k1_modinv64_signed62 *r, const secp256k1_scalar *a) {
+    const uint64_t M62 = UINT64_MAX >> 2;
+    const uint64_t a0 = a->d[0], a1 = a->d[1], a2 = a->d[2], a3 = a->d[3];
+    r->v[0] =  a0                   & M62;
+    r->v[1] = (a0 >> 62 | a1 <<  2) & M62;
+    r->v[2] = (a1 >> 60 | a2 <<  4) & M62;
+    r->v[3] = (a2 >> 58 | a3 <<  6) & M62;
+    r->v[4] =  a3 >> 56;
+}
+
+static int secp256k1_scalar_inverse_divsteps_var(secp256k1_scalar *r, const secp256k1_scalar *a) {
+    /* 2^-62 mod n. */
+    static const secp256k1_scalar inv2p62 = SECP256K1_SCALAR_CONST(
+        0x2C37FD99UL, 0x5622C4FBUL, 0xFFFFFFFFUL, 0xFFFFFFFFUL,
+        0xC7CEE745UL, 0x110CB45AUL, 0xB558ED7CUL, 0x90C15A2FUL
+    );
+    secp256k1_modinv64_signed62 x;
+    secp256k1_modinv64_state s;
+    secp256k1_scalar d, e, scale;
+    int count;
+
+    /* Track f = d*a*scale and g = e*a*scale (mod n), where scale = 2^(-62*count) undoes the
+     * division performed by every step. Once f = 1, d*scale is the inverse. */
+    secp256k1_scalar_to_signed62(&x, a);
+    secp256k1_modinv64_init(&s, &x, &secp256k1_const_modulus_scalar62);
+    secp256k1_scalar_set_int(&d, 0);
+    secp256k1_scalar_set_int(&e, 1);
+    secp256k1_scalar_set_int(&scale, 1);
+
+    for (count = 0; count < 25; count++) {
+        secp256k1_modinv64_trans2x2 t;
+        secp256k1_scalar c, nd, tmp;
+        int done = secp256k1_modinv64_step_var(&s, &t);
+        c.d[1] = c.d[2] = c.d[3] = 0;
+        c.d[0] = (uint64_t)t.u;
+        secp256k1_scalar_mul(&nd, &d, &c);
+        c.d[0] = (uint64_t)t.v;
+        secp256k1_scalar_mul(&tmp, &e, &c);
+        secp256k1_scalar_add(&nd, &nd, &tmp);
+        c.d[0] = (uint64_t)t.r;
+        secp256k1_scalar_mul(&e, &e, &c);
+        c.d[0] = (uint64_t)t.q;
+        secp256k1_scalar_mul(&tmp, &d, &c);
+        secp256k1_scalar_add(&e, &e, &tmp);
+        d = nd;
+        secp256k1_scalar_mul(&scale, &scale, &inv2p62);
+        if (done) {
+            secp256k1_scalar_mul(r, &d, &scale);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
 #endif
@@ -7,6 +7,8 @@
 #ifndef _SECP256K1_SCALAR_REPR_IMPL_H_
 #define _SECP256K1_SCALAR_REPR_IMPL_H_
 
+#include "modinv32_impl.h"
+
 /* Limbs of the secp256k1 order. */
 #define SECP256K1_N_0 ((uint32_t)0xD0364141UL)
 #define SECP256K1_N_1 ((uint32_t)0xBFD25E8CUL)
@@ -718,4 +720,70 @@ SECP256K1_INLINE static void secp256k1_scalar_mul_shift_var(secp256k1_scalar *r,
     secp256k1_scalar_cadd_bit(r, 0, (l[(shift - 1) >> 5] >> ((shift - 1) & 0x1f)) & 1);
 }
 
+/* The secp256k1 order in signed30 notation. */
+static const secp256k1_modinv32_signed30 secp256k1_const_modulus_scalar30 = {{
+    0x10364141L, 0x3F497A33L, 0x348A03BBL, 0x2BB739ABL, 0x3FFFFEBAL,
+    0x3FFFFFFFL, 0x3FFFFFFFL, 0x3FFFFFFFL, 0xFFFFL
+}};
+
+static void secp256k1_scalar_to_signed30(secp256k1_modinv32_signed30 *r, const secp256k1_scalar *a) {
+    const uint32_t M30 = UINT32_MAX >> 2;
+    const uint32_t a0 = a->d[0], a1 = a->d[1], a2 = a->d[2], a3 = a->d[3],
+                   a4 = a->d[4], a5 = a->d[5], a6 = a->d[6], a7 = a->d[7];
+    r->v[0] =  a0                   & M30;
+    r->v[1] = (a0 >> 30 | a1 <<  2) & M30;
+    r->v[2] = (a1 >> 28 | a2 <<  4) & M30;
+    r->v[3] = (a2 >> 26 | a3 <<  6) & M30;
+    r->v[4] = (a3 >> 24 | a4 <<  8) & M30;
+    r->v[5] = (a4 >> 22 | a5 << 10) & M30;
+    r->v[6] = (a5 >> 20 | a6 << 12) & M30;
+    r->v[7] = (a6 >> 18 | a7 << 14) & M30;
+    r->v[8] =  a7 >> 16;
+}
+
+static int secp256k1_scalar_inverse_divsteps_var(secp256k1_scalar *r, const secp256k1_scalar *a) {
+    /* 2^-30 mod n. */
+    static const secp256k1_scalar inv2p30 = SECP256K1_SCALAR_CONST(
+        0x5622C4FBUL, 0xFFFFFFFFUL, 0xFFFFFFFFUL, 0xFFFFFFFFUL,
+        0x928A8F1CUL, 0x7AC7BEC1UL, 0x808B9F61UL, 0xC01EC327UL
+    );
+    secp256k1_modinv32_signed30 x;
+    secp256k1_modinv32_state s;
+    secp256k1_scalar d, e, scale;
+    int count;
+
+    /* Track f = d*a*scale and g = e*a*scale (mod n), where scale = 2^(-30*count) undoes the
+     * division performed by every step. Once f = 1, d*scale is the inverse. */
+    secp256k1_scalar_to_signed30(&x, a);
+    secp256k1_modinv32_init(&s, &x, &secp256k1_const_modulus_scalar30);
+    secp256k1_scalar_set_int(&d, 0);
+    secp256k1_scalar_set_int(&e, 1);
+    secp256k1_scalar_set_int(&scale, 1);
+
+    for (count = 0; count < 50; count++) {
+        secp256k1_modinv32_trans2x2 t;
+        secp256k1_scalar c, nd, tmp;
+        int done = secp256k1_modinv32_step_var(&s, &t);
+        secp256k1_scalar_set_int(&c, 0);
+        c.d[0] = (uint32_t)t.u;
+        secp256k1_scalar_mul(&nd, &d, &c);
+        c.d[0] = (uint32_t)t.v;
+        secp256k1_scalar_mul(&tmp, &e, &c);
+        secp256k1_scalar_add(&nd, &nd, &tmp);
+        c.d[0] = (uint32_t)t.r;
+        secp256k1_scalar_mul(&e, &e, &c);
+        c.d[0] = (uint32_t)t.q;
+        secp256k1_scalar_mul(&tmp, &d, &c);
+        secp256k1_scalar_add(&e, &e, &tmp);
+        d = nd;
+        secp256k1_scalar_mul(&scale, &scale, &inv2p30);
+        if (done) {
+            secp256k1_scalar_mul(r, &d, &scale);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
 #endif
@@ -9,6 +9,7 @@
 
 #include "group.h"
 #include "scalar.h"
+#include "opcount.h"
 
 #if defined HAVE_CONFIG_H
 #include "libsecp256k1-config.h"
@@ -55,6 +56,7 @@ static void secp256k1_scalar_order_get_num(secp256k1_num *r) {
 static void secp256k1_scalar_inverse(secp256k1_scalar *r, const secp256k1_scalar *x) {
 #if defined(EXHAUSTIVE_TEST_ORDER)
     int i;
+    SECP256K1_OPCOUNT_INC(scalar_inverse);
     *r = 0;
     for (i = 0; i < EXHAUSTIVE_TEST_ORDER; i++)
         if ((i * *x) % EXHAUSTIVE_TEST_ORDER == 1)
@@ -68,6 +70,7 @@ static void secp256k1_scalar_inverse(secp256k1_scalar *r, const secp256k1_scalar
     int i;
     /* First compute x ^ (2^N - 1) for some values of N. */
     secp256k1_scalar x2, x3, x4, x6, x7, x8, x15, x30, x60, x120, x127;
+    SECP256K1_OPCOUNT_INC(scalar_inverse);
 
     secp256k1_scalar_sqr(&x2,  x);
     secp256k1_scalar_mul(&x2, &x2,  x);
@@ -261,11 +264,23 @@ SECP256K1_INLINE static int secp256k1_scalar_is_even(const secp256k1_scalar *a)
 
 static void secp256k1_scalar_inverse_var(secp256k1_scalar *r, const secp256k1_scalar *x) {
 #if defined(USE_SCALAR_INV_BUILTIN)
-    secp256k1_scalar_inverse(r, x);
+    SECP256K1_OPCOUNT_INC(scalar_inverse_var);
+    if (secp256k1_scalar_is_zero(x)) {
+        /* Zero has no inverse; return zero like secp256k1_scalar_inverse. */
+        secp256k1_scalar_clear(r);
+        return;
+    }
+    if (!secp256k1_scalar_inverse_divsteps_var(r, x)) {
+        /* The exhaustive test groups have no divsteps implementation and always end up here.
+         * Elsewhere this is a safety net only: posdivsteps has no proven bound, but nonzero
+         * inputs have never needed more than about 60% of the steps allowed. */
+        secp256k1_scalar_inverse(r, x);
+    }
 #elif defined(USE_SCALAR_INV_NUM)
     unsigned char b[32];
     secp256k1_num n, m;
     secp256k1_scalar t = *x;
+    SECP256K1_OPCOUNT_INC(scalar_inverse_var);
     secp256k1_scalar_get_b32(b, &t);
     secp256k1_num_set_bin(&n, b, 32);
     secp256k1_scalar_order_get_num(&m);
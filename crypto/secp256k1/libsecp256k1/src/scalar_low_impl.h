@@ -111,4 +111,11 @@ SECP256K1_INLINE static int secp256k1_scalar_eq(const secp256k1_scalar *a, const
     return *a == *b;
 }
 
+static int secp256k1_scalar_inverse_divsteps_var(secp256k1_scalar *r, const secp256k1_scalar *a) {
+    /* The tiny test groups just use the regular inversion. */
+    (void)r;
+    (void)a;
+    return 0;
+}
+
 #endif
@@ -522,6 +522,10 @@ int secp256k1_context_randomize(secp256k1_context* ctx, const unsigned char *see
     return 1;
 }
 
+/* Number of keys from which secp256k1_ec_pubkey_combine switches to secp256k1_ge_sum_all_var.
+ * Below it, the inversion per tree level costs more than the cheaper additions save. */
+#define SECP256K1_COMBINE_TREE_MIN 256
+
 int secp256k1_ec_pubkey_combine(const secp256k1_context* ctx, secp256k1_pubkey *pubnonce, const secp256k1_pubkey * const *pubnonces, size_t n) {
     size_t i;
     secp256k1_gej Qj;
@@ -532,20 +536,135 @@ int secp256k1_ec_pubkey_combine(const secp256k1_context* ctx, secp256k1_pubkey *
     ARG_CHECK(n >= 1);
     ARG_CHECK(pubnonces != NULL);
 
+    if (n >= SECP256K1_COMBINE_TREE_MIN) {
+        secp256k1_ge *points = (secp256k1_ge *)checked_malloc(&ctx->error_callback, sizeof(secp256k1_ge) * n);
+        for (i = 0; i < n; i++) {
+            if (!secp256k1_pubkey_load(ctx, &points[i], pubnonces[i])) {
+                free(points);
+                return 0;
+            }
+        }
+        secp256k1_ge_sum_all_var(&Q, points, n, &ctx->error_callback);
+        free(points);
+        if (secp256k1_ge_is_infinity(&Q)) {
+            return 0;
+        }
+        secp256k1_pubkey_save(pubnonce, &Q);
+        return 1;
+    }
+
+    /* Public keys are not secret, so the variable time formulas are fine. */
     secp256k1_gej_set_infinity(&Qj);
 
     for (i = 0; i < n; i++) {
         secp256k1_pubkey_load(ctx, &Q, pubnonces[i]);
-        secp256k1_gej_add_ge(&Qj, &Qj, &Q);
+        secp256k1_gej_add_ge_var(&Qj, &Qj, &Q, NULL);
     }
     if (secp256k1_gej_is_infinity(&Qj)) {
         return 0;
     }
-    secp256k1_ge_set_gej(&Q, &Qj);
+    secp256k1_ge_set_gej_var(&Q, &Qj);
     secp256k1_pubkey_save(pubnonce, &Q);
     return 1;
 }
 
+struct secp256k1_ec_pubkey_aggregate_struct {
+    secp256k1_gej sum;
+    size_t count;
+};
+
+secp256k1_ec_pubkey_aggregate* secp256k1_ec_pubkey_aggregate_create(const secp256k1_context* ctx, const secp256k1_pubkey * const *ins, size_t n) {
+    secp256k1_ec_pubkey_aggregate *agg;
+    secp256k1_ge *points = NULL;
+    secp256k1_ge sum;
+    size_t i;
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(n == 0 || ins != NULL);
+
+    agg = (secp256k1_ec_pubkey_aggregate*)checked_malloc(&ctx->error_callback, sizeof(secp256k1_ec_pubkey_aggregate));
+    secp256k1_gej_set_infinity(&agg->sum);
+    agg->count = n;
+    if (n > 0) {
+        points = (secp256k1_ge *)checked_malloc(&ctx->error_callback, sizeof(secp256k1_ge) * n);
+        for (i = 0; i < n; i++) {
+            if (!secp256k1_pubkey_load(ctx, &points[i], ins[i])) {
+                free(points);
+                free(agg);
+                return NULL;
+            }
+        }
+        secp256k1_ge_sum_all_var(&sum, points, n, &ctx->error_callback);
+        free(points);
+        if (!secp256k1_ge_is_infinity(&sum)) {
+            secp256k1_gej_set_ge(&agg->sum, &sum);
+        }
+    }
+    return agg;
+}
+
+void secp256k1_ec_pubkey_aggregate_destroy(secp256k1_ec_pubkey_aggregate* agg) {
+    free(agg);
+}
+
+int secp256k1_ec_pubkey_aggregate_add(const secp256k1_context* ctx, secp256k1_ec_pubkey_aggregate *agg, const secp256k1_pubkey *pubkey) {
+    secp256k1_ge p;
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(agg != NULL);
+    ARG_CHECK(pubkey != NULL);
+
+    if (!secp256k1_pubkey_load(ctx, &p, pubkey)) {
+        return 0;
+    }
+    secp256k1_gej_add_ge_var(&agg->sum, &agg->sum, &p, NULL);
+    agg->count++;
+    return 1;
+}
+
+int secp256k1_ec_pubkey_aggregate_remove(const secp256k1_context* ctx, secp256k1_ec_pubkey_aggregate *agg, const secp256k1_pubkey *pubkey) {
+    secp256k1_ge p;
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(agg != NULL);
+    ARG_CHECK(pubkey != NULL);
+
+    if (agg->count == 0) {
+        return 0;
+    }
+    if (!secp256k1_pubkey_load(ctx, &p, pubkey)) {
+        return 0;
+    }
+    secp256k1_ge_neg(&p, &p);
+    secp256k1_gej_add_ge_var(&agg->sum, &agg->sum, &p, NULL);
+    agg->count--;
+    return 1;
+}
+
+int secp256k1_ec_pubkey_aggregate_get(const secp256k1_context* ctx, secp256k1_pubkey *out, const secp256k1_ec_pubkey_aggregate *agg) {
+    secp256k1_gej sum;
+    secp256k1_ge Q;
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(out != NULL);
+    memset(out, 0, sizeof(*out));
+    ARG_CHECK(agg != NULL);
+
+    if (secp256k1_gej_is_infinity(&agg->sum)) {
+        return 0;
+    }
+    sum = agg->sum;
+    secp256k1_ge_set_gej_var(&Q, &sum);
+    secp256k1_pubkey_save(out, &Q);
+    return 1;
+}
+
+#ifdef SECP256K1_OPCOUNT
+void secp256k1_opcount_snapshot(secp256k1_opcount *counts) {
+    *counts = secp256k1_opcount_counts;
+}
+
+void secp256k1_opcount_reset(void) {
+    memset(&secp256k1_opcount_counts, 0, sizeof(secp256k1_opcount_counts));
+}
+#endif
+
 #ifdef ENABLE_MODULE_ECDH
 # include "modules/ecdh/main_impl.h"
 #endif
@@ -274,6 +274,26 @@ void run_sha256_tests(void) {
     }
 }
 
+#ifdef USE_SHA256_ARMV8
+void run_sha256_armv8_tests(void) {
+    /* Compare the ARMv8 transformation with the C one on random states and chunks. */
+    int i;
+    if (!secp256k1_sha256_have_armv8()) {
+        return;
+    }
+    for (i = 0; i < 100*count; i++) {
+        uint32_t s1[8], s2[8], chunk[16];
+        secp256k1_rand256((unsigned char*)s1);
+        secp256k1_rand256((unsigned char*)chunk);
+        secp256k1_rand256((unsigned char*)(chunk + 8));
+        memcpy(s2, s1, sizeof(s1));
+        secp256k1_sha256_transform(s1, chunk);
+        secp256k1_sha256_transform_armv8(s2, chunk);
+        CHECK(memcmp(s1, s2, sizeof(s1)) == 0);
+    }
+}
+#endif
+
 void run_hmac_sha256_tests(void) {
     static const char *keys[6] = {
         "\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b",
@@ -318,6 +338,72 @@ void run_hmac_sha256_tests(void) {
     }
 }
 
+void run_sha512_tests(void) {
+    static const char *inputs[5] = {
+        "",
+        "abc",
+        "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+        "This input is 111 bytes long, one byte short of the length at which SHA-512 padding needs a second block!!!!!!!",
+        "And this one is exactly 128 bytes long, which is exactly one SHA-512 block, so that the padding goes into a block of its own...."
+    };
+    static const unsigned char outputs[5][64] = {
+        {0xcf, 0x83, 0xe1, 0x35, 0x7e, 0xef, 0xb8, 0xbd, 0xf1, 0x54, 0x28, 0x50, 0xd6, 0x6d, 0x80, 0x07, 0xd6, 0x20, 0xe4, 0x05, 0x0b, 0x57, 0x15, 0xdc, 0x83, 0xf4, 0xa9, 0x21, 0xd3, 0x6c, 0xe9, 0xce, 0x47, 0xd0, 0xd1, 0x3c, 0x5d, 0x85, 0xf2, 0xb0, 0xff, 0x83, 0x18, 0xd2, 0x87, 0x7e, 0xec, 0x2f, 0x63, 0xb9, 0x31, 0xbd, 0x47, 0x41, 0x7a, 0x81, 0xa5, 0x38, 0x32, 0x7a, 0xf9, 0x27, 0xda, 0x3e},
+        {0xdd, 0xaf, 0x35, 0xa1, 0x93, 0x61, 0x7a, 0xba, 0xcc, 0x41, 0x73, 0x49, 0xae, 0x20, 0x41, 0x31, 0x12, 0xe6, 0xfa, 0x4e, 0x89, 0xa9, 0x7e, 0xa2, 0x0a, 0x9e, 0xee, 0xe6, 0x4b, 0x55, 0xd3, 0x9a, 0x21, 0x92, 0x99, 0x2a, 0x27, 0x4f, 0xc1, 0xa8, 0x36, 0xba, 0x3c, 0x23, 0xa3, 0xfe, 0xeb, 0xbd, 0x45, 0x4d, 0x44, 0x23, 0x64, 0x3c, 0xe8, 0x0e, 0x2a, 0x9a, 0xc9, 0x4f, 0xa5, 0x4c, 0xa4, 0x9f},
+        {0x8e, 0x95, 0x9b, 0x75, 0xda, 0xe3, 0x13, 0xda, 0x8c, 0xf4, 0xf7, 0x28, 0x14, 0xfc, 0x14, 0x3f, 0x8f, 0x77, 0x79, 0xc6, 0xeb, 0x9f, 0x7f, 0xa1, 0x72, 0x99, 0xae, 0xad, 0xb6, 0x88, 0x90, 0x18, 0x50, 0x1d, 0x28, 0x9e, 0x49, 0x00, 0xf7, 0xe4, 0x33, 0x1b, 0x99, 0xde, 0xc4, 0xb5, 0x43, 0x3a, 0xc7, 0xd3, 0x29, 0xee, 0xb6, 0xdd, 0x26, 0x54, 0x5e, 0x96, 0xe5, 0x5b, 0x87, 0x4b, 0xe9, 0x09},
+        {0x06, 0x0d, 0xb8, 0x19, 0xe4, 0x83, 0xb5, 0x8c, 0xee, 0x08, 0x5d, 0x56, 0x45, 0x03, 0x79, 0x0c, 0xde, 0xb9, 0x0b, 0x09, 0x1b, 0x2f, 0x1b, 0xb8, 0x20, 0x4b, 0x5f, 0x2f, 0x40, 0x97, 0x1b, 0xcb, 0x3d, 0x4f, 0x86, 0x76, 0xf5, 0x0d, 0x66, 0x9e, 0x7d, 0xc0, 0x32, 0xcc, 0x68, 0x8f, 0x1a, 0x56, 0x27, 0x9d, 0xee, 0xa0, 0x36, 0x57, 0x27, 0x3f, 0x1b, 0xab, 0x23, 0xc5, 0xb8, 0xd3, 0xab, 0x9a},
+        {0x7b, 0x95, 0xe9, 0x8a, 0x0d, 0x9c, 0x04, 0x4c, 0x8d, 0x67, 0xd7, 0x66, 0xeb, 0x3c, 0xa0, 0xe4, 0xbf, 0x19, 0xa5, 0x4d, 0x95, 0xb7, 0xfa, 0x69, 0xc2, 0xb0, 0x59, 0x7f, 0xf4, 0x52, 0x39, 0x31, 0xfa, 0xa8, 0x11, 0xdf, 0x00, 0x2b, 0x0c, 0x2a, 0xcb, 0x16, 0x1e, 0x84, 0xe5, 0x2c, 0x43, 0xde, 0x99, 0x23, 0xb7, 0x5b, 0xa8, 0x06, 0x94, 0x5a, 0xaa, 0xe7, 0x75, 0x4a, 0xd3, 0xf4, 0x70, 0x12}
+    };
+    int i;
+    for (i = 0; i < 5; i++) {
+        unsigned char out[64];
+        secp256k1_sha512_t hasher;
+        secp256k1_sha512_initialize(&hasher);
+        secp256k1_sha512_write(&hasher, (const unsigned char*)(inputs[i]), strlen(inputs[i]));
+        secp256k1_sha512_finalize(&hasher, out);
+        CHECK(memcmp(out, outputs[i], 64) == 0);
+        if (strlen(inputs[i]) > 0) {
+            int split = secp256k1_rand_int(strlen(inputs[i]));
+            secp256k1_sha512_initialize(&hasher);
+            secp256k1_sha512_write(&hasher, (const unsigned char*)(inputs[i]), split);
+            secp256k1_sha512_write(&hasher, (const unsigned char*)(inputs[i] + split), strlen(inputs[i]) - split);
+            secp256k1_sha512_finalize(&hasher, out);
+            CHECK(memcmp(out, outputs[i], 64) == 0);
+        }
+    }
+}
+
+void run_hmac_sha512_tests(void) {
+    static const char *keys[4] = {
+        "\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b",
+        "\x4a\x65\x66\x65",
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa",
+        "\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa\xaa"
+    };
+    static const char *inputs[4] = {
+        "\x48\x69\x20\x54\x68\x65\x72\x65",
+        "\x77\x68\x61\x74\x20\x64\x6f\x20\x79\x61\x20\x77\x61\x6e\x74\x20\x66\x6f\x72\x20\x6e\x6f\x74\x68\x69\x6e\x67\x3f",
+        "\x54\x65\x73\x74\x20\x55\x73\x69\x6e\x67\x20\x4c\x61\x72\x67\x65\x72\x20\x54\x68\x61\x6e\x20\x42\x6c\x6f\x63\x6b\x2d\x53\x69\x7a\x65\x20\x4b\x65\x79\x20\x2d\x20\x48\x61\x73\x68\x20\x4b\x65\x79\x20\x46\x69\x72\x73\x74",
+        "\x54\x68\x69\x73\x20\x69\x73\x20\x61\x20\x74\x65\x73\x74\x20\x75\x73\x69\x6e\x67\x20\x61\x20\x6c\x61\x72\x67\x65\x72\x20\x74\x68\x61\x6e\x20\x62\x6c\x6f\x63\x6b\x2d\x73\x69\x7a\x65\x20\x6b\x65\x79\x20\x61\x6e\x64\x20\x61\x20\x6c\x61\x72\x67\x65\x72\x20\x74\x68\x61\x6e\x20\x62\x6c\x6f\x63\x6b\x2d\x73\x69\x7a\x65\x20\x64\x61\x74\x61\x2e\x20\x54\x68\x65\x20\x6b\x65\x79\x20\x6e\x65\x65\x64\x73\x20\x74\x6f\x20\x62\x65\x20\x68\x61\x73\x68\x65\x64\x20\x62\x65\x66\x6f\x72\x65\x20\x62\x65\x69\x6e\x67\x20\x75\x73\x65\x64\x20\x62\x79\x20\x74\x68\x65\x20\x48\x4d\x41\x43\x20\x61\x6c\x67\x6f\x72\x69\x74\x68\x6d\x2e"
+    };
+    static const unsigned char outputs[4][64] = {
+        {0x87, 0xaa, 0x7c, 0xde, 0xa5, 0xef, 0x61, 0x9d, 0x4f, 0xf0, 0xb4, 0x24, 0x1a, 0x1d, 0x6c, 0xb0, 0x23, 0x79, 0xf4, 0xe2, 0xce, 0x4e, 0xc2, 0x78, 0x7a, 0xd0, 0xb3, 0x05, 0x45, 0xe1, 0x7c, 0xde, 0xda, 0xa8, 0x33, 0xb7, 0xd6, 0xb8, 0xa7, 0x02, 0x03, 0x8b, 0x27, 0x4e, 0xae, 0xa3, 0xf4, 0xe4, 0xbe, 0x9d, 0x91, 0x4e, 0xeb, 0x61, 0xf1, 0x70, 0x2e, 0x69, 0x6c, 0x20, 0x3a, 0x12, 0x68, 0x54},
+        {0x16, 0x4b, 0x7a, 0x7b, 0xfc, 0xf8, 0x19, 0xe2, 0xe3, 0x95, 0xfb, 0xe7, 0x3b, 0x56, 0xe0, 0xa3, 0x87, 0xbd, 0x64, 0x22, 0x2e, 0x83, 0x1f, 0xd6, 0x10, 0x27, 0x0c, 0xd7, 0xea, 0x25, 0x05, 0x54, 0x97, 0x58, 0xbf, 0x75, 0xc0, 0x5a, 0x99, 0x4a, 0x6d, 0x03, 0x4f, 0x65, 0xf8, 0xf0, 0xe6, 0xfd, 0xca, 0xea, 0xb1, 0xa3, 0x4d, 0x4a, 0x6b, 0x4b, 0x63, 0x6e, 0x07, 0x0a, 0x38, 0xbc, 0xe7, 0x37},
+        {0x80, 0xb2, 0x42, 0x63, 0xc7, 0xc1, 0xa3, 0xeb, 0xb7, 0x14, 0x93, 0xc1, 0xdd, 0x7b, 0xe8, 0xb4, 0x9b, 0x46, 0xd1, 0xf4, 0x1b, 0x4a, 0xee, 0xc1, 0x12, 0x1b, 0x01, 0x37, 0x83, 0xf8, 0xf3, 0x52, 0x6b, 0x56, 0xd0, 0x37, 0xe0, 0x5f, 0x25, 0x98, 0xbd, 0x0f, 0xd2, 0x21, 0x5d, 0x6a, 0x1e, 0x52, 0x95, 0xe6, 0x4f, 0x73, 0xf6, 0x3f, 0x0a, 0xec, 0x8b, 0x91, 0x5a, 0x98, 0x5d, 0x78, 0x65, 0x98},
+        {0xe3, 0x7b, 0x6a, 0x77, 0x5d, 0xc8, 0x7d, 0xba, 0xa4, 0xdf, 0xa9, 0xf9, 0x6e, 0x5e, 0x3f, 0xfd, 0xde, 0xbd, 0x71, 0xf8, 0x86, 0x72, 0x89, 0x86, 0x5d, 0xf5, 0xa3, 0x2d, 0x20, 0xcd, 0xc9, 0x44, 0xb6, 0x02, 0x2c, 0xac, 0x3c, 0x49, 0x82, 0xb1, 0x0d, 0x5e, 0xeb, 0x55, 0xc3, 0xe4, 0xde, 0x15, 0x13, 0x46, 0x76, 0xfb, 0x6d, 0xe0, 0x44, 0x60, 0x65, 0xc9, 0x74, 0x40, 0xfa, 0x8c, 0x6a, 0x58}
+    };
+    int i;
+    for (i = 0; i < 4; i++) {
+        secp256k1_hmac_sha512_t hasher;
+        unsigned char out[64];
+        int split = secp256k1_rand_int(strlen(inputs[i]));
+        secp256k1_hmac_sha512_initialize(&hasher, (const unsigned char*)(keys[i]), strlen(keys[i]));
+        secp256k1_hmac_sha512_write(&hasher, (const unsigned char*)(inputs[i]), split);
+        secp256k1_hmac_sha512_write(&hasher, (const unsigned char*)(inputs[i] + split), strlen(inputs[i]) - split);
+        secp256k1_hmac_sha512_finalize(&hasher, out);
+        CHECK(memcmp(out, outputs[i], 64) == 0);
+    }
+}
+
 void run_rfc6979_hmac_sha256_tests(void) {
     static const unsigned char key1[65] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x00, 0x4b, 0xf5, 0x12, 0x2f, 0x34, 0x45, 0x54, 0xc5, 0x3b, 0xde, 0x2e, 0xbb, 0x8c, 0xd2, 0xb7, 0xe3, 0xd1, 0x60, 0x0a, 0xd6, 0x31, 0xc3, 0x85, 0xa5, 0xd7, 0xcc, 0xe2, 0x3c, 0x77, 0x85, 0x45, 0x9a, 0};
     static const unsigned char out1[3][32] = {
@@ -1767,6 +1853,35 @@ void run_sqr(void) {
     }
 }
 
+void run_field_mul_sqr(void) {
+    /* Operands negated at magnitude 8 push every limb close to the bound the inner
+     * multiplication accepts; the results must match those of the normalized operands. */
+    secp256k1_fe x, y, xn, yn, r, s;
+    secp256k1_fe one = SECP256K1_FE_CONST(0, 0, 0, 0, 0, 0, 0, 1);
+    int i;
+    x = one;
+    secp256k1_fe_negate(&x, &x, 1);
+    secp256k1_fe_sqr(&r, &x);
+    CHECK(check_fe_equal(&r, &one));
+    for (i = 0; i < 10*count; i++) {
+        random_fe_test(&x);
+        random_fe_test(&y);
+        secp256k1_fe_negate(&xn, &x, 7);
+        secp256k1_fe_negate(&yn, &y, 7);
+        secp256k1_fe_mul(&s, &x, &y);
+        secp256k1_fe_mul(&r, &xn, &yn);
+        CHECK(check_fe_equal(&r, &s));
+        secp256k1_fe_mul(&r, &xn, &y);
+        secp256k1_fe_add(&r, &s);
+        CHECK(secp256k1_fe_normalizes_to_zero_var(&r));
+        secp256k1_fe_sqr(&s, &x);
+        secp256k1_fe_sqr(&r, &xn);
+        CHECK(check_fe_equal(&r, &s));
+        secp256k1_fe_mul(&r, &x, &x);
+        CHECK(check_fe_equal(&r, &s));
+    }
+}
+
 void test_sqrt(const secp256k1_fe *a, const secp256k1_fe *k) {
     secp256k1_fe r1, r2;
     int v = secp256k1_fe_sqrt(&r1, a);
@@ -1815,6 +1930,78 @@ void run_sqrt(void) {
     }
 }
 
+void test_fe_jacobi(const secp256k1_fe *a) {
+    secp256k1_fe an = *a, r;
+    int jac;
+    secp256k1_fe_normalize_var(&an);
+    jac = secp256k1_fe_jacobi_var(&an);
+#if defined(USE_FIELD_10X26) || defined(HAVE___INT128)
+    CHECK(jac == 1 || jac == -1);
+#endif
+    if (jac != 0) {
+        CHECK((jac == 1) == secp256k1_fe_sqrt(&r, &an));
+    }
+#ifndef USE_NUM_NONE
+    {
+        /* Compare with the GMP based computation. */
+        static const unsigned char prime[32] = {
+            0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+            0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+            0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+            0xFF,0xFF,0xFF,0xFE,0xFF,0xFF,0xFC,0x2F
+        };
+        unsigned char b[32];
+        secp256k1_num n, m;
+        secp256k1_fe_get_b32(b, &an);
+        secp256k1_num_set_bin(&n, b, 32);
+        secp256k1_num_set_bin(&m, prime, 32);
+        CHECK(jac == 0 || jac == secp256k1_num_jacobi(&n, &m));
+    }
+#endif
+    CHECK(secp256k1_fe_is_quad_var(a) == secp256k1_fe_sqrt(&r, a));
+}
+
+void run_fe_jacobi(void) {
+    secp256k1_fe x, s, ns, t;
+    int i;
+
+    /* Zero is treated as a quadratic residue. */
+    secp256k1_fe_set_int(&x, 0);
+    CHECK(secp256k1_fe_is_quad_var(&x));
+
+    /* Small squares are residues; their negatives are not, as p = 3 mod 4. */
+    for (i = 1; i <= 100; i++) {
+        secp256k1_fe_set_int(&x, i);
+        secp256k1_fe_sqr(&s, &x);
+        test_fe_jacobi(&s);
+        CHECK(secp256k1_fe_is_quad_var(&s));
+        secp256k1_fe_negate(&t, &s, 1);
+        test_fe_jacobi(&t);
+        CHECK(!secp256k1_fe_is_quad_var(&t));
+    }
+
+    /* Small values and values near p. */
+    for (i = 1; i <= 100; i++) {
+        secp256k1_fe_set_int(&x, i);
+        test_fe_jacobi(&x);
+        secp256k1_fe_negate(&t, &x, 1);
+        test_fe_jacobi(&t);
+    }
+
+    /* Random values, their squares and non-square multiples. */
+    for (i = 0; i < 10 * count; i++) {
+        random_fe_non_zero(&x);
+        random_fe_non_square(&ns);
+        test_fe_jacobi(&x);
+        secp256k1_fe_sqr(&s, &x);
+        test_fe_jacobi(&s);
+        CHECK(secp256k1_fe_is_quad_var(&s));
+        secp256k1_fe_mul(&t, &s, &ns);
+        test_fe_jacobi(&t);
+        CHECK(!secp256k1_fe_is_quad_var(&t));
+    }
+}
+
 /***** GROUP TESTS *****/
 
 void ge_equals_ge(const secp256k1_ge *a, const secp256k1_ge *b) {
@@ -1984,6 +2171,15 @@ void test_ge(void) {
                 ge_equals_gej(&ref, &resj);
             }
 
+            /* Test gep + ge (const, complete). */
+            if (i2 != 0) {
+                secp256k1_gep resp;
+                secp256k1_gep_set_gej(&resp, &gej[i1]);
+                secp256k1_gep_add_ge(&resp, &resp, &ge[i2]);
+                secp256k1_gej_set_gep(&resj, &resp);
+                ge_equals_gej(&ref, &resj);
+            }
+
             /* Test doubling (var). */
             if ((i1 == 0 && i2 == 0) || ((i1 + 3)/4 == (i2 + 3)/4 && ((i1 + 3)%4)/2 == ((i2 + 3)%4)/2)) {
                 secp256k1_fe zr2;
@@ -2134,6 +2330,15 @@ void test_add_neg_y_diff_x(void) {
     secp256k1_gej_add_ge_var(&resj, &aj, &b, NULL);
     secp256k1_ge_set_gej(&res, &resj);
     ge_equals_gej(&res, &sumj);
+
+    {
+        secp256k1_gep resp;
+        secp256k1_gep_set_gej(&resp, &aj);
+        secp256k1_gep_add_ge(&resp, &resp, &b);
+        secp256k1_gej_set_gep(&resj, &resp);
+        secp256k1_ge_set_gej(&res, &resj);
+        ge_equals_gej(&res, &sumj);
+    }
 }
 
 void run_ge(void) {
@@ -2169,11 +2374,89 @@ void test_ec_combine(void) {
     }
 }
 
+/* Combine n keys, including repeated and negated ones so that the tree sum hits
+ * doublings and cancellations, and check the result and an aggregate of them. */
+void test_ec_combine_many(size_t n) {
+    secp256k1_scalar sum = SECP256K1_SCALAR_CONST(0, 0, 0, 0, 0, 0, 0, 0);
+    secp256k1_scalar *s = (secp256k1_scalar *)checked_malloc(&ctx->error_callback, sizeof(secp256k1_scalar) * n);
+    secp256k1_pubkey *data = (secp256k1_pubkey *)checked_malloc(&ctx->error_callback, sizeof(secp256k1_pubkey) * n);
+    const secp256k1_pubkey **d = (const secp256k1_pubkey **)checked_malloc(&ctx->error_callback, sizeof(secp256k1_pubkey *) * n);
+    secp256k1_ec_pubkey_aggregate *agg;
+    secp256k1_pubkey sd, sd2;
+    secp256k1_gej Qj;
+    secp256k1_ge Q;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        switch (secp256k1_rand_int(4)) {
+        case 0:
+            if (i > 0) {
+                s[i] = s[secp256k1_rand_int(i)];
+                break;
+            }
+            /* Fall through. */
+        case 1:
+            if (i > 0) {
+                secp256k1_scalar_negate(&s[i], &s[secp256k1_rand_int(i)]);
+                break;
+            }
+            /* Fall through. */
+        default:
+            random_scalar_order_test(&s[i]);
+        }
+        secp256k1_scalar_add(&sum, &sum, &s[i]);
+        secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &Qj, &s[i]);
+        secp256k1_ge_set_gej(&Q, &Qj);
+        secp256k1_pubkey_save(&data[i], &Q);
+        d[i] = &data[i];
+    }
+    secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &Qj, &sum);
+    secp256k1_ge_set_gej(&Q, &Qj);
+    if (secp256k1_scalar_is_zero(&sum)) {
+        CHECK(secp256k1_ec_pubkey_combine(ctx, &sd2, d, n) == 0);
+    } else {
+        secp256k1_pubkey_save(&sd, &Q);
+        CHECK(secp256k1_ec_pubkey_combine(ctx, &sd2, d, n) == 1);
+        CHECK(memcmp(&sd, &sd2, sizeof(sd)) == 0);
+    }
+
+    /* Build the same sum from half of the keys by adding the others, then remove them again. */
+    agg = secp256k1_ec_pubkey_aggregate_create(ctx, d, n / 2);
+    CHECK(agg != NULL);
+    for (i = n / 2; i < n; i++) {
+        CHECK(secp256k1_ec_pubkey_aggregate_add(ctx, agg, d[i]) == 1);
+    }
+    if (secp256k1_scalar_is_zero(&sum)) {
+        CHECK(secp256k1_ec_pubkey_aggregate_get(ctx, &sd2, agg) == 0);
+    } else {
+        CHECK(secp256k1_ec_pubkey_aggregate_get(ctx, &sd2, agg) == 1);
+        CHECK(memcmp(&sd, &sd2, sizeof(sd)) == 0);
+    }
+    for (i = n / 2; i < n; i++) {
+        CHECK(secp256k1_ec_pubkey_aggregate_remove(ctx, agg, d[i]) == 1);
+    }
+    if (n / 2 > 0 && secp256k1_ec_pubkey_combine(ctx, &sd, d, n / 2)) {
+        CHECK(secp256k1_ec_pubkey_aggregate_get(ctx, &sd2, agg) == 1);
+        CHECK(memcmp(&sd, &sd2, sizeof(sd)) == 0);
+    } else {
+        CHECK(secp256k1_ec_pubkey_aggregate_get(ctx, &sd2, agg) == 0);
+    }
+    secp256k1_ec_pubkey_aggregate_destroy(agg);
+
+    free(s);
+    free(data);
+    free(d);
+}
+
 void run_ec_combine(void) {
     int i;
     for (i = 0; i < count * 8; i++) {
          test_ec_combine();
     }
+    for (i = 0; i < count; i++) {
+        test_ec_combine_many(1 + secp256k1_rand_int(64));
+    }
+    test_ec_combine_many(1000);
 }
 
 void test_group_decompress(const secp256k1_fe* x) {
@@ -2475,6 +2758,76 @@ void run_ecmult_const_tests(void) {
     ecmult_const_chain_multiply();
 }
 
+void test_ecmult_multi(size_t n) {
+    secp256k1_ge points[40];
+    secp256k1_scalar scalars[40];
+    secp256k1_scalar ng, zero;
+    secp256k1_gej expected, r, t;
+    size_t i;
+
+    CHECK(n >= 1 && n <= 40);
+    secp256k1_scalar_set_int(&zero, 0);
+    random_scalar_order(&ng);
+    secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &expected, &ng);
+    for (i = 0; i < n; i++) {
+        random_group_element_test(&points[i]);
+        if (i % 3 == 1) {
+            /* A scalar below 2^128, which is not split. */
+            unsigned char b32[32];
+            secp256k1_rand256(b32);
+            memset(b32, 0, 16);
+            secp256k1_scalar_set_b32(&scalars[i], b32, NULL);
+        } else if (i % 7 == 6) {
+            secp256k1_scalar_set_int(&scalars[i], 0);
+        } else {
+            random_scalar_order(&scalars[i]);
+        }
+        if (i % 5 == 4) {
+            /* Repeat or negate an earlier point. */
+            points[i] = points[i - 1];
+            if (i % 2) {
+                secp256k1_ge_neg(&points[i], &points[i]);
+            }
+        }
+        secp256k1_gej_set_ge(&t, &points[i]);
+        secp256k1_ecmult(&ctx->ecmult_ctx, &t, &t, &scalars[i], &zero);
+        secp256k1_gej_add_var(&expected, &expected, &t, NULL);
+    }
+    secp256k1_ecmult_multi_var(&ctx->ecmult_ctx, &r, points, scalars, n, &ng, &ctx->error_callback);
+    secp256k1_gej_neg(&expected, &expected);
+    secp256k1_gej_add_var(&r, &r, &expected, NULL);
+    CHECK(secp256k1_gej_is_infinity(&r));
+
+    /* A sum that cancels out. */
+    if (n >= 2) {
+        secp256k1_scalar_set_int(&ng, 0);
+        points[1] = points[0];
+        secp256k1_scalar_negate(&scalars[1], &scalars[0]);
+        secp256k1_ecmult_multi_var(&ctx->ecmult_ctx, &r, points, scalars, 2, &ng, &ctx->error_callback);
+        CHECK(secp256k1_gej_is_infinity(&r));
+    }
+}
+
+void run_ecmult_multi_tests(void) {
+    secp256k1_scalar ng, zero;
+    secp256k1_gej r, expected;
+    int i;
+
+    /* Without points, only the G term remains. */
+    secp256k1_scalar_set_int(&zero, 0);
+    random_scalar_order(&ng);
+    secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &expected, &ng);
+    secp256k1_ecmult_multi_var(&ctx->ecmult_ctx, &r, NULL, NULL, 0, &ng, &ctx->error_callback);
+    secp256k1_gej_neg(&expected, &expected);
+    secp256k1_gej_add_var(&r, &r, &expected, NULL);
+    CHECK(secp256k1_gej_is_infinity(&r));
+
+    test_ecmult_multi(1);
+    for (i = 0; i < count; i++) {
+        test_ecmult_multi(2 + secp256k1_rand_int(39));
+    }
+}
+
 void test_wnaf(const secp256k1_scalar *number, int w) {
     secp256k1_scalar x, two, t;
     int wnaf[256];
@@ -3332,6 +3685,30 @@ void run_eckey_edge_case_test(void) {
     VG_CHECK(&pubkey, sizeof(secp256k1_pubkey));
     CHECK(memcmp(&pubkey, zeros, sizeof(secp256k1_pubkey)) > 0);
     CHECK(ecount == 3);
+    /* secp256k1_ec_pubkey_aggregate tests. */
+    {
+        secp256k1_ec_pubkey_aggregate *agg;
+        CHECK(secp256k1_ec_pubkey_aggregate_create(ctx, NULL, 1) == NULL);
+        CHECK(ecount == 4);
+        agg = secp256k1_ec_pubkey_aggregate_create(ctx, NULL, 0);
+        CHECK(agg != NULL);
+        CHECK(secp256k1_ec_pubkey_aggregate_get(ctx, &pubkey, agg) == 0);
+        CHECK(memcmp(&pubkey, zeros, sizeof(secp256k1_pubkey)) == 0);
+        CHECK(secp256k1_ec_pubkey_aggregate_remove(ctx, agg, &pubkey_one) == 0);
+        CHECK(ecount == 4);
+        CHECK(secp256k1_ec_pubkey_aggregate_add(ctx, agg, NULL) == 0);
+        CHECK(ecount == 5);
+        CHECK(secp256k1_ec_pubkey_aggregate_add(ctx, agg, &pubkey_one) == 1);
+        CHECK(secp256k1_ec_pubkey_aggregate_add(ctx, agg, &pubkey_negone) == 1);
+        CHECK(secp256k1_ec_pubkey_aggregate_get(ctx, &pubkey, agg) == 0);
+        CHECK(secp256k1_ec_pubkey_aggregate_remove(ctx, agg, &pubkey_negone) == 1);
+        CHECK(secp256k1_ec_pubkey_aggregate_get(ctx, &pubkey, agg) == 1);
+        CHECK(memcmp(&pubkey, &pubkey_one, sizeof(secp256k1_pubkey)) == 0);
+        CHECK(secp256k1_ec_pubkey_aggregate_get(ctx, NULL, agg) == 0);
+        CHECK(ecount == 6);
+        secp256k1_ec_pubkey_aggregate_destroy(agg);
+        secp256k1_ec_pubkey_aggregate_destroy(NULL);
+    }
     secp256k1_context_set_illegal_callback(ctx, NULL, NULL);
 }
 
@@ -4379,6 +4756,48 @@ void run_ecdsa_openssl(void) {
 }
 #endif
 
+#ifdef SECP256K1_OPCOUNT
+void run_opcount_tests(void) {
+    secp256k1_opcount counts;
+    secp256k1_fe a, b;
+    secp256k1_scalar msg, key;
+    secp256k1_gej pj;
+    secp256k1_ge p;
+    secp256k1_pubkey pubkey;
+    secp256k1_ecdsa_signature sig;
+    unsigned char msg32[32], key32[32];
+
+    random_fe(&a);
+    secp256k1_opcount_reset();
+    secp256k1_fe_mul(&b, &a, &a);
+    secp256k1_fe_sqr(&b, &b);
+    secp256k1_opcount_snapshot(&counts);
+    CHECK(counts.fe_mul == 1 && counts.fe_sqr == 1 && counts.fe_inv == 0);
+    secp256k1_opcount_reset();
+    secp256k1_opcount_snapshot(&counts);
+    CHECK(counts.fe_mul == 0 && counts.fe_sqr == 0);
+
+    /* An inversion by exponentiation includes its multiplications and squarings. */
+    secp256k1_fe_inv(&b, &a);
+    secp256k1_opcount_snapshot(&counts);
+    CHECK(counts.fe_inv == 1 && counts.fe_mul > 0 && counts.fe_sqr > 200);
+
+    random_scalar_order_test(&msg);
+    random_scalar_order_test(&key);
+    secp256k1_scalar_get_b32(msg32, &msg);
+    secp256k1_scalar_get_b32(key32, &key);
+    secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &pj, &key);
+    secp256k1_ge_set_gej(&p, &pj);
+    secp256k1_pubkey_save(&pubkey, &p);
+    CHECK(secp256k1_ecdsa_sign(ctx, &sig, msg32, key32, NULL, NULL) == 1);
+    secp256k1_opcount_reset();
+    CHECK(secp256k1_ecdsa_verify(ctx, &sig, msg32, &pubkey) == 1);
+    secp256k1_opcount_snapshot(&counts);
+    CHECK(counts.ecmult == 1 && counts.ecmult_gen == 0 && counts.scalar_inverse_var == 1);
+    CHECK(counts.gej_double_var > 0 && counts.gej_add_ge_var > 0);
+}
+#endif
+
 #ifdef ENABLE_MODULE_ECDH
 # include "modules/ecdh/tests_impl.h"
 #endif
@@ -4445,7 +4864,12 @@ int main(int argc, char **argv) {
     run_rand_int();
 
     run_sha256_tests();
+#ifdef USE_SHA256_ARMV8
+    run_sha256_armv8_tests();
+#endif
     run_hmac_sha256_tests();
+    run_sha512_tests();
+    run_hmac_sha512_tests();
     run_rfc6979_hmac_sha256_tests();
 
 #ifndef USE_NUM_NONE
@@ -4463,7 +4887,9 @@ int main(int argc, char **argv) {
     run_field_misc();
     run_field_convert();
     run_sqr();
+    run_field_mul_sqr();
     run_sqrt();
+    run_fe_jacobi();
 
     /* group tests */
     run_ge();
@@ -4476,6 +4902,7 @@ int main(int argc, char **argv) {
     run_ecmult_constants();
     run_ecmult_gen_blind();
     run_ecmult_const_tests();
+    run_ecmult_multi_tests();
     run_ec_combine();
 
     /* endomorphism tests */
@@ -4514,6 +4941,10 @@ int main(int argc, char **argv) {
     run_recovery_tests();
 #endif
 
+#ifdef SECP256K1_OPCOUNT
+    run_opcount_tests();
+#endif
+
     secp256k1_rand256(run32);
     printf("random run = %02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x\n", run32[0], run32[1], run32[2], run32[3], run32[4], run32[5], run32[6], run32[7], run32[8], run32[9], run32[10], run32[11], run32[12], run32[13], run32[14], run32[15]);
 
@@ -108,6 +108,36 @@ static SECP256K1_INLINE void *checked_malloc(const secp256k1_callback* cb, size_
 #  define SECP256K1_GNUC_EXT
 # endif
 SECP256K1_GNUC_EXT typedef unsigned __int128 uint128_t;
+SECP256K1_GNUC_EXT typedef __int128 int128_t;
 #endif
 
+/* Count the trailing zero bits of a nonzero value, without constant-time guarantee. */
+static SECP256K1_INLINE int secp256k1_ctz32_var(uint32_t x) {
+#if SECP256K1_GNUC_PREREQ(3,4)
+    return __builtin_ctz(x);
+#else
+    int r = 0;
+    VERIFY_CHECK(x != 0);
+    while (!(x & 1)) {
+        x >>= 1;
+        r++;
+    }
+    return r;
+#endif
+}
+
+static SECP256K1_INLINE int secp256k1_ctz64_var(uint64_t x) {
+#if SECP256K1_GNUC_PREREQ(3,4)
+    return __builtin_ctzll(x);
+#else
+    int r = 0;
+    VERIFY_CHECK(x != 0);
+    while (!(x & 1)) {
+        x >>= 1;
+        r++;
+    }
+    return r;
+#endif
+}
+
 #endif
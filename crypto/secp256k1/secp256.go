@@ -8,6 +8,7 @@ package secp256k1
 /*
 #cgo CFLAGS: -I./libsecp256k1
 #cgo CFLAGS: -I./libsecp256k1/src/
+#cgo linux,arm64 CFLAGS: -DUSE_EXTERNAL_ASM -DUSE_ASM_AARCH64 -DHAVE_SYS_AUXV_H -DHAVE_GETAUXVAL
 
 #ifdef __SIZEOF_INT128__
 #  define HAVE___INT128
@@ -25,6 +26,7 @@ package secp256k1
 #define NDEBUG
 #include "./libsecp256k1/src/secp256k1.c"
 #include "./libsecp256k1/src/modules/recovery/main_impl.h"
+#include "./libsecp256k1/src/modules/ecdh/main_impl.h"
 #include "ext.h"
 
 typedef void (*callbackFunc) (const char* msg, void* data);
@@ -34,18 +36,103 @@ extern void secp256k1GoPanicError(const char* msg, void* data);
 import "C"
 
 import (
+	"crypto/rand"
+	"encoding/binary"
 	"errors"
 	"math/big"
+	"sync"
+	"sync/atomic"
 	"unsafe"
+
+	"github.com/ethereum/go-ethereum/metrics"
+	"golang.org/x/crypto/sha3"
 )
 
 var context *C.secp256k1_context
 
+// defaultReblindInterval is the number of signatures after which Sign renews its
+// blinding values, unless changed with SetReblindInterval.
+const defaultReblindInterval = 1 << 16
+
+// blinding holds the side-channel blinding values Sign uses with context.
+var blinding *C.secp256k1_ext_blinding
+
 func init() {
 	// around 20 ms on a modern CPU.
 	context = C.secp256k1_context_create_sign_verify()
 	C.secp256k1_context_set_illegal_callback(context, C.callbackFunc(C.secp256k1GoPanicIllegal), nil)
 	C.secp256k1_context_set_error_callback(context, C.callbackFunc(C.secp256k1GoPanicError), nil)
+
+	var seed [32]byte
+	if _, err := rand.Read(seed[:]); err != nil {
+		panic("secp256k1: can't seed blinding: " + err.Error())
+	}
+	blinding = C.secp256k1_ext_blinding_create(context, (*C.uchar)(unsafe.Pointer(&seed[0])))
+	if blinding == nil {
+		panic("secp256k1: can't allocate blinding state")
+	}
+	C.secp256k1_ext_blinding_set_interval(blinding, defaultReblindInterval)
+
+	if metrics.Enabled {
+		EnableLatencyMetrics(true)
+		registerMetrics(metrics.DefaultRegistry)
+	}
+}
+
+// latencyOps names the operations timed by the native layer, indexed by their
+// SECP256K1_EXT_OP_* id.
+var latencyOps = [C.SECP256K1_EXT_OP_COUNT]string{
+	C.SECP256K1_EXT_OP_RECOVER:       "recover",
+	C.SECP256K1_EXT_OP_RECOVER_CHECK: "recovercheck",
+	C.SECP256K1_EXT_OP_VERIFY:        "verify",
+	C.SECP256K1_EXT_OP_SIGN:          "sign",
+	C.SECP256K1_EXT_OP_REENCODE:      "reencode",
+	C.SECP256K1_EXT_OP_SCALAR_MUL:    "scalarmul",
+}
+
+// EnableLatencyMetrics switches the recording of native call latencies on or off.
+// Recording is switched on automatically when metrics collection is enabled.
+func EnableLatencyMetrics(enabled bool) {
+	var flag C.int
+	if enabled {
+		flag = 1
+	}
+	C.secp256k1_ext_latency_enable(flag)
+}
+
+// registerMetrics adds the latency histograms of all native operations, in
+// nanoseconds, and the recover cache counters to the registry.
+func registerMetrics(r metrics.Registry) {
+	for op, name := range latencyOps {
+		r.Register("secp256k1/"+name+"/latency", latencyHistogram{op})
+	}
+	metrics.NewRegisteredFunctionalGauge("secp256k1/recovercache/hits", r, func() int64 {
+		hits, _, _ := RecoverCacheStats()
+		return int64(hits)
+	})
+	metrics.NewRegisteredFunctionalGauge("secp256k1/recovercache/misses", r, func() int64 {
+		_, misses, _ := RecoverCacheStats()
+		return int64(misses)
+	})
+	metrics.NewRegisteredFunctionalGauge("secp256k1/recovercache/evictions", r, func() int64 {
+		_, _, evictions := RecoverCacheStats()
+		return int64(evictions)
+	})
+	metrics.NewRegisteredFunctionalGauge("secp256k1/blinding/refreshes", r, func() int64 {
+		_, refreshes := ReblindStats()
+		return int64(refreshes)
+	})
+}
+
+// readLatency returns a copy of the latency histogram of a native operation.
+func readLatency(op int) *latencySnapshot {
+	var (
+		s   = new(latencySnapshot)
+		sum C.uint64_t
+	)
+	C.secp256k1_ext_latency_snapshot(C.int(op), (*C.uint64_t)(unsafe.Pointer(&s.buckets[0])), &sum)
+	s.sum = uint64(sum)
+	return s
 }
 
 var (
@@ -56,8 +143,108 @@ var (
 	ErrInvalidPubkey       = errors.New("invalid public key")
 	ErrSignFailed          = errors.New("signing failed")
 	ErrRecoverFailed       = errors.New("recovery failed")
+	ErrRecoverCacheSize    = errors.New("invalid recover cache size")
+	ErrRecoverCacheEnabled = errors.New("recover cache already enabled")
+	ErrReblindBusy         = errors.New("blinding renewal already in progress")
+	ErrDeriveFailed        = errors.New("child key derivation failed")
+	ErrScalarMultFailed    = errors.New("invalid point or scalar")
+)
+
+// recoverCache is the optional cache consulted by RecoverPubkey. Recoveries load it
+// without locking, so a cache is never released once it has been published: disabling
+// moves it to retiredCaches, from where enabling it again with the same size reuses it.
+var (
+	recoverCache     atomic.Pointer[C.secp256k1_ext_sigcache]
+	recoverCacheLock sync.Mutex // serializes EnableRecoverCache and DisableRecoverCache
+	recoverCacheSize int
+	retiredCaches    = make(map[int]*C.secp256k1_ext_sigcache)
 )
 
+// EnableRecoverCache makes RecoverPubkey remember up to roughly entries recovered
+// public keys, so that recovering the same signature again skips the elliptic
+// curve operations. It fails if the cache is already enabled.
+func EnableRecoverCache(entries int) error {
+	if entries <= 0 {
+		return ErrRecoverCacheSize
+	}
+	recoverCacheLock.Lock()
+	defer recoverCacheLock.Unlock()
+
+	if recoverCache.Load() != nil {
+		return ErrRecoverCacheEnabled
+	}
+	cache := retiredCaches[entries]
+	if cache == nil {
+		var salt [32]byte
+		if _, err := rand.Read(salt[:]); err != nil {
+			return err
+		}
+		cache = C.secp256k1_ext_sigcache_create(C.size_t(entries), (*C.uchar)(unsafe.Pointer(&salt[0])))
+		if cache == nil {
+			return ErrRecoverCacheSize
+		}
+	}
+	delete(retiredCaches, entries)
+	recoverCacheSize = entries
+	recoverCache.Store(cache)
+	return nil
+}
+
+// DisableRecoverCache stops RecoverPubkey from using the recover cache. Recoveries
+// that already loaded the cache may still finish using it, so its memory is kept for
+// a later EnableRecoverCache with the same size instead of being released.
+func DisableRecoverCache() {
+	recoverCacheLock.Lock()
+	defer recoverCacheLock.Unlock()
+
+	if cache := recoverCache.Swap(nil); cache != nil {
+		retiredCaches[recoverCacheSize] = cache
+	}
+}
+
+// RecoverCacheStats returns the number of cache hits, misses and evictions of the
+// recover cache. All counters are zero if the cache is not enabled. A reused cache
+// continues counting from where it was disabled.
+func RecoverCacheStats() (hits, misses, evictions uint64) {
+	cache := recoverCache.Load()
+	if cache == nil {
+		return 0, 0, 0
+	}
+	var h, m, e C.uint64_t
+	C.secp256k1_ext_sigcache_stats(cache, &h, &m, &e)
+	return uint64(h), uint64(m), uint64(e)
+}
+
+// SetReblindInterval makes Sign renew its side-channel blinding values after every n
+// signatures, zero disables it. Renewing takes about as long as a signature and runs on
+// the signing goroutine that hits the interval. Other goroutines keep signing meanwhile.
+func SetReblindInterval(n uint64) {
+	C.secp256k1_ext_blinding_set_interval(blinding, C.uint64_t(n))
+}
+
+// Reblind renews the side-channel blinding values of Sign right away, mixing in fresh
+// entropy. Concurrent signatures use the old values until the new ones are in place.
+// It returns ErrReblindBusy without waiting if another renewal, such as a periodic
+// one started by Sign, is running at the same time.
+func Reblind() error {
+	var seed [32]byte
+	if _, err := rand.Read(seed[:]); err != nil {
+		return err
+	}
+	if C.secp256k1_ext_blinding_refresh(context, blinding, (*C.uchar)(unsafe.Pointer(&seed[0]))) == 0 {
+		return ErrReblindBusy
+	}
+	return nil
+}
+
+// ReblindStats returns the number of signatures made by Sign and the number of
+// times its blinding values were renewed.
+func ReblindStats() (signs, refreshes uint64) {
+	var sg, rf C.uint64_t
+	C.secp256k1_ext_blinding_stats(blinding, &sg, &rf)
+	return uint64(sg), uint64(rf)
+}
+
 // Sign creates a recoverable ECDSA signature.
 // The produced signature is in the 65-byte [R || S || V] format where V is 0 or 1.
 //
@@ -77,21 +264,13 @@ func Sign(msg []byte, seckey []byte) ([]byte, error) {
 	}
 
 	var (
-		msgdata   = (*C.uchar)(unsafe.Pointer(&msg[0]))
-		noncefunc = C.secp256k1_nonce_function_rfc6979
-		sigstruct C.secp256k1_ecdsa_recoverable_signature
-	)
-	if C.secp256k1_ecdsa_sign_recoverable(context, &sigstruct, msgdata, seckeydata, noncefunc, nil) == 0 {
-		return nil, ErrSignFailed
-	}
-
-	var (
+		msgdata = (*C.uchar)(unsafe.Pointer(&msg[0]))
 		sig     = make([]byte, 65)
 		sigdata = (*C.uchar)(unsafe.Pointer(&sig[0]))
-		recid   C.int
 	)
-	C.secp256k1_ecdsa_recoverable_signature_serialize_compact(context, sigdata, &recid, &sigstruct)
-	sig[64] = byte(recid) // add back recid to get 65 bytes sig
+	if C.secp256k1_ext_ecdsa_sign(context, blinding, sigdata, msgdata, seckeydata) == 0 {
+		return nil, ErrSignFailed
+	}
 	return sig, nil
 }
 
@@ -112,12 +291,25 @@ func RecoverPubkey(msg []byte, sig []byte) ([]byte, error) {
 		sigdata = (*C.uchar)(unsafe.Pointer(&sig[0]))
 		msgdata = (*C.uchar)(unsafe.Pointer(&msg[0]))
 	)
-	if C.secp256k1_ext_ecdsa_recover(context, (*C.uchar)(unsafe.Pointer(&pubkey[0])), sigdata, msgdata) == 0 {
+	if C.secp256k1_ext_ecdsa_recover_cached(context, recoverCache.Load(), (*C.uchar)(unsafe.Pointer(&pubkey[0])), sigdata, msgdata) == 0 {
 		return nil, ErrRecoverFailed
 	}
 	return pubkey, nil
 }
 
+// RecoverCheck reports whether recovering the public key from sig yields pubkey,
+// which must be in the 65-byte uncompressed format. It is faster than calling
+// RecoverPubkey and comparing the result.
+func RecoverCheck(msg []byte, sig []byte, pubkey []byte) bool {
+	if len(msg) != 32 || checkSignature(sig) != nil || len(pubkey) != 65 || pubkey[0] != 0x04 {
+		return false
+	}
+	sigdata := (*C.uchar)(unsafe.Pointer(&sig[0]))
+	msgdata := (*C.uchar)(unsafe.Pointer(&msg[0]))
+	keydata := (*C.uchar)(unsafe.Pointer(&pubkey[1]))
+	return C.secp256k1_ext_ecdsa_recover_check(context, sigdata, msgdata, keydata) != 0
+}
+
 // VerifySignature checks that the given pubkey created signature over message.
 // The signature should be in [R || S] format.
 func VerifySignature(pubkey, msg, signature []byte) bool {
@@ -165,6 +357,173 @@ func CompressPubkey(x, y *big.Int) []byte {
 	return out
 }
 
+// BulkKeys derives n private keys start, start+stride, start+2*stride, ... and returns
+// them together with their public keys and addresses: key i is seckeys[32*i:32*i+32],
+// its public key X || Y is pubkeys[64*i:64*i+64], and its address is
+// addrs[20*i:20*i+20].
+//
+// The keys are NOT FOR PRODUCTION USE. Anyone who learns one of them and the stride
+// learns all of them, and they are derived with variable-time code. BulkKeys is meant
+// for creating large numbers of test accounts quickly.
+func BulkKeys(start []byte, stride uint64, n int) (seckeys, pubkeys, addrs []byte, err error) {
+	if len(start) != 32 || stride == 0 || n < 0 {
+		return nil, nil, nil, ErrInvalidKey
+	}
+	if n == 0 {
+		return nil, nil, nil, nil
+	}
+	var step [32]byte
+	binary.BigEndian.PutUint64(step[24:], stride)
+
+	seckeys = make([]byte, 32*n)
+	pubkeys = make([]byte, 64*n)
+	var (
+		seckeydata = (*C.uchar)(unsafe.Pointer(&seckeys[0]))
+		pubkeydata = (*C.uchar)(unsafe.Pointer(&pubkeys[0]))
+		startdata  = (*C.uchar)(unsafe.Pointer(&start[0]))
+		stepdata   = (*C.uchar)(unsafe.Pointer(&step[0]))
+	)
+	if C.secp256k1_ext_bulk_keygen(context, seckeydata, pubkeydata, startdata, stepdata, C.size_t(n)) == 0 {
+		return nil, nil, nil, ErrInvalidKey
+	}
+	addrs = make([]byte, 20*n)
+	var (
+		hasher = sha3.NewLegacyKeccak256()
+		hash   = make([]byte, 0, 32)
+	)
+	for i := 0; i < n; i++ {
+		hasher.Reset()
+		hasher.Write(pubkeys[64*i : 64*i+64])
+		copy(addrs[20*i:], hasher.Sum(hash[:0])[12:])
+	}
+	return seckeys, pubkeys, addrs, nil
+}
+
+// DeriveChildren derives the BIP32 children first, first+1, ..., first+count-1 of the
+// extended key made of parent and chainCode. parent is either a 32-byte private key or
+// a 33- or 65-byte public key, and indices of 2^31 and above (hardened children) need a
+// private parent. Child i has the private key seckeys[32*i:32*i+32] (nil for a public
+// parent), the uncompressed public key pubkeys[65*i:65*i+65] and the chain code
+// chainCodes[32*i:32*i+32].
+//
+// valid[i] is false if child i is invalid, which is astronomically unlikely. Its keys
+// and chain code are then zero, and callers have to skip the index as BIP32 prescribes.
+func DeriveChildren(parent, chainCode []byte, first uint32, count int) (seckeys, pubkeys, chainCodes []byte, valid []bool, err error) {
+	if len(parent) != 32 && len(parent) != 33 && len(parent) != 65 {
+		return nil, nil, nil, nil, ErrInvalidKey
+	}
+	if len(chainCode) != 32 || count < 0 {
+		return nil, nil, nil, nil, ErrDeriveFailed
+	}
+	if count == 0 {
+		return nil, nil, nil, nil, nil
+	}
+	pubkeys = make([]byte, 65*count)
+	chainCodes = make([]byte, 32*count)
+	status := make([]byte, count)
+	var seckeydata *C.uchar
+	if len(parent) == 32 {
+		seckeys = make([]byte, 32*count)
+		seckeydata = (*C.uchar)(unsafe.Pointer(&seckeys[0]))
+	}
+	var (
+		pubkeydata    = (*C.uchar)(unsafe.Pointer(&pubkeys[0]))
+		chaincodedata = (*C.uchar)(unsafe.Pointer(&chainCodes[0]))
+		statusdata    = (*C.uchar)(unsafe.Pointer(&status[0]))
+		parentdata    = (*C.uchar)(unsafe.Pointer(&parent[0]))
+		parentcc      = (*C.uchar)(unsafe.Pointer(&chainCode[0]))
+	)
+	if C.secp256k1_ext_bip32_derive(context, seckeydata, pubkeydata, chaincodedata, statusdata, parentdata, C.size_t(len(parent)), parentcc, C.uint32_t(first), C.size_t(count)) == 0 {
+		return nil, nil, nil, nil, ErrDeriveFailed
+	}
+	valid = make([]bool, count)
+	for i, ok := range status {
+		valid[i] = ok != 0
+	}
+	return seckeys, pubkeys, chainCodes, valid, nil
+}
+
+// ScalarMultBatch multiplies the points points[64*i:64*i+64], each encoded as two
+// 32-byte big-endian coordinates, with the 32-byte scalars scalars[32*i:32*i+32] in
+// constant time. The products have the same encoding, so the first 32 bytes of each are
+// the raw ECDH secret that BitCurve.ScalarMult gives. Computing them together is faster
+// than one by one.
+//
+// ErrScalarMultFailed is returned along with the products if a point is not on the
+// curve or a scalar is zero or not below the group order. Those products are zero.
+func ScalarMultBatch(points, scalars []byte) ([]byte, error) {
+	n := len(scalars) / 32
+	if len(scalars) != 32*n || len(points) != 64*n {
+		return nil, ErrScalarMultFailed
+	}
+	if n == 0 {
+		return nil, nil
+	}
+	products := make([]byte, len(points))
+	copy(products, points)
+	var (
+		productdata = (*C.uchar)(unsafe.Pointer(&products[0]))
+		scalardata  = (*C.uchar)(unsafe.Pointer(&scalars[0]))
+	)
+	if C.secp256k1_ext_scalar_mul_batch(context, productdata, scalardata, C.size_t(n)) == 0 {
+		return products, ErrScalarMultFailed
+	}
+	return products, nil
+}
+
+// PointTable holds a precomputed multiplication table for one public key, which makes
+// multiplying that key by scalars several times faster than BitCurve.ScalarMult. It
+// takes 64 KiB and about as long to build as a few dozen multiplications. It is safe
+// for concurrent use, and must be released with Close.
+type PointTable struct {
+	table *C.secp256k1_ecdh_table
+}
+
+// NewPointTable builds the table for a 33- or 65-byte public key. The table is blinded
+// against side channels with fresh randomness.
+func NewPointTable(pubkey []byte) (*PointTable, error) {
+	if len(pubkey) != 33 && len(pubkey) != 65 {
+		return nil, ErrInvalidPubkey
+	}
+	var seed [32]byte
+	if _, err := rand.Read(seed[:]); err != nil {
+		return nil, err
+	}
+	var (
+		pubkeydata = (*C.uchar)(unsafe.Pointer(&pubkey[0]))
+		seeddata   = (*C.uchar)(unsafe.Pointer(&seed[0]))
+	)
+	table := C.secp256k1_ext_table_create(context, pubkeydata, C.size_t(len(pubkey)), seeddata)
+	if table == nil {
+		return nil, ErrInvalidPubkey
+	}
+	return &PointTable{table: table}, nil
+}
+
+// ScalarMult multiplies the public key of the table by a 32-byte scalar in constant
+// time. The product is encoded as two 32-byte big-endian coordinates, so its first 32
+// bytes are the raw ECDH secret that BitCurve.ScalarMult gives.
+func (t *PointTable) ScalarMult(scalar []byte) ([]byte, error) {
+	if len(scalar) != 32 {
+		return nil, ErrInvalidKey
+	}
+	product := make([]byte, 64)
+	var (
+		productdata = (*C.uchar)(unsafe.Pointer(&product[0]))
+		scalardata  = (*C.uchar)(unsafe.Pointer(&scalar[0]))
+	)
+	if C.secp256k1_ext_table_scalar_mul(context, productdata, t.table, scalardata) == 0 {
+		return nil, ErrInvalidKey
+	}
+	return product, nil
+}
+
+// Close releases the table. It must not be used afterwards.
+func (t *PointTable) Close() {
+	C.secp256k1_ecdh_table_destroy(t.table)
+	t.table = nil
+}
+
 func checkSignature(sig []byte) error {
 	if len(sig) != 65 {
 		return ErrInvalidSignatureLen
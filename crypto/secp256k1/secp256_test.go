@@ -10,8 +10,13 @@ import (
 	"crypto/elliptic"
 	"crypto/rand"
 	"encoding/hex"
+	"fmt"
 	"io"
+	"math/big"
+	"sync"
 	"testing"
+
+	"github.com/ethereum/go-ethereum/metrics"
 )
 
 const TestCount = 1000
@@ -216,6 +221,465 @@ func TestRecoverSanity(t *testing.T) {
 	}
 }
 
+func TestRecoverCheck(t *testing.T) {
+	pubkey, seckey := generateKeyPair()
+	other, _ := generateKeyPair()
+	for i := 0; i < 100; i++ {
+		msg := csprngEntropy(32)
+		sig, _ := Sign(msg, seckey)
+		if !RecoverCheck(msg, sig, pubkey) {
+			t.Fatalf("iteration %d: check failed for the signer", i)
+		}
+		if RecoverCheck(msg, sig, other) {
+			t.Fatalf("iteration %d: check passed for another key", i)
+		}
+		sig[64] ^= 1
+		if RecoverCheck(msg, sig, pubkey) {
+			t.Fatalf("iteration %d: check passed for flipped recovery id", i)
+		}
+	}
+}
+
+func TestRecoverCache(t *testing.T) {
+	if err := EnableRecoverCache(1024); err != nil {
+		t.Fatalf("enable error: %s", err)
+	}
+	// The remaining tests and benchmarks recover uncached.
+	defer DisableRecoverCache()
+
+	if err := EnableRecoverCache(1024); err != ErrRecoverCacheEnabled {
+		t.Fatalf("got %q, want %q", err, ErrRecoverCacheEnabled)
+	}
+	pubkey1, seckey := generateKeyPair()
+	msg := csprngEntropy(32)
+	sig, _ := Sign(msg, seckey)
+
+	hits, misses, _ := RecoverCacheStats()
+	for i := 0; i < 2; i++ {
+		pubkey2, err := RecoverPubkey(msg, sig)
+		if err != nil {
+			t.Fatalf("recover error: %s", err)
+		}
+		if !bytes.Equal(pubkey1, pubkey2) {
+			t.Fatalf("pubkey mismatch: want: %x have: %x", pubkey1, pubkey2)
+		}
+	}
+	hits2, misses2, _ := RecoverCacheStats()
+	if hits2-hits != 1 || misses2-misses != 1 {
+		t.Fatalf("stats mismatch: have %d hits, %d misses, want 1 and 1", hits2-hits, misses2-misses)
+	}
+
+	// Hammer the cache from several goroutines with more keys than it holds.
+	var wg sync.WaitGroup
+	for g := 0; g < 8; g++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for i := 0; i < 200; i++ {
+				pubkey1, seckey := generateKeyPair()
+				msg := csprngEntropy(32)
+				sig, _ := Sign(msg, seckey)
+				for j := 0; j < 2; j++ {
+					pubkey2, err := RecoverPubkey(msg, sig)
+					if err != nil || !bytes.Equal(pubkey1, pubkey2) {
+						t.Errorf("pubkey mismatch: want: %x have: %x (%v)", pubkey1, pubkey2, err)
+						return
+					}
+				}
+			}
+		}()
+	}
+	wg.Wait()
+	if _, _, evictions := RecoverCacheStats(); evictions == 0 {
+		t.Error("expected evictions")
+	}
+
+	DisableRecoverCache()
+	if hits, misses, evictions := RecoverCacheStats(); hits != 0 || misses != 0 || evictions != 0 {
+		t.Errorf("disabled cache has stats %d, %d, %d", hits, misses, evictions)
+	}
+	if pubkey2, err := RecoverPubkey(msg, sig); err != nil || !bytes.Equal(pubkey1, pubkey2) {
+		t.Fatalf("uncached pubkey mismatch: want: %x have: %x (%v)", pubkey1, pubkey2, err)
+	}
+	if err := EnableRecoverCache(1024); err != nil {
+		t.Fatalf("re-enable error: %s", err)
+	}
+	if hits, _, _ := RecoverCacheStats(); hits == 0 {
+		t.Error("re-enabled cache was not reused")
+	}
+}
+
+func TestLatencyMetrics(t *testing.T) {
+	EnableLatencyMetrics(true)
+	defer EnableLatencyMetrics(false)
+
+	var before [len(latencyOps)]int64
+	for op := range latencyOps {
+		before[op] = latencyHistogram{op}.Count()
+	}
+	pubkey, seckey := generateKeyPair()
+	msg := csprngEntropy(32)
+	sig, _ := Sign(msg, seckey)
+	RecoverPubkey(msg, sig)
+	RecoverCheck(msg, sig, pubkey)
+	VerifySignature(pubkey, msg, sig[:64])
+	DecompressPubkey(CompressPubkey(S256().Unmarshal(pubkey)))
+	S256().ScalarMult(S256().Gx, S256().Gy, seckey)
+
+	r := metrics.NewRegistry()
+	registerMetrics(r)
+	for op, name := range latencyOps {
+		h, ok := r.Get("secp256k1/" + name + "/latency").(metrics.Histogram)
+		if !ok {
+			t.Fatalf("%s: histogram not registered", name)
+		}
+		s := h.Snapshot()
+		if n := s.Count() - before[op]; n < 1 {
+			t.Errorf("%s: %d new samples, want at least 1", name, n)
+		}
+		if mean := s.Mean(); float64(s.Min()) > mean || mean > float64(s.Max()) {
+			t.Errorf("%s: mean %f outside [%d, %d]", name, mean, s.Min(), s.Max())
+		}
+		if p := s.Percentiles([]float64{0, 0.5, 1}); p[0] > p[1] || p[1] > p[2] {
+			t.Errorf("%s: percentiles not monotonic: %v", name, p)
+		}
+	}
+	if r.Get("secp256k1/recovercache/hits") == nil {
+		t.Error("recover cache gauges not registered")
+	}
+
+	// With recording off, nothing may change.
+	EnableLatencyMetrics(false)
+	count := latencyHistogram{0}.Count()
+	RecoverPubkey(msg, sig)
+	if (latencyHistogram{0}).Count() != count {
+		t.Error("latency recorded while disabled")
+	}
+}
+
+func TestLatencyBuckets(t *testing.T) {
+	for b := 4; b < latencyBuckets; b++ {
+		lo, hi := latencyBucketMin(b), latencyBucketMin(b+1)
+		if hi <= lo || hi-lo > lo/4 {
+			t.Fatalf("bucket %d: bounds [%v, %v) too wide", b, lo, hi)
+		}
+	}
+}
+
+func TestBulkKeys(t *testing.T) {
+	start := make([]byte, 32)
+	start[31] = 1
+	seckeys, pubkeys, addrs, err := BulkKeys(start, 1, 3)
+	if err != nil {
+		t.Fatalf("bulk keys error: %s", err)
+	}
+	want := []string{
+		"7e5f4552091a69125d5dfcb7b8c2659029395bdf",
+		"2b5ad5c4795c026514f8317c7a215e218dccd6cf",
+		"6813eb9362372eef6200f3b1dbc3f819671cba69",
+	}
+	for i := range want {
+		if seckeys[32*i+31] != byte(i+1) {
+			t.Errorf("key %d: wrong private key %x", i, seckeys[32*i:32*i+32])
+		}
+		if have := hex.EncodeToString(addrs[20*i : 20*i+20]); have != want[i] {
+			t.Errorf("key %d: address mismatch: have %s, want %s", i, have, want[i])
+		}
+	}
+	_ = pubkeys
+
+	// Cross the block boundary with a random start and stride.
+	start = csprngEntropy(32)
+	stride := uint64(0x1234567)
+	seckeys, pubkeys, _, err = BulkKeys(start, stride, 600)
+	if err != nil {
+		t.Fatalf("bulk keys error: %s", err)
+	}
+	for _, i := range []int{0, 1, 255, 256, 257, 599} {
+		x, y := S256().ScalarBaseMult(seckeys[32*i : 32*i+32])
+		if !bytes.Equal(pubkeys[64*i:64*i+64], S256().Marshal(x, y)[1:]) {
+			t.Errorf("key %d: public key mismatch", i)
+		}
+	}
+
+	if _, _, _, err := BulkKeys(make([]byte, 32), 1, 1); err != ErrInvalidKey {
+		t.Errorf("zero start: have %v, want %v", err, ErrInvalidKey)
+	}
+}
+
+func BenchmarkBulkKeys(b *testing.B) {
+	start := csprngEntropy(32)
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i += 1024 {
+		BulkKeys(start, 1, 1024)
+	}
+}
+
+func TestDeriveChildren(t *testing.T) {
+	// BIP32 test vector 1.
+	var (
+		master, _   = hex.DecodeString("e8f32e723decf4051aefac8e2c93c9c5b214313817cdb01a1494b917c8436b35")
+		masterCC, _ = hex.DecodeString("873dff81c02f525623fd1fe5167eac3a55a049de3d314bb42ee227ffed37d508")
+	)
+	seckeys, pubkeys, chainCodes, valid, err := DeriveChildren(master, masterCC, 0x80000000, 2)
+	if err != nil {
+		t.Fatalf("derive error: %s", err)
+	}
+	for i, ok := range valid {
+		if !ok {
+			t.Fatalf("child %d reported invalid", i)
+		}
+	}
+	if have := hex.EncodeToString(seckeys[:32]); have != "edb2e14f9ee77d26dd93b4ecede8d16ed408ce149b6cd80b0715a2d911a0afea" {
+		t.Errorf("m/0H: private key mismatch: %s", have)
+	}
+	if have := hex.EncodeToString(chainCodes[:32]); have != "47fdacbd0f1097043b78c63c20c34ef4ed9a111d980047ad16282c7ae6236141" {
+		t.Errorf("m/0H: chain code mismatch: %s", have)
+	}
+	if have := hex.EncodeToString(seckeys[32:]); have != "ee7c0cf08ab376d98150ec158906f7dcaff195b5cb3cce043a32b85d0c1616ca" {
+		t.Errorf("m/1H: private key mismatch: %s", have)
+	}
+	parent, parentPub, parentCC := seckeys[:32], pubkeys[:65], chainCodes[:32]
+
+	seckeys, pubkeys, chainCodes, valid, err = DeriveChildren(parent, parentCC, 1, 1)
+	if err != nil {
+		t.Fatalf("derive error: %s", err)
+	}
+	for i, ok := range valid {
+		if !ok {
+			t.Fatalf("child %d reported invalid", i)
+		}
+	}
+	if have := hex.EncodeToString(seckeys); have != "3c6cb8d0f6a264c91ea8b5030fadaa8e538b020f0a387421a12de9319dc93368" {
+		t.Errorf("m/0H/1: private key mismatch: %s", have)
+	}
+	if have := hex.EncodeToString(chainCodes); have != "2a7857631386ba23dacac34180dd1983734e444fdbf774041578e9b6adb37c19" {
+		t.Errorf("m/0H/1: chain code mismatch: %s", have)
+	}
+	if have := hex.EncodeToString(pubkeys); have != "04501e454bf00751f24b1b489aa925215d66af2234e3891c3b21a52bedb3cd711c008794c1df8131b9ad1e1359965b3f3ee2feef0866be693729772be14be881ab" {
+		t.Errorf("m/0H/1: public key mismatch: %s", have)
+	}
+
+	// Private and public derivation must agree, across several normalization blocks.
+	seckeys, pubkeys, chainCodes, valid, err = DeriveChildren(parent, parentCC, 0, 150)
+	if err != nil {
+		t.Fatalf("derive error: %s", err)
+	}
+	for i, ok := range valid {
+		if !ok {
+			t.Fatalf("child %d reported invalid", i)
+		}
+	}
+	for _, pub := range [][]byte{parentPub, CompressPubkey(S256().Unmarshal(parentPub))} {
+		seckeys2, pubkeys2, chainCodes2, valid2, err := DeriveChildren(pub, parentCC, 0, 150)
+		if err != nil {
+			t.Fatalf("public derive error: %s", err)
+		}
+		if seckeys2 != nil || len(valid2) != 150 || !bytes.Equal(pubkeys, pubkeys2) || !bytes.Equal(chainCodes, chainCodes2) {
+			t.Fatalf("public derivation from %d-byte key differs", len(pub))
+		}
+		for i, ok := range valid2 {
+			if !ok {
+				t.Fatalf("child %d of %d-byte key reported invalid", i, len(pub))
+			}
+		}
+	}
+	for _, i := range []int{0, 63, 64, 149} {
+		x, y := S256().ScalarBaseMult(seckeys[32*i : 32*i+32])
+		if !bytes.Equal(pubkeys[65*i:65*i+65], S256().Marshal(x, y)) {
+			t.Errorf("child %d: public key does not match private key", i)
+		}
+	}
+
+	if _, _, _, _, err := DeriveChildren(parentPub, parentCC, 0x80000000, 1); err != ErrDeriveFailed {
+		t.Errorf("hardened child of public key: have %v, want %v", err, ErrDeriveFailed)
+	}
+	if _, _, _, _, err := DeriveChildren(parent, parentCC, 0xffffffff, 2); err != ErrDeriveFailed {
+		t.Errorf("index overflow: have %v, want %v", err, ErrDeriveFailed)
+	}
+}
+
+func BenchmarkDeriveChildren(b *testing.B) {
+	pubkey, _ := generateKeyPair()
+	chainCode := csprngEntropy(32)
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i += 256 {
+		DeriveChildren(pubkey, chainCode, 0, 256)
+	}
+}
+
+func TestScalarMultBatch(t *testing.T) {
+	// More than one block of SECP256K1_ECDH_BATCH_SIZE.
+	const n = 40
+	points, scalars := make([]byte, 64*n), make([]byte, 32*n)
+	for i := 0; i < n; i++ {
+		pubkey, _ := generateKeyPair()
+		_, seckey := generateKeyPair()
+		copy(points[64*i:], pubkey[1:])
+		copy(scalars[32*i:], seckey)
+	}
+	products, err := ScalarMultBatch(points, scalars)
+	if err != nil {
+		t.Fatalf("batch error: %s", err)
+	}
+	for i := 0; i < n; i++ {
+		x, y := S256().ScalarMult(new(big.Int).SetBytes(points[64*i:64*i+32]), new(big.Int).SetBytes(points[64*i+32:64*i+64]), scalars[32*i:32*i+32])
+		if !bytes.Equal(products[64*i:64*i+64], S256().Marshal(x, y)[1:]) {
+			t.Fatalf("product %d differs from ScalarMult", i)
+		}
+	}
+
+	// An invalid point or scalar only zeroes its own product.
+	points[64*3] ^= 1
+	copy(scalars[32*5:32*6], make([]byte, 32))
+	bad, err := ScalarMultBatch(points, scalars)
+	if err != ErrScalarMultFailed {
+		t.Fatalf("invalid inputs: have %v, want %v", err, ErrScalarMultFailed)
+	}
+	for i := 0; i < n; i++ {
+		want := products[64*i : 64*i+64]
+		if i == 3 || i == 5 {
+			want = make([]byte, 64)
+		}
+		if !bytes.Equal(bad[64*i:64*i+64], want) {
+			t.Errorf("product %d: have %x, want %x", i, bad[64*i:64*i+64], want)
+		}
+	}
+}
+
+func BenchmarkScalarMultBatch(b *testing.B) {
+	const n = 32
+	points, scalars := make([]byte, 64*n), make([]byte, 32*n)
+	for i := 0; i < n; i++ {
+		pubkey, seckey := generateKeyPair()
+		copy(points[64*i:], pubkey[1:])
+		copy(scalars[32*i:], seckey)
+	}
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i += n {
+		ScalarMultBatch(points, scalars)
+	}
+}
+
+func TestPointTable(t *testing.T) {
+	pubkey, _ := generateKeyPair()
+	table, err := NewPointTable(pubkey)
+	if err != nil {
+		t.Fatalf("table error: %s", err)
+	}
+	defer table.Close()
+	x, y := S256().Unmarshal(pubkey)
+	for i := 0; i < 16; i++ {
+		_, scalar := generateKeyPair()
+		product, err := table.ScalarMult(scalar)
+		if err != nil {
+			t.Fatalf("multiplication error: %s", err)
+		}
+		if px, py := S256().ScalarMult(x, y, scalar); !bytes.Equal(product, S256().Marshal(px, py)[1:]) {
+			t.Fatalf("product %d differs from ScalarMult", i)
+		}
+	}
+	if _, err := table.ScalarMult(make([]byte, 32)); err != ErrInvalidKey {
+		t.Errorf("zero scalar: have %v, want %v", err, ErrInvalidKey)
+	}
+	if _, err := NewPointTable(make([]byte, 65)); err != ErrInvalidPubkey {
+		t.Errorf("invalid public key: have %v, want %v", err, ErrInvalidPubkey)
+	}
+}
+
+func BenchmarkPointTable(b *testing.B) {
+	pubkey, scalar := generateKeyPair()
+	table, _ := NewPointTable(pubkey)
+	defer table.Close()
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		table.ScalarMult(scalar)
+	}
+}
+
+func TestReblind(t *testing.T) {
+	pubkey, seckey := generateKeyPair()
+	msg := csprngEntropy(32)
+	want, err := Sign(msg, seckey)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer SetReblindInterval(defaultReblindInterval)
+
+	// Signatures are deterministic, so renewing the blinding values underneath
+	// concurrent signers must not change them. Automatic renewals are off and
+	// Reblind runs on one goroutine, so no call finds another renewal running.
+	const reblinds = 50
+	SetReblindInterval(0)
+	_, before := ReblindStats()
+	var (
+		wg   sync.WaitGroup
+		errc = make(chan error, 5)
+	)
+	wg.Add(1)
+	go func() {
+		defer wg.Done()
+		for i := 0; i < reblinds; i++ {
+			if err := Reblind(); err != nil {
+				errc <- err
+				return
+			}
+		}
+	}()
+	for i := 0; i < 4; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for j := 0; j < 100; j++ {
+				sig, err := Sign(msg, seckey)
+				if err != nil {
+					errc <- err
+					return
+				}
+				if !bytes.Equal(sig, want) {
+					errc <- fmt.Errorf("signature changed: %x != %x", sig, want)
+					return
+				}
+			}
+		}()
+	}
+	wg.Wait()
+	select {
+	case err := <-errc:
+		t.Fatal(err)
+	default:
+	}
+	if _, after := ReblindStats(); after-before != reblinds {
+		t.Errorf("explicit renewals: have %d, want %d", after-before, reblinds)
+	}
+
+	// With a single signer nothing contends, so Sign renews after exactly every
+	// interval-th signature.
+	const interval, signs = 3, 20
+	SetReblindInterval(interval)
+	signsBefore, before := ReblindStats()
+	for i := 0; i < signs; i++ {
+		if sig, err := Sign(msg, seckey); err != nil || !bytes.Equal(sig, want) {
+			t.Fatalf("signature %d changed: %x != %x (%v)", i, sig, want, err)
+		}
+	}
+	signsAfter, after := ReblindStats()
+	if signsAfter-signsBefore != signs {
+		t.Errorf("signatures: have %d, want %d", signsAfter-signsBefore, signs)
+	}
+	if n := signsAfter/interval - signsBefore/interval; after-before != n {
+		t.Errorf("interval renewals: have %d, want %d", after-before, n)
+	}
+	recovered, err := RecoverPubkey(msg, want)
+	if err != nil || !bytes.Equal(recovered, pubkey) {
+		t.Fatalf("signature does not recover to signer: %v", err)
+	}
+}
+
 func BenchmarkSign(b *testing.B) {
 	_, seckey := generateKeyPair()
 	msg := csprngEntropy(32)
@@ -226,6 +690,17 @@ func BenchmarkSign(b *testing.B) {
 	}
 }
 
+func BenchmarkRecoverCheck(b *testing.B) {
+	msg := csprngEntropy(32)
+	pubkey, seckey := generateKeyPair()
+	sig, _ := Sign(msg, seckey)
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		RecoverCheck(msg, sig, pubkey)
+	}
+}
+
 func BenchmarkRecover(b *testing.B) {
 	msg := csprngEntropy(32)
 	_, seckey := generateKeyPair()